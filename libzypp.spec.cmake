@@ -21,6 +21,9 @@
 %bcond_with zchunk
 %endif
 
+%bcond_without zstd
+%bcond_without xz
+
 %bcond_without mediabackend_tests
 
 Name:           libzypp
@@ -151,6 +154,14 @@ BuildRequires:  libxslt-tools
 BuildRequires:  libzck-devel
 %endif
 
+%if %{with zstd}
+BuildRequires:  libzstd-devel
+%endif
+
+%if %{with xz}
+BuildRequires:  xz-devel
+%endif
+
 %description
 libzypp is the package management library that powers applications
 like YaST, zypper and the openSUSE/SLE implementation of PackageKit.
@@ -243,6 +254,8 @@ cmake -DCMAKE_INSTALL_PREFIX=%{_prefix} \
       -DCMAKE_BUILD_TYPE=Release \
       -DCMAKE_SKIP_RPATH=1 \
       %{?with_zchunk:-DENABLE_ZCHUNK_COMPRESSION=1} \
+      %{?with_zstd:-DENABLE_ZSTD_COMPRESSION=1} \
+      %{?with_xz:-DENABLE_XZ_COMPRESSION=1} \
       %{!?with_mediabackend_tests:-DDISABLE_MEDIABACKEND_TESTS=1} \
       ${EXTRA_CMAKE_OPTIONS} \
       ..
@@ -0,0 +1,110 @@
+/*
+ * Compares the throughput of the EventDispatcher backends by running
+ * a batch of concurrent downloads against the test WebServer.
+ *
+ * USAGE: EventDispatcher_bench [REQUESTS] [ROUNDS]
+ *
+ * Prints one line per backend and round:
+ *   backend=<name> requests=<n> failed=<n> ms=<elapsed> req/s=<throughput>
+ */
+#include <zypp/zyppng/base/EventDispatcher>
+#include <zypp/zyppng/media/network/request.h>
+#include <zypp/zyppng/media/network/networkrequestdispatcher.h>
+#include <zypp/zyppng/media/network/networkrequesterror.h>
+#include <zypp/TmpPath.h>
+#include <zypp/base/String.h>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "WebServer.h"
+
+namespace {
+
+  struct Result
+  {
+    size_t failed = 0;
+    std::chrono::milliseconds elapsed { 0 };
+  };
+
+  Result runBatch( zyppng::EventDispatcher::Backend backend_r, WebServer &web_r, size_t requests_r )
+  {
+    auto ev = zyppng::EventDispatcher::createMain( backend_r );
+
+    zypp::filesystem::TmpDir targetDir;
+    zyppng::Url weburl( web_r.url() );
+    weburl.setPathName( "/handler/getData" );
+
+    zyppng::NetworkRequestDispatcher disp;
+    disp.setMaximumConcurrentConnections( requests_r );
+    disp.sigQueueFinished().connect( [&ev]( const zyppng::NetworkRequestDispatcher& ){
+      ev->quit();
+    });
+
+    std::vector<zyppng::NetworkRequest::Ptr> reqs;
+    reqs.reserve( requests_r );
+    for ( size_t i = 0; i < requests_r; ++i )
+    {
+      auto req = std::make_shared<zyppng::NetworkRequest>( weburl, targetDir.path() / zypp::str::numstring( i ) );
+      req->transferSettings() = web_r.transferSettings();
+      reqs.push_back( req );
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for ( const auto &req : reqs )
+      disp.enqueue( req );
+    disp.run();
+    ev->run();
+
+    Result res;
+    res.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start );
+    for ( const auto &req : reqs )
+    {
+      if ( req->hasError() )
+        ++res.failed;
+    }
+    return res;
+  }
+
+} // namespace
+
+int main( int argc, char * argv[] )
+{
+  size_t requests = 500;
+  unsigned rounds = 3;
+  if ( argc > 1 )
+    requests = zypp::str::strtonum<size_t>( argv[1] );
+  if ( argc > 2 )
+    rounds = zypp::str::strtonum<unsigned>( argv[2] );
+
+  WebServer web( ( zypp::Pathname(TESTS_SRC_DIR)/"data"/"dummywebroot" ).c_str(), 10001, false );
+  web.addRequestHandler( "getData", WebServer::makeResponse( "200 OK", std::string( 16 * 1024, 'z' ) ) );
+  if ( ! web.start() )
+  {
+    std::cerr << "Unable to start the WebServer" << std::endl;
+    return 1;
+  }
+
+  const std::pair<zyppng::EventDispatcher::Backend, const char *> backends[] = {
+    { zyppng::EventDispatcher::GLibBackend, "glib" },
+    { zyppng::EventDispatcher::EpollBackend, "epoll" }
+  };
+
+  for ( unsigned round = 0; round < rounds; ++round )
+  {
+    for ( const auto &backend : backends )
+    {
+      Result res = runBatch( backend.first, web, requests );
+      double secs = res.elapsed.count() / 1000.0;
+      std::cout << "backend=" << backend.second
+                << " requests=" << requests
+                << " failed=" << res.failed
+                << " ms=" << res.elapsed.count()
+                << " req/s=" << ( secs > 0 ? requests / secs : 0 ) << std::endl;
+    }
+  }
+
+  web.stop();
+  return 0;
+}
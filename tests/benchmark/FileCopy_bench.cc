@@ -0,0 +1,113 @@
+/*
+ * Compares the in-process file copy of zypp::filesystem with spawning
+ * /bin/cp, which is what copy and copy_dir used to do. The source is a
+ * directory of FILES files of SIZE KiB each, like a directory of rpms.
+ *
+ * USAGE: FileCopy_bench [FILES] [SIZE] [ROUNDS] [DIR]
+ *
+ * DIR is where the test files are created (default /var/tmp). Prints one
+ * line per method and round:
+ *   method=<name> files=<n> ms=<elapsed> files/s=<throughput> MB/s=<throughput>
+ */
+#include <zypp/PathInfo.h>
+#include <zypp/TmpPath.h>
+#include <zypp/ExternalProgram.h>
+#include <zypp/base/String.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace zypp;
+
+namespace {
+
+  int spawnCp( const std::vector<std::string> & args_r )
+  {
+    ExternalProgram::Arguments argv { "/bin/cp" };
+    argv.insert( argv.end(), args_r.begin(), args_r.end() );
+    ExternalProgram prog( argv, ExternalProgram::Discard_Stderr );
+    return prog.close();
+  }
+
+  template <class TFunc>
+  void runTest( const char * name_r, const Pathname & base_r, size_t files_r, size_t size_r, TFunc && func_r )
+  {
+    filesystem::TmpDir target( base_r );
+
+    auto start = std::chrono::steady_clock::now();
+    int ret = func_r( target.path() );
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start );
+
+    double secs = elapsed.count() / 1000.0;
+    std::cout << "method=" << name_r
+              << " files=" << files_r
+              << " ms=" << elapsed.count()
+              << " files/s=" << ( secs > 0 ? files_r / secs : 0 )
+              << " MB/s=" << ( secs > 0 ? files_r * size_r / 1024.0 / secs : 0 );
+    if ( ret != 0 )
+      std::cout << " FAILED=" << ret;
+    std::cout << std::endl;
+  }
+
+} // namespace
+
+int main( int argc, char * argv[] )
+{
+  size_t files = 5000;
+  size_t size = 256;	// KiB
+  unsigned rounds = 3;
+  Pathname base( "/var/tmp" );
+  if ( argc > 1 )
+    files = str::strtonum<size_t>( argv[1] );
+  if ( argc > 2 )
+    size = str::strtonum<size_t>( argv[2] );
+  if ( argc > 3 )
+    rounds = str::strtonum<unsigned>( argv[3] );
+  if ( argc > 4 )
+    base = argv[4];
+
+  filesystem::TmpDir srcroot( base );
+  Pathname src( srcroot.path() / "rpms" );
+  filesystem::assert_dir( src );
+  std::vector<std::string> names;
+  {
+    std::string data( size * 1024, '\0' );
+    for ( size_t i = 0; i < data.size(); ++i )
+      data[i] = char( i * 7 + i / 251 );
+    for ( size_t i = 0; i < files; ++i )
+    {
+      names.push_back( str::form( "package-%zu-1.0-1.x86_64.rpm", i ) );
+      std::ofstream( ( src / names.back() ).c_str() ) << data;
+    }
+  }
+
+  for ( unsigned round = 0; round < rounds; ++round )
+  {
+    runTest( "copy", base, files, size, [&]( const Pathname & target_r ) {
+      for ( const std::string & name : names )
+        if ( int ret = filesystem::copy( src / name, target_r / name ) )
+          return ret;
+      return 0;
+    });
+
+    runTest( "cp", base, files, size, [&]( const Pathname & target_r ) {
+      for ( const std::string & name : names )
+        if ( int ret = spawnCp( { "--remove-destination", "--", ( src / name ).asString(), ( target_r / name ).asString() } ) )
+          return ret;
+      return 0;
+    });
+
+    runTest( "copy_dir", base, files, size, [&]( const Pathname & target_r ) {
+      return filesystem::copy_dir( src, target_r );
+    });
+
+    runTest( "cp-dR", base, files, size, [&]( const Pathname & target_r ) {
+      return spawnCp( { "-dR", "--", src.asString(), target_r.asString() } );
+    });
+  }
+
+  return 0;
+}
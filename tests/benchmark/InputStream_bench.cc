@@ -0,0 +1,114 @@
+/*
+ * Compares how fast InputStream reads repository metadata stored
+ * gzip, zstd or xz compressed. The uncompressed input (primary.xml
+ * from the testdata by default) is recompressed in each format
+ * supported by this build and then read in chunks.
+ *
+ * USAGE: InputStream_bench [ROUNDS] [FILE]
+ *
+ * Prints one line per format and round:
+ *   format=<name> bytes=<compressed> ms=<elapsed> MB/s=<uncompressed throughput>
+ */
+#include <zypp/base/InputStream.h>
+#include <zypp/base/GzStream.h>
+#include <zypp/base/String.h>
+#include <zypp/PathInfo.h>
+#include <zypp/TmpPath.h>
+
+#ifdef ENABLE_ZSTD_COMPRESSION
+  #include <zypp/base/ZStdStream.h>
+#endif
+#ifdef ENABLE_XZ_COMPRESSION
+  #include <zypp/base/XzStream.h>
+#endif
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+  struct Format
+  {
+    const char * _name;
+    zypp::Pathname _file;
+  };
+
+  template <class TStream>
+  void writeFile( const zypp::Pathname & file_r, const std::string & data_r )
+  {
+    TStream out( file_r.c_str() );
+    out << data_r;
+  }
+
+  size_t readFile( const zypp::Pathname & file_r )
+  {
+    zypp::InputStream in( file_r );
+    char buf[16 * 1024];
+    size_t bytes = 0;
+    while ( in.stream().read( buf, sizeof(buf) ) || in.stream().gcount() )
+      bytes += in.stream().gcount();
+    return bytes;
+  }
+
+} // namespace
+
+int main( int argc, char * argv[] )
+{
+  unsigned rounds = 3;
+  zypp::Pathname input( zypp::Pathname(TESTS_SRC_DIR)/"data/11.0-update/repodata/primary.xml.gz" );
+  if ( argc > 1 )
+    rounds = zypp::str::strtonum<unsigned>( argv[1] );
+  if ( argc > 2 )
+    input = argv[2];
+
+  std::string data;
+  {
+    zypp::InputStream in( input );
+    data.assign( std::istreambuf_iterator<char>( in.stream() ), std::istreambuf_iterator<char>() );
+  }
+  if ( data.empty() )
+  {
+    std::cerr << "Unable to read " << input << std::endl;
+    return 1;
+  }
+
+  zypp::filesystem::TmpDir tmp;
+  std::vector<Format> formats;
+
+  formats.push_back( { "gz", tmp.path()/"primary.xml.gz" } );
+  writeFile<zypp::ofgzstream>( formats.back()._file, data );
+#ifdef ENABLE_ZSTD_COMPRESSION
+  formats.push_back( { "zstd", tmp.path()/"primary.xml.zst" } );
+  writeFile<zypp::ofzstdstream>( formats.back()._file, data );
+#endif
+#ifdef ENABLE_XZ_COMPRESSION
+  formats.push_back( { "xz", tmp.path()/"primary.xml.xz" } );
+  writeFile<zypp::ofxzstream>( formats.back()._file, data );
+#endif
+
+  int ret = 0;
+  for ( unsigned round = 0; round < rounds; ++round )
+  {
+    for ( const Format & format : formats )
+    {
+      auto start = std::chrono::steady_clock::now();
+      size_t bytes = readFile( format._file );
+      auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start );
+
+      if ( bytes != data.size() )
+      {
+        std::cerr << format._name << ": read " << bytes << " bytes, expected " << data.size() << std::endl;
+        ret = 1;
+      }
+
+      double secs = elapsed.count() / 1000.0;
+      std::cout << "format=" << format._name
+                << " bytes=" << zypp::PathInfo( format._file ).size()
+                << " ms=" << elapsed.count()
+                << " MB/s=" << ( secs > 0 ? bytes / secs / ( 1024 * 1024 ) : 0 ) << std::endl;
+    }
+  }
+  return ret;
+}
@@ -0,0 +1,117 @@
+#ifndef INCLUDE_SOLVWRITER
+#define INCLUDE_SOLVWRITER
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "TestSetup.h"
+
+extern "C"
+{
+#include <solv/pool.h>
+#include <solv/repo.h>
+#include <solv/repo_write.h>
+}
+
+/** Write a solv file for tests needing data a helix testcase can't describe
+ * (e.g. pattern includes, package locations and checksums, deltarpms).
+ *
+ * Solvables are \c noarch and provide themselves. They are created in a
+ * private pool, so the returned ids are unrelated to the zypp pool. Data
+ * not covered here can be added via \ref pool, \ref repo and \ref data.
+ *
+ * \code
+ *   SolvWriter solv;
+ *   Id p = solv.addSolvable( "pattern:A" );
+ *   solv.addRequires( p, "pa" );
+ *   solv.addPoolstr( p, SOLVABLE_INCLUDES, "pattern:B" );
+ *   solv.write( tmp.path() / "patterns.solv" );
+ *   test.loadRepo( tmp.path() / "patterns.solv", "patterns" );
+ * \endcode
+ */
+class SolvWriter
+{
+public:
+  SolvWriter()
+    : _pool( ::pool_create() )
+    , _repo( ::repo_create( _pool, "test" ) )
+    , _data( ::repo_add_repodata( _repo, 0 ) )
+  {}
+
+  SolvWriter( const SolvWriter & ) = delete;
+  SolvWriter & operator=( const SolvWriter & ) = delete;
+
+  ~SolvWriter()
+  { ::pool_free( _pool ); }
+
+public:
+  /** Add a \c noarch solvable providing itself. */
+  Id addSolvable( const std::string & name_r, const std::string & evr_r = "1-1" )
+  {
+    Id p = ::repo_add_solvable( _repo );
+    ::Solvable * s = ::pool_id2solvable( _pool, p );
+    s->name = ::pool_str2id( _pool, name_r.c_str(), 1 );
+    s->evr = ::pool_str2id( _pool, evr_r.c_str(), 1 );
+    s->arch = ARCH_NOARCH;
+    s->provides = ::repo_addid_dep( _repo, s->provides, ::pool_rel2id( _pool, s->name, s->evr, REL_EQ, 1 ), 0 );
+    return p;
+  }
+
+  /** A \c "name" or \c "name OP evr" dependency (\c OP one of \c < \c <= \c = \c >= \c >). */
+  Id dep( const std::string & dep_r )
+  {
+    std::vector<std::string> words;
+    str::split( dep_r, std::back_inserter( words ) );
+    Id name = ::pool_str2id( _pool, words[0].c_str(), 1 );
+    if ( words.size() < 3 )
+      return name;
+    int flags = 0;
+    for ( char ch : words[1] )
+      flags |= ( ch == '<' ? REL_LT : ch == '>' ? REL_GT : ch == '=' ? REL_EQ : 0 );
+    return ::pool_rel2id( _pool, name, ::pool_str2id( _pool, words[2].c_str(), 1 ), flags, 1 );
+  }
+
+  void addRequires( Id p_r, const std::string & dep_r )
+  { solvable( p_r )->requires = ::repo_addid_dep( _repo, solvable( p_r )->requires, dep( dep_r ), 0 ); }
+
+  void addConflicts( Id p_r, const std::string & dep_r )
+  { solvable( p_r )->conflicts = ::repo_addid_dep( _repo, solvable( p_r )->conflicts, dep( dep_r ), 0 ); }
+
+  /** Add \a str_r to a string array attribute like \c SOLVABLE_INCLUDES. */
+  void addPoolstr( Id p_r, Id keyname_r, const std::string & str_r )
+  { ::repodata_add_poolstr_array( _data, p_r, keyname_r, str_r.c_str() ); }
+
+  /** Locate the package at \a file_r below \a dir_r and set the files sha256 and size. */
+  void setLocation( Id p_r, const Pathname & dir_r, const std::string & file_r )
+  {
+    ::repodata_set_location( _data, p_r, 0, 0, file_r.c_str() );
+    ::repodata_set_checksum( _data, p_r, SOLVABLE_CHECKSUM, REPOKEY_TYPE_SHA256,
+			     filesystem::checksum( dir_r / file_r, "sha256" ).c_str() );
+    ::repodata_set_num( _data, p_r, SOLVABLE_DOWNLOADSIZE, filesystem::PathInfo( dir_r / file_r ).size() );
+  }
+
+  /** Write the solv file. */
+  void write( const Pathname & file_r )
+  {
+    ::repo_internalize( _repo );
+    FILE * fp = ::fopen( file_r.c_str(), "w" );
+    BOOST_REQUIRE( fp );
+    BOOST_REQUIRE_EQUAL( ::repo_write( _repo, fp ), 0 );
+    ::fclose( fp );
+  }
+
+public:
+  ::Pool * pool()     { return _pool; }
+  ::Repo * repo()     { return _repo; }
+  ::Repodata * data() { return _data; }
+
+  ::Solvable * solvable( Id p_r )
+  { return ::pool_id2solvable( _pool, p_r ); }
+
+private:
+  ::Pool * _pool;
+  ::Repo * _repo;
+  ::Repodata * _data;
+};
+
+#endif // INCLUDE_SOLVWRITER
@@ -0,0 +1,91 @@
+#include <utime.h>
+#include <iostream>
+#include <set>
+#include <fstream>
+
+#include <boost/test/unit_test.hpp>
+
+#include <zypp/base/LogTools.h>
+#include <zypp/TmpPath.h>
+#include <zypp/PathInfo.h>
+#include <zypp/RepoStatus.h>
+#include <zypp/ExternalProgram.h>
+#include <zypp/sat/Pool.h>
+#include <zypp/repo/PlaindirSolv_p.h>
+
+using namespace boost::unit_test;
+using namespace zypp;
+using namespace zypp::filesystem;
+
+const Pathname DATADIR( TESTS_SRC_DIR "/zypp/data/RpmPkgSigCheck" );
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  /** The solvables in \a solvfile_r as "NVRA@location provides requires" strings. */
+  std::multiset<std::string> solvContent( const Pathname & solvfile_r )
+  {
+    std::multiset<std::string> ret;
+    sat::Pool satpool( sat::Pool::instance() );
+    Repository repo( satpool.addRepoSolv( solvfile_r, "plaindir" ) );
+    for ( const sat::Solvable & solv : repo.solvables() )
+    {
+      ret.insert( str::Str() << solv.ident() << '-' << solv.edition() << '.' << solv.arch()
+			     << '@' << solv.lookupLocation().filename()
+			     << ' ' << solv.provides().size() << ' ' << solv.requires().size() );
+    }
+    satpool.reposErase( "plaindir" );
+    return ret;
+  }
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE(plaindir_incremental)
+{
+  TmpDir dir;
+  TmpDir solvdir;
+  assert_dir( dir.path() / "sub" );
+  BOOST_REQUIRE_EQUAL( copy( DATADIR / "signed.rpm", dir.path() / "a.rpm" ), 0 );
+  BOOST_REQUIRE_EQUAL( copy( DATADIR / "unsigned.rpm", dir.path() / "sub/b.rpm" ), 0 );
+  BOOST_REQUIRE_EQUAL( copy( DATADIR / "unsigned.rpm", dir.path() / "x.rpm" ), 0 );
+
+  // initial build reads all rpms
+  RepoStatus status0( RepoStatus::fromDirectory( dir.path() ) );
+  BOOST_REQUIRE( repo::buildPlaindirSolv( dir.path(), Pathname(), RepoStatus(), status0, solvdir.path() / "solv0" ) );
+  BOOST_CHECK_EQUAL( solvContent( solvdir.path() / "solv0" ).size(), 3 );
+
+  // add, remove and touch rpms
+  BOOST_REQUIRE_EQUAL( copy( DATADIR / "signed.rpm", dir.path() / "sub/c.rpm" ), 0 );
+  BOOST_REQUIRE_EQUAL( unlink( dir.path() / "x.rpm" ), 0 );
+  struct utimbuf times { 1000000000, 1000000000 };
+  BOOST_REQUIRE_EQUAL( ::utime( ( dir.path() / "a.rpm" ).c_str(), &times ), 0 );
+  std::ofstream( ( dir.path() / "README" ).c_str() ) << "not an rpm";
+  // skipped like repo2solv does
+  assert_dir( dir.path() / ".snapshots" );
+  BOOST_REQUIRE_EQUAL( copy( DATADIR / "unsigned.rpm", dir.path() / ".snapshots/s.rpm" ), 0 );
+  BOOST_REQUIRE_EQUAL( copy( DATADIR / "unsigned.rpm", dir.path() / "sub/.h.rpm" ), 0 );
+  BOOST_REQUIRE_EQUAL( copy( DATADIR / "unsigned.rpm", dir.path() / "p.patch.rpm" ), 0 );
+
+  RepoStatus status1( RepoStatus::fromDirectory( dir.path(), status0 ) );
+  RepoStatus::FileChanges changes( RepoStatus::fileChanges( status0, status1 ) );
+  BOOST_CHECK( changes._added == std::vector<std::string>({ "README", "p.patch.rpm", "sub/c.rpm" }) );
+  BOOST_CHECK( changes._removed == std::vector<std::string>{ "x.rpm" } );
+  BOOST_CHECK( changes._changed == std::vector<std::string>{ "a.rpm" } );
+
+  // the incremental build equals a full one
+  BOOST_REQUIRE( repo::buildPlaindirSolv( dir.path(), solvdir.path() / "solv0", status0, status1, solvdir.path() / "solv1" ) );
+  BOOST_REQUIRE( repo::buildPlaindirSolv( dir.path(), Pathname(), RepoStatus(), status1, solvdir.path() / "full" ) );
+  std::multiset<std::string> incremental( solvContent( solvdir.path() / "solv1" ) );
+  BOOST_CHECK_EQUAL( incremental.size(), 3 );
+  BOOST_CHECK( incremental == solvContent( solvdir.path() / "full" ) );
+
+  // ...and one built by repo2solv
+  ExternalProgram::Arguments cmd { "repo2solv", "-o", ( solvdir.path() / "repo2solv" ).asString(), "-X", "-R", dir.path().asString() };
+  ExternalProgram prog( cmd, ExternalProgram::Stderr_To_Stdout );
+  while ( prog.receiveLine().length() )
+    ;	// ignore the output
+  if ( prog.close() == 0 )
+    BOOST_CHECK( incremental == solvContent( solvdir.path() / "repo2solv" ) );
+  else
+    BOOST_TEST_MESSAGE( "repo2solv is not available: " << prog.execError() );
+}
@@ -68,7 +68,10 @@ BOOST_AUTO_TEST_CASE(LookupAttr_existingattr_matcher)
 
   BOOST_CHECK_EQUAL( q.size(), 9 );
   for_(it,q.begin(),q.end())
-  { cout << it << endl;}
+  {
+    cout << it << endl;
+    BOOST_CHECK_EQUAL( it.asStringView(), it.asString() );
+  }
 }
 
 BOOST_AUTO_TEST_CASE(LookupAttr_iterate_solvables)
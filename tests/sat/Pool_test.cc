@@ -1,6 +1,7 @@
 #include "TestSetup.h"
 #include <zypp/Repository.h>
 #include <zypp/sat/Pool.h>
+#include <zypp/pool/PoolMemoryStats.h>
 
 static TestSetup test( TestSetup::initLater );
 struct TestInit {
@@ -91,6 +92,35 @@ BOOST_AUTO_TEST_CASE(repolist)
   //test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1" );
 }
 
+BOOST_AUTO_TEST_CASE(memorystats)
+{
+  // repos as left by 'repolist'
+  sat::Pool satpool( test.satpool() );
+  pool::PoolMemoryStats stats;
+  cout << stats << endl;
+  BOOST_CHECK_EQUAL( stats._repos.size(), satpool.reposSize() );
+  BOOST_CHECK_EQUAL( stats._solvables, satpool.capacity() );
+  BOOST_CHECK( stats._strings > 0 );
+  BOOST_CHECK( stats._stringSpace > 0 );
+
+  ByteCount total { stats.total() };
+  for ( const auto & repo : stats._repos )
+  {
+    BOOST_CHECK( repo.total() > 0 || repo._solvables == 0 );
+    BOOST_CHECK( repo.total() < total );
+  }
+
+  satpool.prepare();
+  BOOST_CHECK( pool::PoolMemoryStats()._whatprovides > 0 );
+
+  // the ResPool store only on request
+  BOOST_CHECK_EQUAL( stats._poolItems, 0U );
+  pool::PoolMemoryStats withpool( true );
+  BOOST_CHECK_EQUAL( withpool._poolItems, satpool.solvablesSize() );
+  BOOST_CHECK( withpool._poolItemStore > 0 );
+  BOOST_CHECK( withpool.total() > pool::PoolMemoryStats().total() );
+}
+
 #if 0
 BOOST_AUTO_TEST_CASE(LookupAttr_)
 {
@@ -72,6 +72,8 @@ BOOST_AUTO_TEST_CASE(attributes)
             BOOST_CHECK_EQUAL(p->vendor(), "SUSE LINUX Products GmbH, Nuernberg, Germany");
             BOOST_CHECK_EQUAL(p->category(), "Base Technologies");
             BOOST_CHECK_EQUAL(p->summary(), "Novell AppArmor");
+            BOOST_CHECK_EQUAL(p->summaryView(), "Novell AppArmor");
+            BOOST_CHECK_EQUAL(p->lookupStrAttributeView( sat::SolvAttr::category ), p->category());
             BOOST_CHECK_EQUAL(p->icon(), "pattern-apparmor");
             BOOST_CHECK_EQUAL(p->userVisible(), true);
             BOOST_CHECK_EQUAL(p->isDefault(), false);
@@ -0,0 +1,128 @@
+#include <string>
+#include <vector>
+
+#include "TestSetup.h"
+#include "SolvWriter.h"
+#include <zypp/target/CommitPackageCache.h>
+
+#define BOOST_TEST_MODULE CommitPackageCache
+
+using zypp::target::RepoProvidePackage;
+using zypp::target::RepoPreloadPackages;
+
+#define DATADIR (Pathname(TESTS_SRC_DIR) + "/zypp/data/RpmPkgSigCheck")
+
+static TestSetup test( TestSetup::initLater );
+static filesystem::TmpDir tmp;	// repo and packages cache
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  Pathname repoDir()	{ return tmp.path() / "repo"; }
+  Pathname cacheDir()	{ return tmp.path() / "packages"; }
+
+  /** Write a solv file with packages located at "<name>.rpm" in \ref repoDir.
+   * The checksum of \a corrupt_r does not match its rpm.
+   */
+  void writeSolv( const Pathname & file_r, const std::vector<std::string> & names_r, const std::string & corrupt_r )
+  {
+    SolvWriter solv;
+    for ( const std::string & name : names_r )
+    {
+      const std::string & rpm { name+".rpm" };
+      BOOST_REQUIRE_EQUAL( filesystem::copy( DATADIR / "unsigned.rpm", repoDir() / rpm ), 0 );
+      Id p = solv.addSolvable( name );
+      solv.setLocation( p, repoDir(), rpm );
+      if ( name == corrupt_r )
+	::repodata_set_checksum( solv.data(), p, SOLVABLE_CHECKSUM, REPOKEY_TYPE_SHA256, std::string( 64, '0' ).c_str() );
+    }
+    solv.write( file_r );
+  }
+
+  PoolItem package( const std::string & name_r )
+  {
+    for ( const sat::Solvable & solv : test.satpool().reposFind( "preload" ).solvables() )
+    {
+      if ( solv.name() == name_r )
+	return PoolItem( solv );
+    }
+    BOOST_FAIL( "no package " << name_r );
+    return PoolItem();
+  }
+
+  bool inCache( const std::string & name_r )
+  { return filesystem::PathInfo( cacheDir() / ( name_r+".rpm" ) ).isFile(); }
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+struct TestInit {
+  TestInit() {
+    test = TestSetup( Arch_x86_64 );
+    filesystem::assert_dir( repoDir() );
+    filesystem::assert_dir( cacheDir() );
+    writeSolv( tmp.path() / "solv", { "a", "b", "c", "d", "e" }, "c" );
+
+    RepoInfo info;
+    info.setAlias( "preload" );
+    info.addBaseUrl( repoDir().asDirUrl() );
+    info.setPackagesPath( cacheDir() );
+    info.setGpgCheck( false );
+    info.setKeepPackages( true );
+    test.satpool().addRepoSolv( tmp.path() / "solv", info );
+  }
+  ~TestInit() { test.reset(); }
+};
+BOOST_GLOBAL_FIXTURE( TestInit );
+
+BOOST_AUTO_TEST_CASE(preload_window)
+{
+  RepoPreloadPackages preloader { RepoProvidePackage() };
+  BOOST_CHECK( preloader.window() >= 1 && preloader.window() <= 4 );
+
+  // fetched packages are in the cache before they are verified...
+  preloader.fetch( package( "a" ) );
+  preloader.fetch( package( "b" ) );
+  BOOST_CHECK_EQUAL( preloader.pending(), 2 );
+  BOOST_CHECK( inCache( "a" ) && inCache( "b" ) );
+
+  // ...and verified in the order they were fetched, while others download
+  BOOST_CHECK_EQUAL( preloader.verifyNext()->basename(), "a.rpm" );
+  BOOST_CHECK_EQUAL( preloader.pending(), 1 );
+  preloader.fetch( package( "c" ) );
+  BOOST_CHECK_EQUAL( preloader.pending(), 2 );
+  BOOST_CHECK_EQUAL( preloader.verifyNext()->basename(), "b.rpm" );
+
+  // a package failing the checksum check is removed
+  BOOST_CHECK( inCache( "c" ) );
+  BOOST_CHECK_THROW( preloader.verifyNext(), AbortRequestException );
+  BOOST_CHECK_EQUAL( preloader.pending(), 0 );
+  BOOST_CHECK( ! inCache( "c" ) );
+  BOOST_CHECK_THROW( preloader.verifyNext(), Exception );
+  BOOST_CHECK( inCache( "a" ) && inCache( "b" ) );
+}
+
+BOOST_AUTO_TEST_CASE(preload_dispose_unchecked)
+{
+  // "a" is cached already, "d" and "e" are downloaded
+  {
+    RepoPreloadPackages preloader { RepoProvidePackage() };
+    preloader.fetch( package( "a" ) );
+    preloader.fetch( package( "d" ) );
+    preloader.fetch( package( "e" ) );
+    BOOST_CHECK( inCache( "d" ) && inCache( "e" ) );
+    BOOST_CHECK_EQUAL( preloader.verifyNext()->basename(), "a.rpm" );
+    BOOST_CHECK_EQUAL( preloader.pending(), 2 );
+  }
+  // unchecked files don't stay in the cache
+  BOOST_CHECK( inCache( "a" ) );
+  BOOST_CHECK( ! inCache( "d" ) );
+  BOOST_CHECK( ! inCache( "e" ) );
+
+  // a cached package pending verification stays
+  {
+    RepoPreloadPackages preloader { RepoProvidePackage() };
+    preloader.fetch( package( "b" ) );
+    BOOST_CHECK_EQUAL( preloader.pending(), 1 );
+  }
+  BOOST_CHECK( inCache( "b" ) );
+}
@@ -67,4 +67,36 @@ BOOST_AUTO_TEST_CASE(delta)
     cout << (it->edition().match(Edition("4.21.3-2")) == 0) << endl; // match returns -1,0,1
     cout << (it->edition().match("4.21.3-2") == 0) << endl;          // match returns -1,0,1
   }
+  BOOST_CHECK_EQUAL( deltas.size(), 2U );
+
+  // Same deltas if not restricted to a package name; none for packages without deltas
+  repo::DeltaCandidates all(std::list<Repository>(pool.reposBegin(),pool.reposEnd()));
+  BOOST_CHECK_EQUAL( all.deltaRpms(0).size(), deltas.size() );
+  for ( const sat::Solvable & solv : pool.solvables() )
+  {
+    Package::constPtr pkg( asKind<Package>( makeResObject( solv ) ) );
+    if ( pkg )
+      BOOST_CHECK( all.deltaRpms( pkg ).empty() );
+  }
+
+  // Both deltas for the package they rebuild, none for its base version
+  pool.addRepoHelix( Pathname(TEST_DIR) / "packages.xml", "packages" );
+  unsigned found = 0;
+  for ( const sat::Solvable & solv : pool.reposFind( "packages" ).solvables() )
+  {
+    Package::constPtr pkg( asKind<Package>( makeResObject( solv ) ) );
+    BOOST_REQUIRE( pkg );
+    std::list<packagedelta::DeltaRpm> pkgdeltas( all.deltaRpms( pkg ) );
+    if ( pkg->edition() == Edition("4.21.3-2") )
+    {
+      ++found;
+      BOOST_CHECK_EQUAL( pkgdeltas.size(), 2U );
+      for ( const packagedelta::DeltaRpm & delta : pkgdeltas )
+        BOOST_CHECK( delta.edition() == pkg->edition() && delta.arch() == pkg->arch() );
+    }
+    else
+      BOOST_CHECK( pkgdeltas.empty() );
+  }
+  BOOST_CHECK_EQUAL( found, 1U );
+  pool.reposErase( "packages" );
 }
@@ -0,0 +1,73 @@
+#include "TestSetup.h"
+#include <zypp/DiskUsageCounter.h>
+
+#define BOOST_TEST_MODULE DiskUsageCounter
+
+/////////////////////////////////////////////////////////////////////////////
+
+static TestSetup test( TestSetup::initLater );
+struct TestInit {
+  TestInit() {
+    test = TestSetup( );
+    test.loadRepo( TESTS_SRC_DIR"/data/openSUSE-11.1", "opensuse" );
+    test.loadTestcaseRepos( TESTS_SRC_DIR"/data/TCNamespaceRecommends" );
+  }
+  ~TestInit() { test.reset(); }
+};
+BOOST_GLOBAL_FIXTURE( TestInit );
+
+/////////////////////////////////////////////////////////////////////////////
+
+static const DiskUsageCounter::MountPointSet mps {
+  DiskUsageCounter::MountPoint( "/",    4096, 1000000LL, 500000LL ),
+  DiskUsageCounter::MountPoint( "/usr", 4096, 1000000LL, 500000LL ),
+  DiskUsageCounter::MountPoint( "/var", 4096, 1000000LL, 500000LL, 0LL, DiskUsageCounter::MountPoint::Hint_growonly ),
+};
+
+// The remembering counter must compute the same as a fresh one
+void checkSameAsFresh( const DiskUsageCounter & counter_r )
+{
+  DiskUsageCounter::MountPointSet incremental { counter_r.disk_usage( test.pool() ) };
+  DiskUsageCounter::MountPointSet full { DiskUsageCounter( mps ).disk_usage( test.pool() ) };
+
+  BOOST_REQUIRE_EQUAL( incremental.size(), full.size() );
+  for ( auto l = incremental.begin(), r = full.begin(); l != incremental.end(); ++l, ++r )
+  {
+    BOOST_CHECK_EQUAL( l->dir, r->dir );
+    BOOST_CHECK_EQUAL( l->pkg_size, r->pkg_size );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(incremental)
+{
+  DiskUsageCounter counter( mps );
+  checkSameAsFresh( counter );
+
+  std::vector<PoolItem> toggled;
+  for ( const PoolItem & pi : test.pool() )
+  {
+    if ( pi.isKind<Package>() && toggled.size() < 20 )
+    {
+      if ( pi.status().isInstalled() )
+        pi.status().setToBeUninstalled( ResStatus::USER );
+      else
+        pi.status().setToBeInstalled( ResStatus::USER );
+      toggled.push_back( pi );
+      if ( toggled.size() % 5 == 0 )
+        checkSameAsFresh( counter );
+    }
+  }
+  checkSameAsFresh( counter );
+
+  for ( const PoolItem & pi : toggled )
+  {
+    pi.statusReset();
+    checkSameAsFresh( counter );
+  }
+
+  // changed mount points are detected
+  DiskUsageCounter::MountPointSet other { mps };
+  other.insert( DiskUsageCounter::MountPoint( "/opt", 4096, 1000000LL, 500000LL ) );
+  counter.setMountPoints( other );
+  BOOST_CHECK_EQUAL( counter.disk_usage( test.pool() ).size(), 4 );
+}
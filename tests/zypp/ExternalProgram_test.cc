@@ -0,0 +1,88 @@
+#include <zypp/ExternalProgram.h>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <poll.h>
+
+#include <boost/test/unit_test.hpp>
+
+using zypp::ExternalProgram;
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  double secondsSince( Clock::time_point start_r )
+  { return std::chrono::duration<double>( Clock::now() - start_r ).count(); }
+}
+
+BOOST_AUTO_TEST_CASE( ExternalProgram_waitForExit )
+{
+  ExternalProgram proc( "sleep 1", ExternalProgram::Normal_Stderr );
+  BOOST_CHECK( ! proc.waitForExit( 0 ) );
+  BOOST_CHECK( proc.waitForExit() );
+  BOOST_CHECK( ! proc.running() );
+  BOOST_CHECK_EQUAL( proc.pidfd(), -1 );
+  BOOST_CHECK_EQUAL( proc.close(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( ExternalProgram_pidfd_overlap )
+{
+  // Serial baseline: waiting for each program one after the other.
+  const std::vector<const char *> cmds { "sleep 1.5", "sleep 0.5", "sleep 1" };
+  double serial = 0.0;
+  for ( const char * cmd : cmds )
+  {
+    Clock::time_point start { Clock::now() };
+    ExternalProgram proc( cmd, ExternalProgram::Normal_Stderr );
+    BOOST_CHECK_EQUAL( proc.close(), 0 );
+    serial += secondsSince( start );
+  }
+
+  // Now wait for all of them at once and reap them in the order they exit.
+  Clock::time_point start { Clock::now() };
+  std::vector<std::unique_ptr<ExternalProgram>> procs;
+  std::vector<struct pollfd> pfds;
+  for ( const char * cmd : cmds )
+  {
+    procs.emplace_back( new ExternalProgram( cmd, ExternalProgram::Normal_Stderr ) );
+    int fd = procs.back()->pidfd();
+    BOOST_REQUIRE_GE( fd, 0 );	// Linux >= 5.3
+    pfds.push_back( { fd, POLLIN, 0 } );
+  }
+
+  std::vector<unsigned> exitOrder;
+  while ( exitOrder.size() < procs.size() )
+  {
+    BOOST_REQUIRE_GT( ::poll( pfds.data(), pfds.size(), 5000 ), 0 );
+    for ( unsigned i = 0; i < pfds.size(); ++i )
+    {
+      if ( pfds[i].revents )
+      {
+        BOOST_CHECK( procs[i]->waitForExit( 0 ) );
+        BOOST_CHECK_EQUAL( procs[i]->close(), 0 );
+        exitOrder.push_back( i );
+        pfds[i].fd = -1;	// poll ignores it from now on
+      }
+    }
+  }
+  double overlapped = secondsSince( start );
+
+  BOOST_CHECK( exitOrder == std::vector<unsigned>({ 1, 2, 0 }) );
+  // The longest program dominates, not the sum of all of them.
+  BOOST_CHECK_LT( overlapped, serial * 2 / 3 );
+}
+
+BOOST_AUTO_TEST_CASE( ExternalProgram_close_output_held_open )
+{
+  // The background sleep keeps the output pipe open after the program itself exited.
+  // close() must notice the exit right away. Polling waitpid would notice it only at
+  // the next 1s select timeout (at 5.5s).
+  Clock::time_point start { Clock::now() };
+  ExternalProgram proc( "sleep 6 2>/dev/null & sleep 4.6", ExternalProgram::Normal_Stderr );
+  BOOST_CHECK_EQUAL( proc.close(), 0 );
+  double elapsed = secondsSince( start );
+  BOOST_CHECK_GE( elapsed, 4.5 );
+  BOOST_CHECK_LT( elapsed, 5.1 );
+}
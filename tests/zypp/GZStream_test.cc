@@ -4,6 +4,7 @@
 #include <zypp/base/GzStream.h>
 #include <zypp/Pathname.h>
 #include <zypp/base/InputStream.h>
+#include <zypp/base/String.h>
 
 BOOST_AUTO_TEST_CASE(gz_simple_read_write)
 {
@@ -78,3 +79,40 @@ BOOST_AUTO_TEST_CASE(gz_seek)
     BOOST_REQUIRE_EQUAL( test, "Hello" );
   }
 }
+
+BOOST_AUTO_TEST_CASE(gz_large_seek)
+{
+  const zypp::Pathname file = zypp::Pathname(TESTS_BUILD_DIR) / "testlarge.gz";
+  // several compression blocks and restart points
+  std::string testString;
+  for ( unsigned i = 0; testString.size() < 4 * 1024 * 1024; ++i )
+    testString += zypp::str::numstring( i * 7919 % 100003 ) + " line\n";
+
+  {
+    zypp::ofgzstream strOut( file.c_str() );
+    BOOST_REQUIRE( strOut.is_open() );
+    strOut << testString;
+  }
+
+  {
+    zypp::ifgzstream str( file.c_str() );
+    std::string test { std::istreambuf_iterator<char>( str ), std::istreambuf_iterator<char>() };
+    BOOST_REQUIRE_EQUAL( test.size(), testString.size() );
+    BOOST_REQUIRE( test == testString );
+  }
+
+  {
+    zypp::ifgzstream str( file.c_str() );
+    // backward seeks build the index, later ones use it
+    for ( std::streamoff off : { 3000000, 100, 2500000, 1048576, 4000000, 0, 3999990 } )
+    {
+      char buf[8];
+      str.seekg( off, std::ios_base::beg );
+      BOOST_REQUIRE ( !str.fail() );
+      BOOST_REQUIRE_EQUAL( str.tellg(), off );
+      str.read( buf, sizeof(buf) );
+      BOOST_REQUIRE ( !str.fail() );
+      BOOST_REQUIRE_EQUAL( std::string( buf, sizeof(buf) ), testString.substr( off, sizeof(buf) ) );
+    }
+  }
+}
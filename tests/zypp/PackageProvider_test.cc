@@ -0,0 +1,174 @@
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#include "TestSetup.h"
+#include "SolvWriter.h"
+#include <zypp/ZConfig.h>
+#include <zypp/base/UserRequestException.h>
+#include <zypp/repo/PackageProvider.h>
+
+#define BOOST_TEST_MODULE PackageProvider
+
+#define DATADIR (Pathname(TESTS_SRC_DIR) + "/zypp/data/RpmPkgSigCheck")
+
+static TestSetup test( TestSetup::initLater );
+static filesystem::TmpDir tmp;	// repos, packages caches and the fake applydeltarpm
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  Pathname repoDir( const std::string & alias_r )	{ return tmp.path() / "repo" / alias_r; }
+  Pathname cacheDir( const std::string & alias_r )	{ return tmp.path() / "packages" / alias_r; }
+
+  /** Fake applydeltarpm: checks succeed, a rebuild copies the (non empty) deltarpm. */
+  void writeApplydeltarpm( const Pathname & file_r )
+  {
+    std::ofstream( file_r.c_str() )
+    << "#!/bin/sh" << std::endl
+    << "case \"$1\" in -c|-C) exit 0;; esac" << std::endl
+    << "eval delta=\\${$(($#-1))}" << std::endl
+    << "eval new=\\${$#}" << std::endl
+    << "test -s \"$delta\" && cp \"$delta\" \"$new\"" << std::endl;
+    BOOST_REQUIRE_EQUAL( filesystem::chmod( file_r, 0755 ), 0 );
+  }
+
+  /** Write a repo providing \a name_r-1-1.noarch and a deltarpm from 0-1.
+   * The rebuild of an \a empty_r deltarpm fails.
+   */
+  void writeRepo( const std::string & alias_r, const std::string & name_r, bool empty_r )
+  {
+    const Pathname & dir { repoDir( alias_r ) };
+    BOOST_REQUIRE_EQUAL( filesystem::assert_dir( dir / "drpms" ), 0 );
+    const std::string & rpm { name_r+".rpm" };
+    const std::string & drpm { "drpms/"+name_r+"-0-1_1-1.drpm" };
+    BOOST_REQUIRE_EQUAL( filesystem::copy( DATADIR / "signed.rpm", dir / rpm ), 0 );
+    if ( empty_r )
+      std::ofstream( ( dir / drpm ).c_str() );
+    else
+      BOOST_REQUIRE_EQUAL( filesystem::copy( DATADIR / "unsigned.rpm", dir / drpm ), 0 );
+
+    SolvWriter solv;
+    ::Pool * pool = solv.pool();
+    ::Repodata * data = solv.data();
+    Id p = solv.addSolvable( name_r );
+    solv.setLocation( p, dir, rpm );
+
+    Id name = solv.solvable( p )->name;
+    Id evr = solv.solvable( p )->evr;
+    Id h = ::repodata_new_handle( data );
+    ::repodata_set_id( data, h, DELTA_PACKAGE_NAME, name );
+    ::repodata_set_id( data, h, DELTA_PACKAGE_EVR, evr );
+    ::repodata_set_id( data, h, DELTA_PACKAGE_ARCH, ARCH_NOARCH );
+    ::repodata_set_id( data, h, DELTA_LOCATION_DIR, ::pool_str2id( pool, "drpms", 1 ) );
+    ::repodata_set_id( data, h, DELTA_LOCATION_NAME, name );
+    ::repodata_set_id( data, h, DELTA_LOCATION_EVR, ::pool_str2id( pool, "0-1_1-1", 1 ) );
+    ::repodata_set_id( data, h, DELTA_LOCATION_SUFFIX, ::pool_str2id( pool, "drpm", 1 ) );
+    ::repodata_set_num( data, h, DELTA_DOWNLOADSIZE, filesystem::PathInfo( dir / drpm ).size() );
+    ::repodata_set_id( data, h, DELTA_BASE_EVR, ::pool_str2id( pool, "0-1", 1 ) );
+    ::repodata_set_id( data, h, DELTA_SEQ_NAME, name );
+    ::repodata_set_id( data, h, DELTA_SEQ_EVR, ::pool_str2id( pool, "0-1", 1 ) );
+    ::repodata_set_str( data, h, DELTA_SEQ_NUM, "0123456789abcdef" );
+    ::repodata_add_flexarray( data, SOLVID_META, REPOSITORY_DELTAINFO, h );
+
+    solv.write( tmp.path() / ( alias_r+".solv" ) );
+  }
+
+  /** Load the repo written by \ref writeRepo. */
+  void loadRepo( const std::string & alias_r, bool pkgGpgCheck_r )
+  {
+    RepoInfo info;
+    info.setAlias( alias_r );
+    info.addBaseUrl( repoDir( alias_r ).asDirUrl() );
+    info.setPackagesPath( cacheDir( alias_r ) );
+    info.setGpgCheck( false );
+    info.setPkgGpgCheck( pkgGpgCheck_r );	// fails without target
+    info.setKeepPackages( true );
+    test.satpool().addRepoSolv( tmp.path() / ( alias_r+".solv" ), info );
+  }
+
+  /** Provide the package in repo \a alias_r with the base version installed. */
+  struct DeltaProvider
+  {
+    DeltaProvider( const std::string & alias_r )
+    {
+      repo::PackageProviderPolicy policy;
+      policy.queryInstalledCB( []( const std::string &, const Edition &, const Arch & ) { return true; } );
+      Repository repo { test.satpool().reposFind( alias_r ) };
+      BOOST_REQUIRE( repo );
+      _provider.reset( new repo::PackageProvider( _access, PoolItem( *repo.solvablesBegin() ),
+						  repo::DeltaCandidates( { repo } ), policy ) );
+    }
+
+    repo::RepoMediaAccess _access;
+    scoped_ptr<repo::PackageProvider> _provider;
+  };
+
+  std::string sha256( const Pathname & file_r )
+  { return filesystem::checksum( file_r, "sha256" ); }
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+struct TestInit {
+  TestInit() {
+    writeApplydeltarpm( tmp.path() / "applydeltarpm" );
+    ::setenv( "ZYPP_TESTSUITE_APPLYDELTARPM", ( tmp.path() / "applydeltarpm" ).c_str(), 1 );
+    ZConfig::instance().set_download_use_deltarpm_always( true );	// though the repos are local
+
+    test = TestSetup( Arch_x86_64 );
+    writeRepo( "good", "good", false );
+    writeRepo( "broken", "broken", true );
+    writeRepo( "badsig", "badsig", false );
+    loadRepo( "good", false );
+    loadRepo( "broken", false );
+    loadRepo( "badsig", true );
+  }
+  ~TestInit() { test.reset(); }
+};
+BOOST_GLOBAL_FIXTURE( TestInit );
+
+BOOST_AUTO_TEST_CASE(delta_rebuild_deferred)
+{
+  DeltaProvider provider( "good" );
+  const Pathname & cachedest { cacheDir( "good" ) / "good.rpm" };
+
+  // A placeholder for the rpm rebuilt in the background...
+  ManagedFile file( provider._provider->fetchPackage() );
+  BOOST_CHECK_EQUAL( file.value(), cachedest );
+  BOOST_CHECK( ! filesystem::PathInfo( cachedest ).isExist() );
+
+  // ...which is moved into the cache when verified.
+  ManagedFile verified( provider._provider->verifyPackage( file ) );
+  BOOST_CHECK_EQUAL( verified.value(), cachedest );
+  BOOST_CHECK_EQUAL( sha256( cachedest ), sha256( DATADIR / "unsigned.rpm" ) );
+  BOOST_CHECK( ! filesystem::PathInfo( cachedest.extend( ".drpm" ) ).isExist() );
+}
+
+BOOST_AUTO_TEST_CASE(delta_rebuild_fallback)
+{
+  DeltaProvider provider( "broken" );
+  const Pathname & cachedest { cacheDir( "broken" ) / "broken.rpm" };
+
+  ManagedFile file( provider._provider->fetchPackage() );
+  BOOST_CHECK_EQUAL( file.value(), cachedest );
+
+  // The failed rebuild is replaced by the full package.
+  ManagedFile verified( provider._provider->verifyPackage( file ) );
+  BOOST_CHECK_EQUAL( verified.value(), cachedest );
+  BOOST_CHECK_EQUAL( sha256( cachedest ), sha256( DATADIR / "signed.rpm" ) );
+  BOOST_CHECK( ! filesystem::PathInfo( cachedest.extend( ".drpm" ) ).isExist() );
+}
+
+BOOST_AUTO_TEST_CASE(delta_rebuild_badsig)
+{
+  DeltaProvider provider( "badsig" );
+  const Pathname & cachedest { cacheDir( "badsig" ) / "badsig.rpm" };
+
+  ManagedFile file( provider._provider->fetchPackage() );
+  BOOST_CHECK_EQUAL( file.value(), cachedest );
+
+  // The rebuilt rpm failing the signature check is removed.
+  BOOST_CHECK_THROW( provider._provider->verifyPackage( file ), AbortRequestException );
+  BOOST_CHECK( ! filesystem::PathInfo( cachedest ).isExist() );
+  BOOST_CHECK( ! filesystem::PathInfo( cachedest.extend( ".drpm" ) ).isExist() );
+}
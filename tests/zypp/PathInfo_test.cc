@@ -1,8 +1,11 @@
 
+#include <sys/stat.h>
+#include <sys/xattr.h>
 #include <iostream>
 #include <fstream>
 #include <list>
 #include <string>
+#include <vector>
 
 #include <boost/test/unit_test.hpp>
 
@@ -10,7 +13,9 @@
 #include <zypp/base/LogControl.h>
 #include <zypp/base/Exception.h>
 #include <zypp/PathInfo.h>
+#include <zypp/Digest.h>
 #include <zypp/TmpPath.h>
+#include <zypp/ZConfig.h>
 
 using boost::unit_test::test_suite;
 using boost::unit_test::test_case;
@@ -46,6 +51,122 @@ BOOST_AUTO_TEST_CASE(pathinfo_checksum_test)
 
   BOOST_REQUIRE( is_checksum( file.path(), file_sha1 ) );
   BOOST_REQUIRE( is_checksum( file.path(), file_md5 ) );
+
+  // several in one pass, some of them remembered from above
+  std::vector<std::string> sums { checksums( file.path(), { "md5", "SHA1", "sha256", "nosuchdigest" } ) };
+  BOOST_REQUIRE_EQUAL( sums.size(), 4 );
+  BOOST_CHECK_EQUAL( sums[0], "f139a810b84d82d1f29fc53c5e59beae" );
+  BOOST_CHECK_EQUAL( sums[1], "142df4277c326f3549520478c188cab6e3b5d042" );
+  BOOST_CHECK_EQUAL( sums[2], Digest::digest( "sha256", buffer ) );
+  BOOST_CHECK_EQUAL( sums[3], "" );
+
+  // a changed file is read again
+  str.open( file.path().c_str(), std::ofstream::out | std::ofstream::app );
+  str << "!";
+  str.close();
+  BOOST_CHECK_EQUAL( checksum( file.path(), "sha1" ), Digest::digest( "sha1", std::string(buffer) + "!" ) );
+  BOOST_CHECK( ! is_checksum( file.path(), file_sha1 ) );
+  BOOST_CHECK_EQUAL( checksum( Pathname("/no/such/file"), "sha1" ), "" );
+
+  // a FIFO is not opened (it would block)
+  TmpDir dir;
+  BOOST_REQUIRE_EQUAL( ::mkfifo( ( dir.path() / "fifo" ).c_str(), 0600 ), 0 );
+  BOOST_CHECK_EQUAL( checksum( dir.path() / "fifo", "sha1" ), "" );
+}
+
+namespace
+{
+  std::string digestKey( const Pathname & file_r )
+  {
+    struct stat st;
+    ::stat( file_r.c_str(), &st );
+    return str::form( "%llx:%llx:%lld:%lld.%09ld", (unsigned long long)st.st_dev, (unsigned long long)st.st_ino,
+		      (long long)st.st_size, (long long)st.st_mtim.tv_sec, st.st_mtim.tv_nsec );
+  }
+
+  std::string getDigestXattr( const Pathname & file_r )
+  {
+    char buf[1024];
+    ssize_t len = ::getxattr( file_r.c_str(), "user.zypp.digests", buf, sizeof(buf) );
+    return std::string( buf, len > 0 ? len : 0 );
+  }
+
+  void forgeDigestXattr( const Pathname & file_r, const std::string & key_r, const std::string & sha1_r )
+  {
+    std::string value { key_r + "\nsha1 " + sha1_r };
+    BOOST_REQUIRE_EQUAL( ::setxattr( file_r.c_str(), "user.zypp.digests", value.data(), value.size(), 0 ), 0 );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(pathinfo_checksum_xattr_test)
+{
+  TmpDir cache;
+  ZConfig & zconfig { ZConfig::instance() };
+  zconfig.setRepoCachePath( cache.path() );
+  zconfig.set_download_persist_checksums( true );
+  BOOST_REQUIRE_EQUAL( filesystem::chmod( cache.path(), 0755 ), 0 );
+  BOOST_REQUIRE_EQUAL( assert_dir( cache.path() / "packages", 0755 ), 0 );
+  BOOST_REQUIRE_EQUAL( filesystem::chmod( cache.path() / "packages", 0755 ), 0 );
+  BOOST_REQUIRE_EQUAL( assert_dir( cache.path() / "shared", 0775 ), 0 );
+  BOOST_REQUIRE_EQUAL( filesystem::chmod( cache.path() / "shared", 0775 ), 0 );
+
+  const std::string content { "remember my checksum" };
+  const std::string sha1 { Digest::digest( "sha1", content ) };
+  const std::string forged( 40, '0' );
+  auto mkfile = [&]( const Pathname & file_r, mode_t mode_r = 0644 ) {
+    std::ofstream( file_r.c_str() ) << content;
+    filesystem::chmod( file_r, mode_r );
+    return file_r;
+  };
+
+  // computed digests are persisted in the cache
+  Pathname file { mkfile( cache.path() / "packages/a.rpm" ) };
+  BOOST_CHECK_EQUAL( checksum( file, "sha1" ), sha1 );
+  if ( getDigestXattr( file ).empty() )
+  {
+    BOOST_TEST_MESSAGE( "No user xattrs in " << cache.path() );
+    zconfig.set_download_persist_checksums( false );
+    zconfig.setRepoCachePath( Pathname() );
+    return;
+  }
+  BOOST_CHECK_EQUAL( getDigestXattr( file ), digestKey( file ) + "\nsha1 " + sha1 );
+
+  // and taken from there, that's what it is for
+  file = mkfile( cache.path() / "packages/b.rpm" );
+  forgeDigestXattr( file, digestKey( file ), forged );
+  BOOST_CHECK_EQUAL( checksum( file, "sha1" ), forged );
+
+  // stale entries are ignored
+  file = mkfile( cache.path() / "packages/c.rpm" );
+  forgeDigestXattr( file, "0:0:0:0.000000000", forged );
+  BOOST_CHECK_EQUAL( checksum( file, "sha1" ), sha1 );
+  BOOST_CHECK_EQUAL( getDigestXattr( file ), digestKey( file ) + "\nsha1 " + sha1 );	// and replaced
+
+  // forged entries are ignored if somebody else could have set them...
+  file = mkfile( cache.path() / "packages/d.rpm", 0664 );
+  forgeDigestXattr( file, digestKey( file ), forged );
+  BOOST_CHECK_EQUAL( checksum( file, "sha1" ), sha1 );
+
+  file = mkfile( cache.path() / "shared/e.rpm" );
+  forgeDigestXattr( file, digestKey( file ), forged );
+  BOOST_CHECK_EQUAL( checksum( file, "sha1" ), sha1 );
+
+  TmpDir elsewhere;
+  file = mkfile( elsewhere.path() / "f.rpm" );
+  forgeDigestXattr( file, digestKey( file ), forged );
+  BOOST_CHECK_EQUAL( checksum( file, "sha1" ), sha1 );
+  BOOST_CHECK_EQUAL( getDigestXattr( file ), digestKey( file ) + "\nsha1 " + forged );	// not touched
+
+  // ...or if persisting is not enabled
+  zconfig.set_download_persist_checksums( false );
+  file = mkfile( cache.path() / "packages/g.rpm" );
+  forgeDigestXattr( file, digestKey( file ), forged );
+  BOOST_CHECK_EQUAL( checksum( file, "sha1" ), sha1 );
+  file = mkfile( cache.path() / "packages/h.rpm" );
+  BOOST_CHECK_EQUAL( checksum( file, "sha1" ), sha1 );
+  BOOST_CHECK_EQUAL( getDigestXattr( file ), "" );
+
+  zconfig.setRepoCachePath( Pathname() );
 }
 
 BOOST_AUTO_TEST_CASE(pathinfo_is_exist_test)
@@ -211,3 +332,43 @@ BOOST_AUTO_TEST_CASE(test_exchange)
   BOOST_CHECK( PathInfo(a).isFile() );
   BOOST_CHECK( PathInfo(b).isDir() );
 }
+
+BOOST_AUTO_TEST_CASE(test_copy)
+{
+  TmpDir tmp;
+  Pathname src( tmp.path() / "src" );
+  BOOST_REQUIRE_EQUAL( assert_dir( src / "sub" ), 0 );
+  {
+    std::ofstream( (src / "file").c_str() ) << "content";
+  }
+  BOOST_REQUIRE_EQUAL( hardlink( src / "file", src / "sub" / "hardlink" ), 0 );
+  BOOST_REQUIRE_EQUAL( symlink( "../file", src / "sub" / "symlink" ), 0 );
+
+  // copy replaces the destination
+  Pathname dest( tmp.path() / "copy" );
+  BOOST_REQUIRE_EQUAL( symlink( "file", dest ), 0 );
+  BOOST_CHECK_EQUAL( copy( src / "file", dest ), 0 );
+  BOOST_CHECK( PathInfo( dest, PathInfo::LSTAT ).isFile() );
+  BOOST_CHECK_EQUAL( sha1sum( dest ), sha1sum( src / "file" ) );
+  BOOST_CHECK_EQUAL( copy( src / "file", tmp.path() ), EISDIR );
+  BOOST_CHECK_EQUAL( copy_file2dir( src / "file", src ), EEXIST );	// same file
+
+  // copy_dir keeps symlinks and hardlinks
+  Pathname destdir( tmp.path() / "dest" );
+  BOOST_REQUIRE_EQUAL( assert_dir( destdir ), 0 );
+  BOOST_CHECK_EQUAL( copy_dir( src, destdir ), 0 );
+  BOOST_CHECK_EQUAL( copy_dir( src, destdir ), EEXIST );
+  PathInfo file( destdir / "src" / "file" );
+  PathInfo link( destdir / "src" / "sub" / "hardlink" );
+  BOOST_CHECK_EQUAL( sha1sum( file.path() ), sha1sum( src / "file" ) );
+  BOOST_CHECK_EQUAL( file.ino(), link.ino() );
+  BOOST_CHECK_EQUAL( file.nlink(), 2 );
+  BOOST_CHECK( PathInfo( destdir / "src" / "sub" / "symlink", PathInfo::LSTAT ).isLink() );
+
+  // copy_dir_content merges into an existing directory
+  Pathname contentdir( tmp.path() / "content" );
+  BOOST_REQUIRE_EQUAL( assert_dir( contentdir / "sub" ), 0 );
+  BOOST_CHECK_EQUAL( copy_dir_content( src, contentdir ), 0 );
+  BOOST_CHECK( PathInfo( contentdir / "file" ).isFile() );
+  BOOST_CHECK( PathInfo( contentdir / "sub" / "symlink", PathInfo::LSTAT ).isLink() );
+}
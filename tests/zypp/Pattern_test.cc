@@ -0,0 +1,115 @@
+#include <set>
+#include <string>
+#include <vector>
+
+#include "TestSetup.h"
+#include "SolvWriter.h"
+#include <zypp/ResPool.h>
+#include <zypp/Pattern.h>
+#include <zypp/sat/detail/PoolImpl.h>
+
+#define BOOST_TEST_MODULE Pattern
+
+static TestSetup test( TestSetup::initLater );
+struct TestInit {
+  TestInit() {
+    test = TestSetup( Arch_x86_64 );
+  }
+  ~TestInit() { test.reset(); }
+};
+BOOST_GLOBAL_FIXTURE( TestInit );
+
+static filesystem::TmpDir tmp;	// the solv files
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  struct SolvableDesc
+  {
+    std::string name;
+    std::vector<std::string> req;
+    std::vector<std::string> inc;
+    std::vector<std::string> ext;
+  };
+
+  /** Write a solv file containing \a solvables_r. */
+  void writeSolv( const Pathname & file_r, const std::vector<SolvableDesc> & solvables_r )
+  {
+    SolvWriter solv;
+    for ( const SolvableDesc & desc : solvables_r )
+    {
+      Id p = solv.addSolvable( desc.name );
+      for ( const std::string & req : desc.req )
+	solv.addRequires( p, req );
+      for ( const std::string & inc : desc.inc )
+	solv.addPoolstr( p, SOLVABLE_INCLUDES, "pattern:"+inc );
+      for ( const std::string & ext : desc.ext )
+	solv.addPoolstr( p, SOLVABLE_EXTENDS, "pattern:"+ext );
+    }
+    solv.write( file_r );
+  }
+
+  /** Names of the packages in the contents of \a pattern_r. */
+  std::set<std::string> contents( const std::string & pattern_r )
+  {
+    std::set<std::string> ret;
+    for ( const PoolItem & pi : test.pool().byIdent( ResKind::pattern, pattern_r ) )
+      for ( const sat::Solvable & solv : asKind<Pattern>( pi )->contents() )
+	ret.insert( solv.name() );
+    return ret;
+  }
+
+  typedef std::set<std::string> Names;
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE(pattern_contents)
+{
+  // A includes B, B and C include each other, D extends A, E includes itself
+  writeSolv( tmp.path() / "patterns.solv", {
+    { "pattern:A", { "pa" }, { "B" }, {} },
+    { "pattern:B", { "pb" }, { "C" }, {} },
+    { "pattern:C", { "pc" }, { "B" }, {} },
+    { "pattern:D", { "pd" }, {}, { "A" } },
+    { "pattern:E", { "pe" }, { "E" }, {} },
+    { "pa" }, { "pb" }, { "pc" }, { "pd" }, { "pe" }, { "pf" },
+  } );
+  test.loadRepo( tmp.path() / "patterns.solv", "patterns" );
+
+  BOOST_CHECK( contents( "A" ) == Names({ "pa", "pb", "pc", "pd" }) );
+  BOOST_CHECK( contents( "B" ) == Names({ "pb", "pc" }) );	// the cycle is one component
+  BOOST_CHECK( contents( "C" ) == Names({ "pb", "pc" }) );
+  BOOST_CHECK( contents( "D" ) == Names({ "pd" }) );
+  BOOST_CHECK( contents( "E" ) == Names({ "pe" }) );
+
+  // a new repo extending the cycle is noticed...
+  writeSolv( tmp.path() / "extra.solv", {
+    { "pattern:F", { "pf" }, {}, { "C" } },
+  } );
+  test.loadRepo( tmp.path() / "extra.solv", "extra" );
+  BOOST_CHECK( contents( "B" ) == Names({ "pb", "pc", "pf" }) );
+  BOOST_CHECK( contents( "A" ) == Names({ "pa", "pb", "pc", "pd", "pf" }) );
+  BOOST_CHECK( contents( "F" ) == Names({ "pf" }) );
+
+  // ...as well as its removal
+  test.satpool().reposErase( "extra" );
+  BOOST_CHECK( contents( "B" ) == Names({ "pb", "pc" }) );
+  BOOST_CHECK( contents( "A" ) == Names({ "pa", "pb", "pc", "pd" }) );
+}
+
+BOOST_AUTO_TEST_CASE(pattern_contents_invalidation)
+{
+  // The contents are remembered until the dependency related indices change.
+  // Requested locales (namespace:language) affect them without a content change.
+  const SerialNumber & serialDeps { sat::detail::PoolMember::myPool().serialDeps() };
+  SerialNumberWatcher watcher( serialDeps );
+  BOOST_CHECK( contents( "A" ) == Names({ "pa", "pb", "pc", "pd" }) );
+
+  test.satpool().addRequestedLocale( Locale( "de" ) );
+  BOOST_CHECK( watcher.isDirty( serialDeps ) );
+  BOOST_CHECK( contents( "A" ) == Names({ "pa", "pb", "pc", "pd" }) );
+
+  watcher.remember( serialDeps );
+  test.satpool().eraseRequestedLocale( Locale( "de" ) );
+  BOOST_CHECK( watcher.isDirty( serialDeps ) );
+}
@@ -169,6 +169,27 @@ BOOST_AUTO_TEST_CASE(PluginScriptReceive)
   BOOST_CHECK_THROW(  scr.receive(), PluginScriptDiedUnexpectedly );
 }
 
+BOOST_AUTO_TEST_CASE(PluginScriptSendReceive)
+{
+  PluginFrame f( "CMD" );
+  f.setBody( std::string( 1020, '0' ) );
+
+  std::vector<PluginScript> scripts { PluginScript( "/bin/cat" ), PluginScript( "/bin/cat" ), PluginScript( "/bin/cat" ) };
+  scripts[0].open();
+  scripts[2].open();
+
+  std::vector<PluginFrame> r( PluginScript::sendReceive( scripts, f ) );
+  BOOST_REQUIRE_EQUAL( r.size(), 3 );
+  BOOST_CHECK_EQUAL( r[0], f );
+  BOOST_CHECK_EQUAL( r[1], PluginFrame() );	// not connected
+  BOOST_CHECK_EQUAL( r[2], f );
+
+  ::kill( scripts[2].getPid(), SIGKILL );
+  r = PluginScript::sendReceive( scripts, f );
+  BOOST_CHECK_EQUAL( r[0], f );
+  BOOST_CHECK_EQUAL( r[2], PluginFrame() );	// died
+}
+
 BOOST_AUTO_TEST_CASE(PluginExecutorTest)
 {
   PluginExecutor exec;
@@ -1,6 +1,7 @@
 #include "TestSetup.h"
 #include <zypp/PoolQuery.h>
 #include <zypp/PoolQueryUtil.tcc>
+#include <zypp/sat/detail/SearchIndex.h>
 
 #define BOOST_TEST_MODULE PoolQuery
 
@@ -987,3 +988,56 @@ BOOST_AUTO_TEST_CASE(zypperLocksSerialize)
     }
   }
 }
+
+/////////////////////////////////////////////////////////////////////////////
+//  file list search narrowed by the search index
+/////////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_CASE(pool_query_searchindex)
+{
+  auto search = []( const std::string & str_r, void (PoolQuery::*mode_r)(), bool fullpath_r = false, bool nocase_r = false ) {
+    PoolQuery q;
+    q.addAttribute( sat::SolvAttr::filelist, str_r );
+    (q.*mode_r)();
+    q.setFilesMatchFullPath( fullpath_r );
+    q.setCaseSensitive( ! nocase_r );
+    std::set<std::string> ret;
+    for ( const sat::Solvable & solv : q )
+      ret.insert( solv.asString() );
+    return ret;
+  };
+  auto searches = [&]() {
+    std::vector<std::set<std::string>> ret;
+    ret.push_back( search( "glabels", &PoolQuery::setMatchSubstring ) );
+    ret.push_back( search( "/opt/gnome/bin/glabels*", &PoolQuery::setMatchGlob, true ) );
+    ret.push_back( search( "/usr/share/doc/packages/*/[Rr]eadme.t?t", &PoolQuery::setMatchGlob, true ) );
+    ret.push_back( search( "README.TXT", &PoolQuery::setMatchExact, false, true ) );
+    ret.push_back( search( "bin", &PoolQuery::setMatchSubstring ) );
+    ret.push_back( search( "nosuchfile", &PoolQuery::setMatchSubstring ) );
+    ret.push_back( search( "/opt/gnome/share/gnome/help/glabels/C/figures/merge-ex[[:digit:]]-[[:digit:]].png", &PoolQuery::setMatchGlob, true ) );
+    return ret;
+  };
+
+  test.loadRepo( TESTS_SRC_DIR "/repo/yum/data/10.2-updates-subset", "filelists" );
+  std::vector<std::set<std::string>> plain( searches() );
+  BOOST_CHECK( ! plain[0].empty() );
+  BOOST_CHECK( ! plain[1].empty() );
+  BOOST_CHECK( plain[5].empty() );
+  BOOST_CHECK( ! plain[6].empty() );
+
+  // build the index and reload the repo
+  Pathname solvfile( RepoManagerOptions::makeTestSetup( test.root() ).repoSolvCachePath / "filelists" / "solv" );
+  sat::updateSolvFileSearchIndex( solvfile );
+  BOOST_REQUIRE( PathInfo( solvfile.extend( ".trigrams" ) ).isFile() );
+  test.satpool().reposErase( "filelists" );
+  Repository repo( test.satpool().addRepoSolv( solvfile, "filelists" ) );
+
+  // the index narrows the search...
+  std::vector<sat::detail::SolvableIdType> candidates;
+  BOOST_REQUIRE( sat::detail::SearchIndex::candidates( repo.get(), { "glabels" }, candidates ) );
+  BOOST_CHECK( ! candidates.empty() );
+  BOOST_CHECK( candidates.size() < repo.solvablesSize() );
+
+  // ...without changing the result
+  BOOST_CHECK( searches() == plain );
+  test.satpool().reposErase( "filelists" );
+}
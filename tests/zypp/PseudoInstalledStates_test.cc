@@ -0,0 +1,161 @@
+#include <string>
+#include <vector>
+
+#include "TestSetup.h"
+#include "SolvWriter.h"
+#include <zypp/sat/Map.h>
+
+#define ZYPP_USE_RESOLVER_INTERNALS
+#include <zypp/solver/detail/PseudoInstalledStates.h>
+
+#define BOOST_TEST_MODULE PseudoInstalledStates
+
+using zypp::solver::detail::PseudoInstalledStates;
+
+static TestSetup test( TestSetup::initLater );
+struct TestInit {
+  TestInit() {
+    test = TestSetup( Arch_x86_64 );
+  }
+  ~TestInit() { test.reset(); }
+};
+BOOST_GLOBAL_FIXTURE( TestInit );
+
+static filesystem::TmpDir tmp;	// the solv files
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  struct SolvableDesc
+  {
+    std::string name;
+    std::string evr;
+    std::vector<std::string> req;
+    std::vector<std::string> con;
+  };
+
+  /** Write a solv file containing \a solvables_r. */
+  void writeSolv( const Pathname & file_r, const std::vector<SolvableDesc> & solvables_r )
+  {
+    SolvWriter solv;
+    for ( const SolvableDesc & desc : solvables_r )
+    {
+      Id p = solv.addSolvable( desc.name, desc.evr );
+      for ( const std::string & req : desc.req )
+	solv.addRequires( p, req );
+      for ( const std::string & con : desc.con )
+	solv.addConflicts( p, con );
+    }
+    solv.write( file_r );
+  }
+
+  /** The patches and patterns in the pool. */
+  void pseudoItems( sat::Queue & items_r )
+  {
+    items_r.clear();
+    for ( const sat::Solvable & solv : test.satpool().solvables() )
+    {
+      if ( solv.isKind( ResKind::patch ) || solv.isKind( ResKind::pattern ) )
+	items_r.push( solv.id() );
+    }
+  }
+
+  /** The solvables named \a names_r in \a repo_r. */
+  void decisions( sat::Queue & decisions_r, const std::string & repo_r, const std::vector<std::string> & names_r )
+  {
+    for ( const sat::Solvable & solv : test.satpool().reposFind( repo_r ).solvables() )
+    {
+      if ( std::find( names_r.begin(), names_r.end(), solv.name() ) != names_r.end() )
+	decisions_r.push( solv.id() );
+    }
+  }
+
+  /** Check the cached \a states_r are those of evaluating all items at once. */
+  void checkStates( PseudoInstalledStates & states_r, const sat::Queue & decisions_r )
+  {
+    test.satpool().prepare();
+    sat::Queue items;
+    pseudoItems( items );
+    BOOST_REQUIRE( ! items.empty() );
+
+    sat::Queue flags;
+    states_r.update( items, decisions_r, flags );
+
+    sat::Map installedmap( sat::Map::poolSize );
+    for ( sat::detail::IdType id : decisions_r )
+      installedmap.set( id );
+    sat::Queue expected;
+    ::pool_trivial_installable_multiversionmap( test.satpool().get(), installedmap, items, expected, nullptr );
+    for ( sat::Queue::size_type i = 0; i < items.size(); ++i )
+    {
+      if ( sat::Solvable(items[i]).isKind( ResKind::patch ) && expected[i] != -1
+	   && ::solvable_is_irrelevant_patch( test.satpool().get()->solvables + items[i], installedmap ) )
+	expected[i] = -1;
+    }
+    BOOST_CHECK( flags == expected );
+  }
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE(pseudoinstalled_incremental)
+{
+  writeSolv( tmp.path() / "system.solv", {
+    { "a", "1-1" }, { "b", "1-1" },
+  } );
+  writeSolv( tmp.path() / "updates.solv", {
+    { "a", "2-1" }, { "c", "1-1" },
+    { "patch:pa", "1", {}, { "a < 2-1" } },
+    { "patch:pb", "1", {}, { "b < 2-1" } },
+    { "pattern:base", "1", { "a", "b" } },
+    { "pattern:top", "1", { "pattern:base" } },	// depends on the state of another item
+    { "pattern:c", "1", { "c" } },
+  } );
+  test.loadTargetRepo( tmp.path() / "system.solv" );
+  test.loadRepo( tmp.path() / "updates.solv", "updates" );
+
+  PseudoInstalledStates states;
+  {
+    sat::Queue decided;
+    decisions( decided, sat::Pool::systemRepoAlias(), { "a", "b" } );
+    checkStates( states, decided );
+  }
+  // an install (and an update)...
+  {
+    sat::Queue decided;
+    decisions( decided, sat::Pool::systemRepoAlias(), { "b" } );
+    decisions( decided, "updates", { "a", "c" } );
+    checkStates( states, decided );
+  }
+  // ...a removal, changing the state of pattern:top via pattern:base...
+  {
+    sat::Queue decided;
+    decisions( decided, "updates", { "a", "c" } );
+    checkStates( states, decided );
+  }
+  // ...and nothing changed
+  {
+    sat::Queue decided;
+    decisions( decided, "updates", { "a", "c" } );
+    checkStates( states, decided );
+  }
+  // a reloaded system repo (the decided solvables are gone)
+  {
+    test.satpool().reposErase( sat::Pool::systemRepoAlias() );
+    test.loadTargetRepo( tmp.path() / "system.solv" );
+    sat::Queue decided;
+    decisions( decided, sat::Pool::systemRepoAlias(), { "a", "b" } );
+    checkStates( states, decided );
+  }
+  // and items leaving and entering the pool
+  {
+    test.satpool().reposErase( "updates" );
+    writeSolv( tmp.path() / "updates.solv", {
+      { "patch:pb", "1", {}, { "b < 2-1" } },
+      { "pattern:base", "1", { "a", "b" } },
+    } );
+    test.loadRepo( tmp.path() / "updates.solv", "updates" );
+    sat::Queue decided;
+    decisions( decided, sat::Pool::systemRepoAlias(), { "a" } );
+    checkStates( states, decided );
+  }
+}
@@ -0,0 +1,100 @@
+#include <fstream>
+#include <list>
+#include <string>
+
+#include <zypp/base/LogTools.h>
+#include <zypp/TmpPath.h>
+#include <zypp/PathInfo.h>
+#include <zypp/RepoManager.h>
+
+#include "TestSetup.h"
+#include "WebServer.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include "KeyRingTestReceiver.h"
+
+using namespace zypp;
+using namespace zypp::filesystem;
+using namespace zypp::repo;
+
+#define REPODATADIR (Pathname(TESTS_SRC_DIR) + "/repo/yum/data/10.2-updates-subset")
+
+BOOST_AUTO_TEST_CASE(checkIfToRefreshMetadata_concurrent)
+{
+  KeyRingTestReceiver keyring_callbacks;
+  keyring_callbacks.answerAcceptKey(KeyRingReport::KEY_TRUST_TEMPORARILY);
+  keyring_callbacks.answerAcceptVerFailed(true);
+  keyring_callbacks.answerAcceptUnknownKey(true);
+
+  // serve a copy of the repo per alias, so we can modify them
+  TmpDir webroot;
+  const std::vector<std::string> aliases { "unchanged", "changed", "removed", "unreachable", "probed" };
+  for ( const std::string & alias : aliases )
+  {
+    BOOST_REQUIRE_EQUAL( assert_dir( webroot.path() / alias ), 0 );
+    BOOST_REQUIRE_EQUAL( copy_dir_content( REPODATADIR, webroot.path() / alias ), 0 );
+  }
+
+  WebServer web( webroot.path(), 10001 );
+  BOOST_REQUIRE( web.start() );
+
+  TmpDir tmpCachePath;
+  RepoManagerOptions opts( RepoManagerOptions::makeTestSetup( tmpCachePath ) );
+  RepoManager manager( opts );
+
+  std::list<RepoInfo> repos;
+  for ( const std::string & alias : aliases )
+  {
+    Url url( web.url() );
+    url.setPathName( "/"+alias );
+    RepoInfo info;
+    info.setAlias( alias );
+    info.setBaseUrl( url );
+    info.setGpgCheck( false );
+    if ( alias != "probed" )
+      info.setType( RepoType::RPMMD );	// "probed" is probed by the check
+    manager.refreshMetadata( info, RepoManager::RefreshForced );
+    BOOST_REQUIRE( ! manager.metadataStatus( info ).empty() );
+    repos.push_back( info );
+  }
+
+  // now change the server side
+  {
+    std::ofstream repomd( ( webroot.path() / "changed/repodata/repomd.xml" ).c_str(), std::ios::app );
+    repomd << "<!-- changed -->" << std::endl;
+  }
+  BOOST_REQUIRE_EQUAL( recursive_rmdir( webroot.path() / "removed" ), 0 );
+  for ( RepoInfo & info : repos )
+  {
+    if ( info.alias() == "unreachable" )
+    {
+      Url url( info.url() );
+      url.setPort( "10002" );	// no one is listening
+      info.setBaseUrl( url );
+    }
+  }
+
+  // all http repos are checked concurrently, the failing ones again one by one
+  std::map<std::string,RepoManager::RefreshCheckStatus> stat = manager.checkIfToRefreshMetadata( repos, RepoManager::RefreshIfNeededIgnoreDelay );
+  BOOST_CHECK_EQUAL( stat.size(), repos.size() );
+  BOOST_CHECK_EQUAL( stat["unchanged"],   RepoManager::REPO_UP_TO_DATE );
+  BOOST_CHECK_EQUAL( stat["probed"],      RepoManager::REPO_UP_TO_DATE );
+  BOOST_CHECK_EQUAL( stat["changed"],     RepoManager::REFRESH_NEEDED );
+  BOOST_CHECK_EQUAL( stat["removed"],     RepoManager::REFRESH_NEEDED );
+  BOOST_CHECK_EQUAL( stat["unreachable"], RepoManager::REFRESH_NEEDED );
+
+  // the single repo check agrees
+  for ( const RepoInfo & info : repos )
+  {
+    if ( info.alias() == "unreachable" )
+      BOOST_CHECK_THROW( manager.checkIfToRefreshMetadata( info, info.url(), RepoManager::RefreshIfNeededIgnoreDelay ), Exception );
+    else if ( info.alias() != "removed" )
+      BOOST_CHECK_EQUAL( manager.checkIfToRefreshMetadata( info, info.url(), RepoManager::RefreshIfNeededIgnoreDelay ), stat[info.alias()] );
+  }
+
+  // a refresh delay is still honored before any request is sent
+  web.stop();
+  stat = manager.checkIfToRefreshMetadata( repos, RepoManager::RefreshIfNeeded );
+  BOOST_CHECK_EQUAL( stat["unchanged"], RepoManager::REPO_CHECK_DELAYED );
+}
@@ -239,6 +239,11 @@ BOOST_AUTO_TEST_CASE(repomanager_test)
   SEC << endl << ref_stat << endl;
   BOOST_CHECK_MESSAGE( ref_stat== RepoManager::REPO_UP_TO_DATE || ref_stat == RepoManager::REPO_CHECK_DELAYED, "Metadata should be up to date" );
 
+  // Same for the batch check (plain directories are checked one by one)
+  std::map<std::string,RepoManager::RefreshCheckStatus> batch_stat = manager.checkIfToRefreshMetadata( std::list<RepoInfo>{ repo } );
+  BOOST_CHECK_EQUAL( batch_stat.size(), 1 );
+  BOOST_CHECK_EQUAL( batch_stat[repo.alias()], ref_stat );
+
    // the solv file should exists now
   Pathname base = (opts.repoCachePath / "solv" / repo.alias());
   Pathname solvfile = base / "solv";
@@ -1,4 +1,5 @@
 
+#include <fstream>
 #include <zypp/base/Logger.h>
 #include <zypp/base/Exception.h>
 #include <zypp/TmpPath.h>
@@ -30,3 +31,87 @@ BOOST_AUTO_TEST_CASE(repostatus_test)
   BOOST_CHECK_EQUAL( (fstatus&&fstatus2), (fstatus2&&fstatus) );
 
 }
+
+BOOST_AUTO_TEST_CASE(repostatus_directory)
+{
+  TmpDir dir;
+  assert_dir( dir.path() / "sub" );
+  {
+    std::ofstream( (dir.path() / "a.rpm").c_str() ) << "aaa";
+    std::ofstream( (dir.path() / "sub/b.rpm").c_str() ) << "bbb";
+  }
+
+  RepoStatus dstatus( RepoStatus::fromDirectory( dir.path() ) );
+  BOOST_CHECK_EQUAL( dstatus.empty(), false );
+  BOOST_REQUIRE_EQUAL( dstatus.fileTable().size(), 2 );
+  BOOST_CHECK_EQUAL( dstatus.fileTable()[0]._path, "a.rpm" );
+  BOOST_CHECK_EQUAL( dstatus.fileTable()[1]._path, "sub/b.rpm" );
+  BOOST_CHECK_EQUAL( dstatus.fileTable()[1]._size, 3 );
+  BOOST_CHECK_EQUAL( dstatus.fileTable()[1]._digest.size(), 20 );	// binary sha1
+  BOOST_CHECK( RepoStatus::fileChanges( dstatus, dstatus ).empty() );
+
+  // the binary cookie keeps the file table
+  TmpFile cookie;
+  dstatus.saveToCookieFile( cookie );
+  RepoStatus cstatus( RepoStatus::fromCookieFile( cookie ) );
+  BOOST_CHECK_EQUAL( cstatus, dstatus );
+  BOOST_CHECK_EQUAL( cstatus.timestamp(), dstatus.timestamp() );
+  BOOST_REQUIRE_EQUAL( cstatus.fileTable().size(), 2 );
+  BOOST_CHECK_EQUAL( cstatus.fileTable()[1]._inode, dstatus.fileTable()[1]._inode );
+  BOOST_CHECK_EQUAL( cstatus.fileTable()[1]._digest, dstatus.fileTable()[1]._digest );
+
+  // the text cookie is still read
+  RepoStatus fstatus( cookie );
+  fstatus.saveToCookieFile( cookie );
+  BOOST_CHECK_EQUAL( RepoStatus::fromCookieFile( cookie ), fstatus );
+  BOOST_CHECK( RepoStatus::fromCookieFile( cookie ).fileTable().empty() );
+
+  // changes are detected per file
+  filesystem::unlink( dir.path() / "a.rpm" );
+  {
+    std::ofstream( (dir.path() / "c.rpm").c_str() ) << "ccc";
+    std::ofstream( (dir.path() / "sub/b.rpm").c_str(), std::ios::app ) << "b";
+  }
+  RepoStatus nstatus( RepoStatus::fromDirectory( dir.path(), cstatus ) );
+  BOOST_CHECK( nstatus != dstatus );
+  RepoStatus::FileChanges changes( RepoStatus::fileChanges( cstatus, nstatus ) );
+  BOOST_CHECK( changes._added == std::vector<std::string>{ "c.rpm" } );
+  BOOST_CHECK( changes._removed == std::vector<std::string>{ "a.rpm" } );
+  BOOST_CHECK( changes._changed == std::vector<std::string>{ "sub/b.rpm" } );
+}
+
+BOOST_AUTO_TEST_CASE(repostatus_broken_cookie)
+{
+  // magic, empty checksum, timestamp and an absurd file count without files
+  TmpFile cookie;
+  {
+    std::ofstream file( cookie.path().c_str(), std::ios::binary );
+    const char data[] = { '\0', 'Z', 'R', 'S', '\1', 0, 0,  1, 0, 0, 0, 0, 0, 0, 0,  '\xff', '\xff', '\xff', '\xff' };
+    file.write( data, sizeof(data) );
+  }
+  BOOST_CHECK( RepoStatus::fromCookieFile( cookie ).empty() );
+}
+
+BOOST_AUTO_TEST_CASE(repostatus_rpm_header_digest)
+{
+  // an rpm lead, an empty signature and a main header larger than 64K
+  std::string rpm( 400000, 'x' );
+  const char lead[] = { '\xed', '\xab', '\xee', '\xdb' };
+  const char sig[]  = { '\x8e', '\xad', '\xe8', 1, 0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0 };
+  const char hdr[]  = { '\x8e', '\xad', '\xe8', 1, 0, 0, 0, 0,  0, 0, 0, 0,  0, 3, '\x0d', '\x40' };	// 200000 bytes data
+  rpm.replace( 0, sizeof(lead), lead, sizeof(lead) );
+  rpm.replace( 96, sizeof(sig), sig, sizeof(sig) );
+  rpm.replace( 112, sizeof(hdr), hdr, sizeof(hdr) );
+
+  TmpDir dir;
+  std::ofstream( (dir.path() / "a.rpm").c_str(), std::ios::binary ) << rpm;
+  RepoStatus before( RepoStatus::fromDirectory( dir.path() ) );
+
+  // a change in the header beyond the first and last 64K is detected
+  rpm[150000] = 'y';
+  std::ofstream( (dir.path() / "a.rpm").c_str(), std::ios::binary ) << rpm;
+  RepoStatus after( RepoStatus::fromDirectory( dir.path() ) );
+  BOOST_REQUIRE_EQUAL( before.fileTable().size(), 1 );
+  BOOST_REQUIRE_EQUAL( after.fileTable().size(), 1 );
+  BOOST_CHECK( before.fileTable()[0]._digest != after.fileTable()[0]._digest );
+}
@@ -5,6 +5,7 @@ using namespace boost::unit_test;
 #include "TestSetup.h"
 #include <zypp/ResPool.h>
 #include <zypp/ResPoolProxy.h>
+#include <zypp/ResolverProblem.h>
 #include <zypp/pool/PoolStats.h>
 #include <zypp/ui/Selectable.h>
 
@@ -98,3 +99,37 @@ BOOST_AUTO_TEST_CASE(inrOnlyRequires)
   // Fillup only namespace recommends
   BOOST_checkresult( resolve( inrMode|onlyRequires ), { Apde } );
 }
+
+BOOST_AUTO_TEST_CASE(resolveAgain)
+{
+  // The solver is reused across resolves, results must follow the status changes
+  PoolItemSet initial { resolve() };
+
+  Ap.status().setTransact( true, ResStatus::USER );
+  BOOST_checkresult( resolve(), { Ap, Ip, Apde, Aprec } );
+
+  Aprec.status().setLock( true, ResStatus::USER );
+  BOOST_CHECK_EQUAL( resolve().count( Aprec ), 0 );
+
+  Aprec.status().setLock( false, ResStatus::USER );
+  BOOST_checkresult( resolve(), { Ap, Ip, Apde, Aprec } );
+
+  Ap.status().setTransact( false, ResStatus::USER );
+  BOOST_checkresult( resolve(), initial );
+}
+
+BOOST_AUTO_TEST_CASE(lazyProblem)
+{
+  // Problems returned by the solver are computed on first access
+  unsigned calls = 0;
+  ResolverProblem_Ptr problem { new ResolverProblem( [&calls]( ResolverProblem & problem_r ) {
+    ++calls;
+    problem_r.setDescription( "description" );
+    problem_r.setDetails( problem_r.description() + " details" );
+  } ) };
+  BOOST_CHECK_EQUAL( calls, 0 );
+  BOOST_CHECK_EQUAL( problem->details(), "description details" );
+  BOOST_CHECK_EQUAL( problem->description(), "description" );
+  BOOST_CHECK( problem->solutions().empty() );
+  BOOST_CHECK_EQUAL( calls, 1 );
+}
@@ -351,4 +351,37 @@ BOOST_AUTO_TEST_CASE(pickstatus_cycle)
   }
 }
 
+
+BOOST_AUTO_TEST_CASE(proxy_update)
+{
+  // After a repo is removed or added, the proxy is updated for the
+  // affected idents only; all other Selectables are taken over.
+  ResPoolProxy orig( test.poolProxy() );
+  ui::Selectable::Ptr pkg( orig.lookup( ResKind::package, "candidate" ) );
+  BOOST_REQUIRE( pkg );
+  BOOST_REQUIRE( orig.lookup( ResKind::srcpackage, "candidate" ) );
+
+  sat::Pool::instance().reposErase( "RepoSRC" );
+  {
+    ResPoolProxy proxy( test.poolProxy() );
+    BOOST_CHECK_EQUAL( proxy.size(), orig.size()-2 );	// srcpackage candidate and candidatenoarch
+    BOOST_CHECK( ! proxy.lookup( ResKind::srcpackage, "candidate" ) );
+    BOOST_CHECK( proxy.lookup( ResKind::package, "candidate" ) == pkg );
+  }
+
+  test.loadHelix( TESTS_SRC_DIR"/data/TCSelectable/RepoSRC.xml", "RepoSRC" );
+  {
+    ResPoolProxy proxy( test.poolProxy() );
+    BOOST_CHECK_EQUAL( proxy.size(), orig.size() );
+    BOOST_CHECK( proxy.lookup( ResKind::package, "candidate" ) == pkg );
+    for ( const ui::Selectable::Ptr & sel : proxy )
+    {
+      ui::Selectable::Ptr o( orig.lookup( sel->kind(), sel->name() ) );
+      BOOST_REQUIRE( o );
+      BOOST_CHECK_EQUAL( sel->availableSize(), o->availableSize() );
+      BOOST_CHECK_EQUAL( sel->installedSize(), o->installedSize() );
+    }
+  }
+}
+
 /////////////////////////////////////////////////////////////////////////////
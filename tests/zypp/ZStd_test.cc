@@ -0,0 +1,56 @@
+// Boost.Test
+#include <boost/test/unit_test.hpp>
+
+#include <zypp/base/ZStdStream.h>
+#include <zypp/Pathname.h>
+#include <zypp/base/InputStream.h>
+#include <zypp/base/IOStream.h>
+#include <zypp/base/String.h>
+#include <zypp/PathInfo.h>
+
+BOOST_AUTO_TEST_CASE(zstd_simple_read_write)
+{
+  const zypp::Pathname file = zypp::Pathname(TESTS_BUILD_DIR) / "test.zst";
+  const std::string testString("HelloWorld");
+
+  {
+    zypp::ofzstdstream strOut( file.c_str() );
+    BOOST_REQUIRE( strOut.is_open() );
+    strOut << testString;
+  }
+
+  BOOST_REQUIRE_EQUAL( zypp::filesystem::zipType( file ), zypp::filesystem::ZT_ZSTD  );
+
+  {
+    std::string test;
+    zypp::ifzstdstream str( file.c_str() );
+    str >> test;
+    BOOST_REQUIRE_EQUAL( test, testString );
+  }
+
+  {
+    zypp::InputStream iStr( file );
+    BOOST_REQUIRE( typeid( iStr.stream() ) == typeid( zypp::ifzstdstream& ) );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(zstd_large_read)
+{
+  const zypp::Pathname file = zypp::Pathname(TESTS_BUILD_DIR) / "large.zst";
+  // more than one buffer of compressed and uncompressed data
+  std::string testString;
+  for ( unsigned i = 0; i < 100000; ++i )
+    testString += zypp::str::numstring( i ) + " line\n";
+
+  {
+    zypp::ofzstdstream strOut( file.c_str() );
+    BOOST_REQUIRE( strOut.is_open() );
+    strOut << testString;
+  }
+
+  zypp::InputStream iStr( file );
+  std::string test;
+  for( zypp::iostr::EachLine in( iStr ); in; in.next() )
+    test += *in + "\n";
+  BOOST_REQUIRE_EQUAL( test, testString );
+}
@@ -1,9 +1,17 @@
 #include <boost/test/unit_test.hpp>
+#include <boost/test/data/test_case.hpp>
 #include <zypp/zyppng/base/EventDispatcher>
 #include <zypp/zyppng/base/Timer>
+#include <zypp/zyppng/base/SocketNotifier>
 #include <zypp/base/Exception.h>
 
 #include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace bdata = boost::unit_test::data;
+
+zyppng::EventDispatcher::Backend allBackends[] = { zyppng::EventDispatcher::GLibBackend, zyppng::EventDispatcher::EpollBackend };
 
 BOOST_AUTO_TEST_CASE(eventloop)
 {
@@ -102,3 +110,72 @@ BOOST_AUTO_TEST_CASE(checkcleanup)
 
   BOOST_REQUIRE_EQUAL( loop.get(), zyppng::EventDispatcher::instance().get() );
 }
+
+BOOST_DATA_TEST_CASE(backend_timers, bdata::make( allBackends ), backend)
+{
+  zyppng::EventDispatcher::Ptr loop = zyppng::EventDispatcher::createMain( backend );
+  BOOST_REQUIRE_EQUAL( loop->backend(), backend );
+
+  zyppng::Timer::Ptr repeating = zyppng::Timer::create();
+  zyppng::Timer::Ptr single = zyppng::Timer::create();
+  single->setSingleShot( true );
+
+  int hitRepeating = 0;
+  int hitSingle = 0;
+  int executedIdle = 0;
+
+  repeating->sigExpired().connect( [ & ]( zyppng::Timer & ) {
+    hitRepeating++;
+    if ( hitRepeating >= 3 )
+      loop->quit();
+  });
+  single->sigExpired().connect( [ & ]( zyppng::Timer & ) {
+    hitSingle++;
+  });
+  zyppng::EventDispatcher::invokeOnIdle( [ &executedIdle ](){ executedIdle++; return false; } );
+
+  single->start( 2 );
+  repeating->start( 10 );
+  loop->run();
+
+  BOOST_REQUIRE_EQUAL( hitRepeating, 3 );
+  BOOST_REQUIRE_EQUAL( hitSingle, 1 );
+  BOOST_REQUIRE_EQUAL( executedIdle, 1 );
+  BOOST_REQUIRE_EQUAL( loop->runningTimers(), 1 );
+  repeating->stop();
+  BOOST_REQUIRE_EQUAL( loop->runningTimers(), 0 );
+}
+
+BOOST_DATA_TEST_CASE(backend_socketnotifier, bdata::make( allBackends ), backend)
+{
+  zyppng::EventDispatcher::Ptr loop = zyppng::EventDispatcher::createMain( backend );
+
+  int fds[2] = { -1, -1 };
+  BOOST_REQUIRE_EQUAL( ::pipe2( fds, O_NONBLOCK ), 0 );
+
+  std::string received;
+  zyppng::SocketNotifier::Ptr notifier = zyppng::SocketNotifier::create( fds[0], zyppng::SocketNotifier::Read );
+  notifier->sigActivated().connect( [ & ]( const zyppng::SocketNotifier &n, int ev ) {
+    BOOST_REQUIRE( ev & zyppng::SocketNotifier::Read );
+    char c;
+    while ( ::read( n.socket(), &c, 1 ) > 0 )
+      received.push_back( c );
+    if ( received == "zypp" ) {
+      notifier->setEnabled( false );
+      loop->quit();
+    }
+  });
+
+  zyppng::Timer::Ptr writer = zyppng::Timer::create();
+  writer->setSingleShot( true );
+  writer->sigExpired().connect( [ & ]( zyppng::Timer & ) {
+    BOOST_REQUIRE_EQUAL( ::write( fds[1], "zypp", 4 ), 4 );
+  });
+  writer->start( 5 );
+
+  loop->run();
+  BOOST_REQUIRE_EQUAL( received, "zypp" );
+
+  ::close( fds[0] );
+  ::close( fds[1] );
+}
@@ -0,0 +1,520 @@
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include <zypp/base/LogTools.h>
+#include <zypp/base/String.h>
+#include <zypp/base/Errno.h>
+#include <zypp/base/WatchFile.h>
+#include <zypp/misc/DefaultLoadSystem.h>
+#include <zypp/ZYppFactory.h>
+#include <zypp/RepoManager.h>
+#include <zypp/ResPool.h>
+#include <zypp/PoolQuery.h>
+#include <zypp/Resolver.h>
+#include <zypp/ResolverProblem.h>
+#include <zypp/Target.h>
+#include <zypp/sat/Pool.h>
+#include <zypp/sat/WhatProvides.h>
+#include <zypp/ui/Selectable.h>
+
+#include <zypp/zyppng/base/EventDispatcher>
+#include <zypp/zyppng/base/SocketNotifier>
+#include <zypp/zyppng/base/Timer>
+
+#include "argparse.h"
+
+using std::cout;
+using std::cerr;
+using std::endl;
+using namespace zypp;
+
+static std::string appname { "NO_NAME" };
+
+int errexit( const std::string & msg_r = std::string(), int exit_r = 100 )
+{
+  if ( ! msg_r.empty() )
+    cerr << endl << appname << ": ERR: " << msg_r << endl << endl;
+  return exit_r;
+}
+
+int usage( const argparse::Options & options_r, int return_r = 0 )
+{
+  cerr << "USAGE: " << appname << " [OPTION]..." << endl;
+  cerr << "    Load the system and its cached repos into the pool once and serve" << endl;
+  cerr << "    queries and solver requests over a local socket. Changed solv caches" << endl;
+  cerr << "    (including rpm database changes) are picked up while running." << endl;
+  cerr << "    The daemon is readonly; it never takes the zypp lock nor commits." << endl;
+  cerr << "    Only root and the user running the daemon may connect." << endl;
+  cerr << endl;
+  cerr << "    The protocol is line based. Each request is answered by zero or more" << endl;
+  cerr << "    result lines, followed by 'OK' or 'ERR <message>':" << endl;
+  cerr << "      search GLOB            - solvables whose name matches GLOB" << endl;
+  cerr << "      whatprovides CAP       - solvables providing CAP" << endl;
+  cerr << "      solve [install|remove] NAME... - resolve and print the transaction" << endl;
+  cerr << "                               (+ install, - remove) or the problems" << endl;
+  cerr << "      reload                 - check for changed repos and rpmdb now" << endl;
+  cerr << "      stats                  - repos and solvables in the pool" << endl;
+  cerr << "    Result lines are TAB separated: KIND NAME EDITION ARCH REPO" << endl;
+  cerr << options_r << endl;
+  return return_r;
+}
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  /** The pool we serve and what is needed to keep it up to date.
+   *
+   * Changes are detected by watching the solv cache cookies, which are
+   * rewritten whenever a solv file is rebuilt, and the repo files.
+   */
+  class PoolState
+  {
+  public:
+    PoolState( const Pathname & root_r )
+    : _root( root_r )
+    , _options( _root )
+    {
+      misc::defaultLoadSystem( _root, misc::LS_READONLY | misc::LS_NOREFRESH );
+      _system = WatchFile( systemCookie() );
+      _reposd = WatchFile( _options.knownReposPath, WatchFile::NO_INIT );
+      checkRepos();	// remember the loaded repos cookies
+      MIL << "Serving " << sat::Pool::instance().reposSize() << " repos, " << sat::Pool::instance().solvablesSize() << " solvables" << endl;
+    }
+
+    /** Reload what changed since the last check.
+     * On error the current pool is kept and the error message is returned
+     * (e.g. the rpmdb is locked or rebuilt, a repo file is unreadable).
+     * It is retried on the next check.
+     */
+    std::string reload()
+    {
+      std::string error;
+      try
+      {
+	checkSystem();
+      }
+      catch ( const Exception & excpt )
+      {
+	ZYPP_CAUGHT( excpt );
+	_system = WatchFile( _system.path(), WatchFile::NO_INIT );
+	error = excpt.asUserString();
+      }
+      try
+      {
+	checkRepos();
+      }
+      catch ( const Exception & excpt )
+      {
+	ZYPP_CAUGHT( excpt );
+	_reposd = WatchFile( _reposd.path(), WatchFile::NO_INIT );
+	if ( error.empty() )
+	  error = excpt.asUserString();
+      }
+      return error;
+    }
+
+  private:
+    /** The cookie the target writes: the one in the solv cache or, if that's
+     * not writable (non-root), the temporary one \ref Target::buildCache falls
+     * back to.
+     */
+    Pathname systemCookie() const
+    {
+      Pathname tmpcookie { getZYpp()->tmpPath() / sat::Pool::systemRepoAlias() / "cookie" };
+      if ( PathInfo( tmpcookie ).isFile() )
+	return tmpcookie;
+      return _options.repoSolvCachePath / sat::Pool::systemRepoAlias() / "cookie";
+    }
+
+    /** Let the target rebuild its solv file if the rpmdb changed; reload if it did. */
+    void checkSystem()
+    {
+      Target_Ptr target { getZYpp()->target() };
+      target->buildCache();	// cheap if the cookie matches the rpmdb state
+      Pathname cookie { systemCookie() };
+      if ( cookie != _system.path() )
+      {
+	MIL << "System solv cookie moved to " << cookie << endl;
+	_system = WatchFile( cookie, WatchFile::NO_INIT );
+      }
+      if ( _system.hasChanged() )
+      {
+	MIL << "System solv cookie changed, reload " << Repository::systemRepoAlias() << endl;
+	target->load();
+      }
+    }
+
+    /** Reload repos whose solv cookie changed, add new and drop vanished ones.
+     * The repo files are reread only if the repos dir changed.
+     */
+    void checkRepos()
+    {
+      if ( _reposd.hasChanged() )
+      {
+	_known.clear();
+	RepoManager repoManager( _options );
+	for ( const RepoInfo & info : repoManager.knownRepositories() )
+	{
+	  if ( info.enabled() )
+	    _known.push_back( info );
+	}
+      }
+
+      std::map<std::string,WatchFile> seen;
+      for ( const RepoInfo & info : _known )
+      {
+	Pathname cookie { _options.repoSolvCachePath / info.escaped_alias() / "cookie" };
+	auto it = _repos.find( info.alias() );
+	if ( it != _repos.end() && ! it->second.hasChanged() )
+	{
+	  seen[info.alias()] = it->second;
+	  continue;
+	}
+	if ( ! PathInfo( cookie ).isFile() )
+	  continue;	// not cached
+	if ( it == _repos.end() && sat::Pool::instance().reposFind( info.alias() ) )
+	{
+	  seen[info.alias()] = WatchFile( cookie );	// loaded by defaultLoadSystem
+	  continue;
+	}
+
+	MIL << "Reload repo " << info.alias() << endl;
+	try
+	{
+	  RepoManager( _options ).loadFromCache( info );
+	}
+	catch ( const Exception & excpt )
+	{
+	  ZYPP_CAUGHT( excpt );
+	  continue;	// try again next time
+	}
+	seen[info.alias()] = WatchFile( cookie );	// after loadFromCache, which may rebuild the cache
+      }
+
+      for ( const auto & repo : _repos )
+      {
+	if ( ! seen.count( repo.first ) )
+	{
+	  MIL << "Drop repo " << repo.first << endl;
+	  sat::Pool::instance().reposErase( repo.first );
+	}
+      }
+      _repos.swap( seen );
+    }
+
+  private:
+    Pathname _root;
+    RepoManagerOptions _options;
+    WatchFile _system;				// the system solv cookie
+    WatchFile _reposd;				// the repo files dir
+    std::list<RepoInfo> _known;			// the enabled repos
+    std::map<std::string,WatchFile> _repos;	// solv cookies of the loaded repos
+  };
+
+  inline std::ostream & dumpSolvable( std::ostream & str, const sat::Solvable & solv_r )
+  {
+    return str << solv_r.kind() << '\t' << solv_r.name() << '\t' << solv_r.edition() << '\t' << solv_r.arch() << '\t' << solv_r.repository().alias() << '\n';
+  }
+
+  /** Execute one request line and return the answer. */
+  std::string execute( PoolState & state_r, const std::string & line_r )
+  {
+    std::vector<std::string> words;
+    str::splitEscaped( line_r, std::back_inserter( words ) );
+    if ( words.empty() )
+      return "ERR empty request\n";
+
+    str::Str ret;
+    const std::string & cmd { words[0] };
+    if ( cmd == "search" && words.size() == 2 )
+    {
+      PoolQuery q;
+      q.addAttribute( sat::SolvAttr::name, words[1] );
+      q.setMatchGlob();
+      for ( const sat::Solvable & solv : q )
+	dumpSolvable( ret.stream(), solv );
+    }
+    else if ( cmd == "whatprovides" && words.size() == 2 )
+    {
+      for ( const sat::Solvable & solv : sat::WhatProvides( Capability( words[1] ) ) )
+	dumpSolvable( ret.stream(), solv );
+    }
+    else if ( cmd == "solve" && words.size() > 1 )
+    {
+      bool install = true;
+      std::string error;
+      for ( auto it = words.begin() + 1; it != words.end() && error.empty(); ++it )
+      {
+	if ( *it == "install" || *it == "remove" )
+	{
+	  install = ( *it == "install" );
+	  continue;
+	}
+	ui::Selectable::Ptr sel { ui::Selectable::get( *it ) };
+	if ( ! sel )
+	  error = "not found: " + *it;
+	else if ( ! ( install ? sel->setToInstall() : sel->setToDelete() ) )
+	  error = "can't " + std::string( install ? "install " : "remove " ) + *it;
+      }
+
+      if ( error.empty() )
+      {
+	Resolver & resolver { *getZYpp()->resolver() };
+	if ( resolver.resolvePool() )
+	{
+	  for ( const PoolItem & pi : ResPool::instance() )
+	  {
+	    if ( pi.status().transacts() )
+	      dumpSolvable( ret.stream() << ( pi.status().isToBeInstalled() ? "+\t" : "-\t" ), pi.satSolvable() );
+	  }
+	}
+	else
+	{
+	  for ( const ResolverProblem_Ptr & problem : resolver.problems() )
+	    ret << "problem\t" << problem->description() << '\n';
+	}
+      }
+
+      // leave the pool untouched for the next request
+      for ( const PoolItem & pi : ResPool::instance() )
+	pi.statusReset();
+
+      if ( ! error.empty() )
+	return "ERR " + error + "\n";
+    }
+    else if ( cmd == "reload" && words.size() == 1 )
+    {
+      std::string error { state_r.reload() };
+      if ( ! error.empty() )
+	return "ERR " + str::gsub( error, "\n", " " ) + "\n";
+    }
+    else if ( cmd == "stats" && words.size() == 1 )
+    {
+      const sat::Pool & satpool { sat::Pool::instance() };
+      ret << "repos\t" << satpool.reposSize() << '\n';
+      ret << "solvables\t" << satpool.solvablesSize() << '\n';
+    }
+    else
+      return "ERR bad request: " + line_r + "\n";
+
+    return ret.str() + "OK\n";
+  }
+
+  /** A connected client. Requests are read line by line and answered in order. */
+  struct Client
+  {
+    int _fd = -1;
+    zyppng::SocketNotifier::Ptr _notifier;
+    std::string _in;
+    std::string _out;
+    bool _eof = false;
+
+    ~Client()
+    { if ( _fd >= 0 ) ::close( _fd ); }
+  };
+
+  /** Accepts clients on a unix socket and runs their requests on the event loop. */
+  class Server
+  {
+  public:
+    Server( PoolState & state_r, const Pathname & socket_r, unsigned interval_r )
+    : _state( state_r )
+    , _socket( socket_r )
+    , _ev( zyppng::EventDispatcher::createMain() )
+    {
+      _listenFd = ::socket( AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0 );
+      if ( _listenFd < 0 )
+	ZYPP_THROW( Exception( str::Str() << "socket: " << Errno() ) );
+
+      sockaddr_un addr;
+      ::memset( &addr, 0, sizeof(addr) );
+      addr.sun_family = AF_UNIX;
+      if ( _socket.asString().size() >= sizeof(addr.sun_path) )
+	ZYPP_THROW( Exception( "Socket path too long: " + _socket.asString() ) );
+      ::strcpy( addr.sun_path, _socket.c_str() );
+      ::unlink( _socket.c_str() );	// a stale socket of a previous run
+      mode_t omask = ::umask( 0077 );	// the socket is for our own user only (0600)
+      int ret = ::bind( _listenFd, (sockaddr *)&addr, sizeof(addr) );
+      ::umask( omask );
+      if ( ret != 0 || ::listen( _listenFd, SOMAXCONN ) != 0 )
+	ZYPP_THROW( Exception( str::Str() << "bind " << _socket << ": " << Errno() ) );
+
+      _listener = zyppng::SocketNotifier::create( _listenFd, zyppng::SocketNotifier::Read );
+      _listener->sigActivated().connect( [this]( const zyppng::SocketNotifier &, int ) { accept(); } );
+
+      // SIGINT and SIGTERM end the loop
+      sigset_t mask;
+      ::sigemptyset( &mask );
+      ::sigaddset( &mask, SIGINT );
+      ::sigaddset( &mask, SIGTERM );
+      ::sigprocmask( SIG_BLOCK, &mask, nullptr );
+      _signalFd = ::signalfd( -1, &mask, SFD_NONBLOCK | SFD_CLOEXEC );
+      _signals = zyppng::SocketNotifier::create( _signalFd, zyppng::SocketNotifier::Read );
+      _signals->sigActivated().connect( [this]( const zyppng::SocketNotifier &, int ) {
+	MIL << "Got signal, quit" << endl;
+	_ev->quit();
+      } );
+
+      _timer = zyppng::Timer::create();
+      _timer->setSingleShot( false );
+      _timer->sigExpired().connect( [this]( zyppng::Timer & ) { _state.reload(); } );	// errors are logged, the pool is kept
+      _timer->start( interval_r * 1000 );
+    }
+
+    ~Server()
+    {
+      _clients.clear();
+      if ( _signalFd >= 0 )
+	::close( _signalFd );
+      if ( _listenFd >= 0 )
+      {
+	::close( _listenFd );
+	::unlink( _socket.c_str() );
+      }
+    }
+
+    void run()
+    {
+      MIL << "Listening on " << _socket << endl;
+      _ev->run();
+    }
+
+  private:
+    void accept()
+    {
+      int fd;
+      while ( ( fd = ::accept4( _listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC ) ) >= 0 )
+      {
+	// Don't rely on the socket permissions alone: only root and our own user are served.
+	ucred cred;
+	socklen_t len = sizeof(cred);
+	if ( ::getsockopt( fd, SOL_SOCKET, SO_PEERCRED, &cred, &len ) != 0 || ( cred.uid != 0 && cred.uid != ::geteuid() ) )
+	{
+	  WAR << "Reject client " << fd << " (uid " << ( len == sizeof(cred) ? cred.uid : -1 ) << ")" << endl;
+	  ::close( fd );
+	  continue;
+	}
+
+	auto client = std::make_shared<Client>();
+	client->_fd = fd;
+	client->_notifier = zyppng::SocketNotifier::create( fd, zyppng::SocketNotifier::Read );
+	client->_notifier->sigActivated().connect( [this,fd]( const zyppng::SocketNotifier &, int events_r ) { handle( fd, events_r ); } );
+	_clients[fd] = client;
+	DBG << "Client " << fd << " connected" << endl;
+      }
+    }
+
+    void handle( int fd_r, int events_r )
+    {
+      auto it = _clients.find( fd_r );
+      if ( it == _clients.end() )
+	return;
+      Client & client { *it->second };
+
+      if ( events_r & zyppng::SocketNotifier::Read )
+      {
+	char buf[4096];
+	ssize_t got;
+	while ( ( got = ::read( fd_r, buf, sizeof(buf) ) ) > 0 )
+	  client._in.append( buf, got );
+	if ( got == 0 || ( got < 0 && errno != EAGAIN && errno != EINTR ) )
+	  client._eof = true;
+
+	std::string::size_type nl;
+	while ( ( nl = client._in.find( '\n' ) ) != std::string::npos )
+	{
+	  std::string line { str::trim( client._in.substr( 0, nl ) ) };
+	  client._in.erase( 0, nl + 1 );
+	  if ( ! line.empty() )
+	    client._out += execute( _state, line );
+	}
+      }
+
+      while ( ! client._out.empty() )
+      {
+	ssize_t put = ::write( fd_r, client._out.data(), client._out.size() );
+	if ( put < 0 )
+	{
+	  if ( errno == EAGAIN || errno == EINTR )
+	    break;
+	  client._eof = true;
+	  client._out.clear();
+	  break;
+	}
+	client._out.erase( 0, put );
+      }
+
+      if ( client._eof && client._out.empty() )
+      {
+	DBG << "Client " << fd_r << " disconnected" << endl;
+	client._notifier->setEnabled( false );
+	zyppng::EventDispatcher::unrefLater( it->second );
+	_clients.erase( it );
+	return;
+      }
+      // wait for the socket to drain before reading more requests
+      client._notifier->setMode( client._out.empty() ? zyppng::SocketNotifier::Read : zyppng::SocketNotifier::Write );
+    }
+
+  private:
+    PoolState & _state;
+    Pathname _socket;
+    zyppng::EventDispatcher::Ptr _ev;
+    int _listenFd = -1;
+    int _signalFd = -1;
+    zyppng::SocketNotifier::Ptr _listener;
+    zyppng::SocketNotifier::Ptr _signals;
+    zyppng::Timer::Ptr _timer;
+    std::map<int,std::shared_ptr<Client>> _clients;
+  };
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+int main( int argc, char * argv[] )
+{
+  appname = Pathname::basename( argv[0] );
+
+  argparse::Options options;
+  options.add()
+    ( "help,h",		"Print help and exit." )
+    ( "root",		"Serve the system below ROOT (default /).", argparse::Option::Arg::required )
+    ( "socket",		"Listen on SOCKET (default /run/zypp-daemon.sock).", argparse::Option::Arg::required )
+    ( "interval",	"Check for changed repos and rpmdb every INTERVAL seconds (default 5).", argparse::Option::Arg::required )
+    ;
+  auto result = options.parse( argc, argv );
+
+  if ( result.count( "help" ) || ! result.positionals().empty() )
+    return usage( options, result.count( "help" ) ? 0 : 100 );
+
+  Pathname root { result.count( "root" ) ? result["root"].arg() : "/" };
+  Pathname socket { result.count( "socket" ) ? result["socket"].arg() : "/run/zypp-daemon.sock" };
+  unsigned interval = 5;
+  if ( result.count( "interval" ) )
+    interval = std::max( 1U, str::strtonum<unsigned>( result["interval"].arg() ) );
+
+  try
+  {
+    PoolState state( root );
+    Server server( state, socket, interval );
+    server.run();
+  }
+  catch ( const Exception & excpt )
+  {
+    return errexit( excpt.asUserHistory() );
+  }
+  return 0;
+}
@@ -0,0 +1,140 @@
+#define INCLUDE_TESTSETUP_WITHOUT_BOOST
+#include "../tests/lib/TestSetup.h"
+#undef  INCLUDE_TESTSETUP_WITHOUT_BOOST
+#include "argparse.h"
+
+#include <iostream>
+#include <set>
+
+#include <zypp/pool/PoolMemoryStats.h>
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+static std::string appname { "NO_NAME" };
+
+int errexit( const std::string & msg_r = std::string(), int exit_r = 100 )
+{
+  if ( ! msg_r.empty() )
+    cerr << endl << appname << ": ERR: " << msg_r << endl << endl;
+  return exit_r;
+}
+
+int usage( const argparse::Options & options_r, int return_r = 0 )
+{
+  cerr << "USAGE: " << appname << " [OPTION]... [ALIAS]..." << endl;
+  cerr << "    Load the target and the enabled repositories (no refresh) and print" << endl;
+  cerr << "    the memory used by the pool: string space, relations, solvables," << endl;
+  cerr << "    whatprovides index, repodata per repo and the ResPool store." << endl;
+  cerr << "    If ALIAS is given, only these repositories are loaded. If ROOTDIR" << endl;
+  cerr << "    denotes a solver testcase, the testcase is loaded." << endl;
+  cerr << options_r << endl;
+  return return_r;
+}
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  /** Print the growth of the pool after each step. */
+  struct StepReport
+  {
+    StepReport( bool verbose_r )
+    : _verbose( verbose_r )
+    {}
+
+    void operator()( const std::string & step_r )
+    {
+      ByteCount now { pool::PoolMemoryStats().total() };
+      if ( _verbose )
+        cout << "*** " << step_r << ": +" << ByteCount( now - _last ) << " (" << now << ")" << endl;
+      _last = now;
+    }
+
+    bool _verbose;
+    ByteCount _last;
+  };
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+int main( int argc, char * argv[] )
+{
+  appname = Pathname::basename( argv[0] );
+
+  argparse::Options options;
+  options.add()
+    ( "help,h",		"Print help and exit." )
+    ( "root",		"Load repos from the system located below ROOTDIR.", argparse::Option::Arg::required )
+    ( "no-target",	"Don't load the installed packages." )
+    ( "no-prepare",	"Don't build the whatprovides index." )
+    ( "steps",		"Print the growth of the pool after each loaded repo." )
+    ;
+  auto result = options.parse( argc, argv );
+
+  if ( result.count( "help" ) )
+    return usage( options );
+
+  Pathname sysRoot( "/" );
+  if ( result.count( "root" ) )
+  {
+    sysRoot = result["root"].arg();
+    if ( ! PathInfo( sysRoot ).isDir() )
+      return errexit( "--root requires a directory." );
+  }
+  std::set<std::string> aliases( result.positionals().begin(), result.positionals().end() );
+
+  // keep the logs out of the measurement
+  base::LogControl::instance().logNothing();
+
+  ZConfig::instance();
+  sat::Pool satpool( sat::Pool::instance() );
+  StepReport step( result.count( "steps" ) );
+  step( "empty pool" );
+
+  try
+  {
+    if ( TestSetup::isTestcase( sysRoot ) )
+    {
+      TestSetup test;
+      test.loadTestcaseRepos( sysRoot );
+      step( "testcase " + sysRoot.asString() );
+    }
+    else
+    {
+      if ( ! result.count( "no-target" ) )
+      {
+        getZYpp()->initializeTarget( sysRoot );
+        getZYpp()->target()->load();
+        step( Repository::systemRepoAlias() );
+      }
+
+      RepoManager repoManager( sysRoot );
+      RepoInfoList repos = repoManager.knownRepositories();
+      for ( RepoInfo & nrepo : repos )
+      {
+        if ( aliases.empty() ? ! nrepo.enabled() : ! aliases.count( nrepo.alias() ) )
+          continue;
+
+        if ( ! repoManager.isCached( nrepo ) )
+        {
+          cerr << "*** omit uncached repo '" << nrepo.alias() << "' (do 'zypper refresh')" << endl;
+          continue;
+        }
+        repoManager.loadFromCache( nrepo );
+        step( nrepo.alias() );
+      }
+    }
+  }
+  catch ( const Exception & excpt )
+  {
+    return errexit( excpt.asUserHistory(), 2 );
+  }
+
+  if ( ! result.count( "no-prepare" ) )
+  {
+    satpool.prepare();
+    step( "whatprovides" );
+  }
+  cout << pool::PoolMemoryStats( true ) << endl;	// the ResPool once, after loading
+  return 0;
+}
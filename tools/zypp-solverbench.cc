@@ -0,0 +1,308 @@
+#define INCLUDE_TESTSETUP_WITHOUT_BOOST
+#include "../tests/lib/TestSetup.h"
+#undef  INCLUDE_TESTSETUP_WITHOUT_BOOST
+#include "argparse.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#define ZYPP_USE_RESOLVER_INTERNALS
+#include <zypp/solver/detail/Resolver.h>
+#include <zypp/solver/detail/SATResolver.h>
+#include <zypp/ResolverFocus.h>
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+typedef std::chrono::steady_clock Clock;
+
+static std::string appname { "NO_NAME" };
+
+int errexit( const std::string & msg_r = std::string(), int exit_r = 100 )
+{
+  if ( ! msg_r.empty() )
+    cerr << endl << appname << ": ERR: " << msg_r << endl << endl;
+  return exit_r;
+}
+
+int usage( const argparse::Options & options_r, int return_r = 0 )
+{
+  cerr << "USAGE: " << appname << " [OPTION]... TESTCASE..." << endl;
+  cerr << "    Replay solver testcases (as written by 'zypper -x --debug-solver')" << endl;
+  cerr << "    and print the time spent in each solver phase. A TESTCASE directory" << endl;
+  cerr << "    not containing a solver-test.xml is scanned for testcase subdirectories." << endl;
+  cerr << "    One JSON object per testcase and run is written to stdout:" << endl;
+  cerr << "      load      - loading the testcase repos into the pool" << endl;
+  cerr << "      prepare   - sat::Pool::prepare (whatprovides), 0 if still valid" << endl;
+  cerr << "      init      - SATResolver::solverInit and building the job queue" << endl;
+  cerr << "      solve     - solver_solve" << endl;
+  cerr << "      topool    - SATSolutionToPool, copying the result back to the pool" << endl;
+  cerr << "      total     - the whole solver call" << endl;
+  cerr << "    All times are in milliseconds." << endl;
+  cerr << options_r << endl;
+  return return_r;
+}
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  inline double ms( Clock::duration d_r )
+  { return std::chrono::duration<double,std::milli>( d_r ).count(); }
+
+  inline std::string jsonString( const std::string & val_r )
+  {
+    std::string ret { "\"" };
+    for ( char ch : val_r )
+    {
+      if ( ch == '"' || ch == '\\' )
+	ret += '\\';
+      ret += ch;
+    }
+    return ret += "\"";
+  }
+
+  /** The trial part of a testcase (what the solver was asked to do). */
+  struct Trial
+  {
+    enum Mode { RESOLVE, UPGRADE, UPDATE, VERIFY };
+    Mode _mode = RESOLVE;
+    std::map<std::string,bool> _flags;		// <setup> tags; unset tags are false
+    std::string _focus;
+    std::vector<std::pair<std::string,std::string>> _items;	// action and raw line
+    CapabilitySet _requires;
+    CapabilitySet _conflicts;
+    std::vector<std::string> _upgradeRepos;
+
+    bool flag( const std::string & name_r ) const
+    { auto it = _flags.find( name_r ); return it != _flags.end() && it->second; }
+
+    /** Dumb parse, like \ref TestSetup::loadTestcaseRepos. */
+    explicit Trial( const Pathname & testcase_r )
+    {
+      InputStream infile( testcase_r / "solver-test.xml" );
+      for( iostr::EachLine in( infile ); in; in.next() )
+      {
+	std::string line { str::trim( *in ) };
+	if ( line.empty() || line[0] != '<' )
+	  continue;
+	std::string tag { line.substr( 1, line.find_first_of( " /", 1 ) - 1 ) };
+
+	if ( tag == "focus" )
+	  _focus = getXmlNodeVal( line, "value" );
+	else if ( tag == "install" || tag == "uninstall" || tag == "lock" || tag == "keep" )
+	  _items.push_back( { tag, line } );
+	else if ( tag == "addRequire" )
+	  _requires.insert( Capability( getXmlNodeVal( line, "name" ) ) );
+	else if ( tag == "addConflict" )
+	  _conflicts.insert( Capability( getXmlNodeVal( line, "name" ) ) );
+	else if ( tag == "upgradeRepo" )
+	  _upgradeRepos.push_back( getXmlNodeVal( line, "name" ) );
+	else if ( tag == "distupgrade" )
+	  _mode = UPGRADE;
+	else if ( tag == "update" )
+	  _mode = UPDATE;
+	else if ( tag == "verify" )
+	  _mode = VERIFY;
+	else if ( str::endsWith( line, "/>" ) )
+	  _flags[tag] = true;
+      }
+    }
+
+    /** Find the PoolItem an install/lock/keep line refers to. */
+    static PoolItem findItem( const std::string & line_r )
+    {
+      ResPool pool { ResPool::instance() };
+      ResKind kind { getXmlNodeVal( line_r, "kind" ) };
+      std::string name { getXmlNodeVal( line_r, "name" ) };
+      std::string channel { getXmlNodeVal( line_r, "channel" ) };
+      Arch arch { getXmlNodeVal( line_r, "arch" ) };
+      Edition edition { getXmlNodeVal( line_r, "version" ), getXmlNodeVal( line_r, "release" ) };
+
+      for_( it, pool.byIdentBegin( kind, name ), pool.byIdentEnd( kind, name ) )
+      {
+	const PoolItem & pi { *it };
+	if ( pi.arch() == arch && pi.edition() == edition && pi.repoInfo().alias() == channel )
+	  return pi;
+      }
+      return PoolItem();
+    }
+
+    /** Set the pool items status and the resolver options. */
+    void apply( solver::detail::Resolver & resolver_r ) const
+    {
+      ResPool pool { ResPool::instance() };
+      for ( const PoolItem & pi : pool )
+	pi.statusReset();
+
+      for ( const auto & item : _items )
+      {
+	if ( item.first == "uninstall" )
+	{
+	  ResKind kind { getXmlNodeVal( item.second, "kind" ) };
+	  std::string name { getXmlNodeVal( item.second, "name" ) };
+	  for_( it, pool.byIdentBegin( kind, name ), pool.byIdentEnd( kind, name ) )
+	  {
+	    if ( it->status().isInstalled() )
+	      it->status().setToBeUninstalled( ResStatus::USER );
+	  }
+	  continue;
+	}
+
+	PoolItem pi { findItem( item.second ) };
+	if ( ! pi )
+	{
+	  cerr << "Not in pool: " << item.second << endl;
+	  continue;
+	}
+	if ( item.first == "install" )
+	  pi.status().setToBeInstalled( ResStatus::USER );
+	else if ( item.first == "lock" )
+	  pi.status().setLock( true, ResStatus::USER );
+	else /* keep */
+	  pi.status().setTransactValue( ResStatus::KEEP_STATE, ResStatus::USER );
+      }
+
+      resolver_r.reset();
+      if ( ! _focus.empty() )
+	resolver_r.setFocus( resolverFocusFromString( _focus ) );
+      resolver_r.setOnlyRequires( flag( "onlyRequires" ) );
+      resolver_r.setIgnoreAlreadyRecommended( flag( "ignorealreadyrecommended" ) );
+      resolver_r.setForceResolve( flag( "forceResolve" ) );
+      resolver_r.setCleandepsOnRemove( flag( "cleandepsOnRemove" ) );
+      resolver_r.setAllowDowngrade( flag( "allowDowngrade" ) );
+      resolver_r.setAllowNameChange( flag( "allowNameChange" ) );
+      resolver_r.setAllowArchChange( flag( "allowArchChange" ) );
+      resolver_r.setAllowVendorChange( flag( "allowVendorChange" ) );
+      resolver_r.dupSetAllowDowngrade( flag( "dupAllowDowngrade" ) );
+      resolver_r.dupSetAllowNameChange( flag( "dupAllowNameChange" ) );
+      resolver_r.dupSetAllowArchChange( flag( "dupAllowArchChange" ) );
+      resolver_r.dupSetAllowVendorChange( flag( "dupAllowVendorChange" ) );
+
+      for ( const Capability & cap : _requires )
+	resolver_r.addExtraRequire( cap );
+      for ( const Capability & cap : _conflicts )
+	resolver_r.addExtraConflict( cap );
+      for ( const std::string & alias : _upgradeRepos )
+	resolver_r.addUpgradeRepo( sat::Pool::instance().reposFind( alias ) );
+    }
+
+    /** Run the solver, return whether it succeeded. */
+    bool run( solver::detail::Resolver & resolver_r ) const
+    {
+      switch ( _mode )
+      {
+	case UPGRADE:	return resolver_r.doUpgrade();
+	case UPDATE:	resolver_r.doUpdate(); return true;
+	case VERIFY:	return resolver_r.verifySystem();
+	case RESOLVE:	break;
+      }
+      return resolver_r.resolvePool();
+    }
+  };
+
+  /** Collect the testcase directories at or below \a path_r. */
+  void collectTestcases( const Pathname & path_r, std::vector<Pathname> & testcases_r )
+  {
+    if ( TestSetup::isTestcase( path_r ) )
+    {
+      testcases_r.push_back( path_r );
+      return;
+    }
+    std::vector<Pathname> found;
+    filesystem::Glob::collect( path_r/"*/solver-test.xml", std::back_inserter( found ) );
+    for ( const Pathname & file : found )
+      testcases_r.push_back( file.dirname() );
+  }
+
+  int benchTestcase( const Pathname & testcase_r, unsigned runs_r )
+  {
+    Clock::time_point start { Clock::now() };
+    TestSetup test;
+    test.loadTestcaseRepos( testcase_r );
+    Clock::duration load { Clock::now() - start };
+
+    Trial trial( testcase_r );
+    solver::detail::Resolver resolver( ResPool::instance() );
+
+    int ret = 0;
+    for ( unsigned run = 1; run <= runs_r; ++run )
+    {
+      trial.apply( resolver );
+
+      start = Clock::now();
+      bool success = trial.run( resolver );
+      Clock::duration total { Clock::now() - start };
+
+      const solver::detail::SATResolver::PhaseTimes & phases { resolver.satResolver().phaseTimes() };
+      cout << "{"
+	   << "\"testcase\": " << jsonString( testcase_r.asString() )
+	   << ", \"run\": " << run
+	   << ", \"solvables\": " << sat::Pool::instance().solvablesSize()
+	   << ", \"success\": " << ( success ? "true" : "false" )
+	   << ", \"problems\": " << ( success ? 0 : resolver.problems().size() )
+	   << ", \"load\": " << ( run == 1 ? ms( load ) : 0.0 )
+	   << ", \"prepare\": " << ms( phases._prepare )
+	   << ", \"init\": " << ms( phases._solverInit )
+	   << ", \"solve\": " << ms( phases._solve )
+	   << ", \"topool\": " << ms( phases._toPool )
+	   << ", \"total\": " << ms( total )
+	   << "}" << endl;
+
+      if ( ! success )
+	ret = 1;
+    }
+    return ret;
+  }
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+int main( int argc, char * argv[] )
+{
+  appname = Pathname::basename( argv[0] );
+
+  argparse::Options options;
+  options.add()
+    ( "help,h",	"Print help and exit." )
+    ( "runs",	"Solve each testcase RUNS times (default 1). Later runs show the cost of re-solving an unchanged pool.", argparse::Option::Arg::required )
+    ;
+  auto result = options.parse( argc, argv );
+
+  if ( result.count( "help" ) || result.positionals().empty() )
+    return usage( options, result.count( "help" ) ? 0 : 100 );
+
+  unsigned runs = 1;
+  if ( result.count( "runs" ) )
+    runs = std::max( 1U, str::strtonum<unsigned>( result["runs"].arg() ) );
+
+  std::vector<Pathname> testcases;
+  for ( const std::string & arg : result.positionals() )
+  {
+    if ( ! PathInfo( arg ).isDir() )
+      return errexit( "Not a directory: " + arg );
+    collectTestcases( arg, testcases );
+  }
+  if ( testcases.empty() )
+    return errexit( "No solver testcases found." );
+
+  // the solver is chatty; keep the logs out of the results
+  base::LogControl::instance().logNothing();
+
+  int ret = 0;
+  for ( const Pathname & testcase : testcases )
+  {
+    try
+    {
+      if ( benchTestcase( testcase, runs ) != 0 )
+	ret = 1;
+    }
+    catch ( const Exception & excpt )
+    {
+      cerr << testcase << ": " << excpt.asUserHistory() << endl;
+      ret = 2;
+    }
+  }
+  return ret;
+}
@@ -32,16 +32,16 @@ namespace zypp
   public:
     /** Default ctor */
     ChangelogEntry( const Date & d,
-                    const std::string & a,
-                    const std::string & t )
-    : _date( d ), _author( a ), _text( t )
+                    std::string a,
+                    std::string t )
+    : _date( d ), _author( std::move(a) ), _text( std::move(t) )
     {};
     /** Dtor */
     ~ChangelogEntry()
     {}
     Date date() const { return _date; }
-    std::string author() const { return _author; }
-    std::string text() const { return _text; }
+    const std::string & author() const { return _author; }
+    const std::string & text() const { return _text; }
 
   private:
     Date _date;
@@ -16,15 +16,18 @@ extern "C"
 
 #include <iostream>
 #include <fstream>
+#include <vector>
 
 #include <zypp/base/Easy.h>
 #include <zypp/base/LogTools.h>
 #include <zypp/base/DtorReset.h>
 #include <zypp/base/String.h>
+#include <zypp/base/SerialNumber.h>
 
 #include <zypp/DiskUsageCounter.h>
 #include <zypp/ExternalProgram.h>
 #include <zypp/sat/Pool.h>
+#include <zypp/sat/LookupAttr.h>
 #include <zypp/sat/detail/PoolImpl.h>
 
 using std::endl;
@@ -37,22 +40,32 @@ namespace zypp
   namespace
   { /////////////////////////////////////////////////////////////////
 
-    DiskUsageCounter::MountPointSet calcDiskUsage( DiskUsageCounter::MountPointSet result, const Bitmap & installedmap_r )
+    /** Package data size (in K) and number of files per mount point. */
+    struct DuSum
+    {
+      long long kbytes = 0;
+      long long files = 0;
+    };
+    typedef std::vector<DuSum> DuSums;
+
+    /** Let libsolv compute the disk usage changes caused by \a map_r.
+     * Unless \a regardInstalled_r, the @System repo is temp. unset, so the
+     * plain disk usage of the solvables in \a map_r is summed up.
+     */
+    DuSums calcDuChanges( const DiskUsageCounter::MountPointSet & mps_r, const Bitmap & map_r, bool regardInstalled_r = true )
     {
-      if ( result.empty() )
-      {
-        // partitioning is not set
-        return result;
-      }
-
       sat::Pool satpool( sat::Pool::instance() );
 
+      DtorReset tmp( satpool.get()->installed );
+      if ( ! regardInstalled_r )
+        satpool.get()->installed = nullptr;
+
       // init libsolv result vector with mountpoints
       static const ::DUChanges _initdu = { 0, 0, 0, 0 };
-      std::vector< ::DUChanges> duchanges( result.size(), _initdu );
+      std::vector< ::DUChanges> duchanges( mps_r.size(), _initdu );
       {
         unsigned idx = 0;
-        for_( it, result.begin(), result.end() )
+        for_( it, mps_r.begin(), mps_r.end() )
         {
           duchanges[idx].path = it->dir.c_str();
 	  if ( it->growonly )
@@ -62,47 +75,187 @@ namespace zypp
       }
       // now calc...
       ::pool_calc_duchanges( satpool.get(),
-                             const_cast<Bitmap &>(installedmap_r),
+                             const_cast<Bitmap &>(map_r),
                              &duchanges[0],
                              duchanges.size() );
 
-      // and process the result
+      DuSums ret( duchanges.size() );
+      for ( unsigned idx = 0; idx < duchanges.size(); ++idx )
       {
-        unsigned idx = 0;
-        for_( it, result.begin(), result.end() )
-        {
-	  // Limit estimated waste (half block per file) as it does not apply to
-	  // btrfs, which reports up to 64K blocksize (bsc#974275,bsc#965322)
-	  static const ByteCount blockAdjust( 2, ByteCount::K ); // (files * blocksize) / 2 / 1K; result value in K!
-
-          it->pkg_size = it->used_size          // current usage
-                       + duchanges[idx].kbytes  // package data size
-                       + ( duchanges[idx].files * ( it->fstype == "btrfs" ? 4096 : it->block_size ) / blockAdjust ); // half block per file
-          ++idx;
-        }
+        ret[idx].kbytes = duchanges[idx].kbytes;
+        ret[idx].files  = duchanges[idx].files;
       }
+      return ret;
+    }
 
+    /** Compute the MountPoint::pkg_size from the disk usage changes. */
+    DiskUsageCounter::MountPointSet applyDuChanges( DiskUsageCounter::MountPointSet result, const DuSums & du_r )
+    {
+      unsigned idx = 0;
+      for_( it, result.begin(), result.end() )
+      {
+	// Limit estimated waste (half block per file) as it does not apply to
+	// btrfs, which reports up to 64K blocksize (bsc#974275,bsc#965322)
+	static const ByteCount blockAdjust( 2, ByteCount::K ); // (files * blocksize) / 2 / 1K; result value in K!
+
+        it->pkg_size = it->used_size          // current usage
+                     + du_r[idx].kbytes       // package data size
+                     + ( du_r[idx].files * ( it->fstype == "btrfs" ? 4096 : it->block_size ) / blockAdjust ); // half block per file
+        ++idx;
+      }
       return result;
     }
 
+    DiskUsageCounter::MountPointSet calcDiskUsage( DiskUsageCounter::MountPointSet result, const Bitmap & installedmap_r )
+    {
+      if ( result.empty() )
+      {
+        // partitioning is not set
+        return result;
+      }
+      DuSums du { calcDuChanges( result, installedmap_r ) };
+      return applyDuChanges( std::move(result), du );
+    }
+
+    /** Whether libsolv knows the disk usage of \a solv_r. */
+    inline bool hasDiskusage( sat::Solvable solv_r )
+    { return ! sat::LookupAttr( sat::SolvAttr::diskusage, solv_r ).empty(); }
+
     /////////////////////////////////////////////////////////////////
   } // namespace
   ///////////////////////////////////////////////////////////////////
 
+  ///////////////////////////////////////////////////////////////////
+  /// \class DiskUsageCounter::Cache
+  /// \brief Disk usage changes computed by the last disk_usage( const ResPool & ).
+  ///
+  /// The changes computed by libsolv are the sum of the (signed) disk usage
+  /// of the solvables whose installed state changes. So if just a few
+  /// solvables changed their transact state since the last call, their disk
+  /// usage is added to or subtracted from the remembered sums, and the
+  /// (expensive) lookup of all the other solvables is saved.
+  ///
+  /// There's one exception to this: libsolv ignores the disk usage of
+  /// installed solvables which are replaced by a package providing no disk
+  /// usage data. As long as such a package is selected, a full computation
+  /// is done.
+  ///////////////////////////////////////////////////////////////////
+  struct DiskUsageCounter::Cache
+  {
+    /** Whether the remembered sums are valid for \a mps_r (depend on dir and growonly only). */
+    bool sameMountPoints( const MountPointSet & mps_r ) const
+    {
+      if ( _mps.size() != mps_r.size() )
+        return false;
+      for ( auto l = _mps.begin(), r = mps_r.begin(); l != _mps.end(); ++l, ++r )
+      {
+        if ( l->dir != r->dir || l->growonly != r->growonly )
+          return false;
+      }
+      return true;
+    }
+
+    MountPointSet	_mps;		///< mount points _du was computed for
+    SerialNumberWatcher	_poolSerial;	///< pool content _du was computed for
+    Bitmap		_map;		///< the installedmap _du was computed for
+    DuSums		_du;
+    unsigned		_noDu = 0;	///< number of not installed solvables in _map without disk usage data
+  };
+
   DiskUsageCounter::MountPointSet DiskUsageCounter::disk_usage( const ResPool & pool_r ) const
   {
-    Bitmap bitmap( Bitmap::poolSize );
+    if ( _mps.empty() )
+    {
+      // partitioning is not set
+      return _mps;
+    }
+
+    if ( ! _cache )
+      _cache.reset( new Cache );
+    Cache & cache( *_cache );
+
+    bool full = cache._poolSerial.remember( sat::Pool::instance().serial() );
+    if ( ! cache.sameMountPoints( _mps ) )
+    {
+      cache._mps = _mps;
+      full = true;
+    }
 
     // build installedmap (installed != transact)
     // stays installed or gets installed
+    static const unsigned maxIncremental = 1000;	// more changes are faster computed from scratch
+    std::vector<sat::Solvable> changed[2][2];		// [installed][added to map]
+    unsigned changes = 0;
+
+    if ( full )
+    {
+      cache._map = Bitmap( Bitmap::poolSize );
+      cache._noDu = 0;
+    }
+
     for_( it, pool_r.begin(), pool_r.end() )
     {
-      if ( it->status().isInstalled() != it->status().transacts() )
+      const ResStatus & status( it->status() );
+      bool inMap = ( status.isInstalled() != status.transacts() );
+      sat::Solvable solv { sat::asSolvable()(*it) };
+
+      if ( inMap == cache._map.test( solv.id() ) )
+        continue;
+
+      if ( inMap )
+        cache._map.set( solv.id() );
+      else
+        cache._map.clear( solv.id() );
+
+      if ( ! status.isInstalled() && ! hasDiskusage( solv ) )
       {
-        bitmap.set( sat::asSolvable()(*it).id() );
+        if ( inMap )
+          ++cache._noDu;
+        else
+          --cache._noDu;
       }
+
+      if ( ! full && ++changes <= maxIncremental )
+        changed[status.isInstalled()][inMap].push_back( solv );
     }
-    return calcDiskUsage( _mps, bitmap );
+
+    if ( full || changes > maxIncremental || cache._noDu )
+    {
+      DBG << "DU full computation (" << ( full ? "pool or mount points changed" : cache._noDu ? "packages without DU data" : "many changes" ) << ")" << endl;
+      cache._du = calcDuChanges( _mps, cache._map );
+    }
+    else if ( changes )
+    {
+      DBG << "DU update for " << changes << " changed solvables" << endl;
+      for ( unsigned installed : { 0, 1 } )
+      {
+        for ( unsigned added : { 0, 1 } )
+        {
+          const std::vector<sat::Solvable> & solvs { changed[installed][added] };
+          if ( solvs.empty() )
+            continue;
+
+          Bitmap bitmap( Bitmap::poolSize );
+          for ( sat::Solvable solv : solvs )
+            bitmap.set( solv.id() );
+          DuSums du { calcDuChanges( _mps, bitmap, /*regardInstalled*/false ) };
+
+          unsigned idx = 0;
+          for_( mp, _mps.begin(), _mps.end() )
+          {
+            // removing installed packages does not free space on growonly partitions
+            if ( ! ( installed && mp->growonly ) )
+            {
+              cache._du[idx].kbytes += ( added ? du[idx].kbytes : -du[idx].kbytes );
+              cache._du[idx].files  += ( added ? du[idx].files  : -du[idx].files );
+            }
+            ++idx;
+          }
+        }
+      }
+    }
+
+    return applyDuChanges( _mps, cache._du );
   }
 
   DiskUsageCounter::MountPointSet DiskUsageCounter::disk_usage( sat::Solvable solv_r ) const
@@ -15,6 +15,7 @@
 #include <set>
 #include <string>
 #include <iosfwd>
+#include <memory>
 
 #include <zypp/ResPool.h>
 #include <zypp/Bitmap.h>
@@ -179,7 +180,11 @@ namespace zypp
     static MountPointSet justRootPartition();
 
 
-    /** Compute disk usage if the current transaction woud be commited. */
+    /** Compute disk usage if the current transaction woud be commited.
+     * The counter remembers the last result and on subsequent calls only
+     * regards the solvables whose transact state changed since then. A full
+     * computation is done if the pool content or the mount points changed.
+     */
     MountPointSet disk_usage( const ResPool & pool ) const;
 
     /** Compute disk usage of a single Solvable */
@@ -206,6 +211,8 @@ namespace zypp
 
   private:
     MountPointSet _mps;
+    struct Cache;
+    mutable std::shared_ptr<Cache> _cache;	///< state of the last disk_usage( const ResPool & )
   };
   ///////////////////////////////////////////////////////////////////
 
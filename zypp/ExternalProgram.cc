@@ -19,16 +19,21 @@
 #include <pty.h> // openpty
 #include <stdlib.h> // setenv
 #include <sys/prctl.h> // prctl(), PR_SET_PDEATHSIG
+#include <poll.h>
 
 #include <cstring> // strsignal
+#include <algorithm>
 #include <iostream>
 #include <sstream>
+#include <chrono>
+#include <thread>
 
 #include <zypp/base/Logger.h>
 #include <zypp/base/String.h>
 #include <zypp/base/Gettext.h>
 #include <zypp/ExternalProgram.h>
 #include <zypp/base/CleanerThread_p.h>
+#include <zypp/base/PidFd_p.h>
 
 using std::endl;
 
@@ -175,6 +180,7 @@ namespace zypp {
         // make sure the zombie is cleaned up once it exits
         CleanerThread::watchPID( pid );
       }
+      closePidfd();
     }
 
 
@@ -465,6 +471,7 @@ namespace zypp {
 	  setBlocking( false );
 	  FILE * inputfile = inputFile();
 	  int    inputfileFd = ::fileno( inputfile );
+	  int    exitFd = pidfd();	// if available, wakes us up as soon as the command exits
 	  long   delay = 0;
 	  do
 	  {
@@ -472,6 +479,8 @@ namespace zypp {
 	    fd_set rfds;
 	    FD_ZERO( &rfds );
 	    FD_SET( inputfileFd, &rfds );
+	    if ( exitFd >= 0 )
+	      FD_SET( exitFd, &rfds );
 
 	    /* Wait up to 1 seconds. */
 	    struct timeval tv;
@@ -479,7 +488,7 @@ namespace zypp {
 	    tv.tv_usec = (delay < 0 ? 0 : delay*100000);
 	    if ( delay >= 0 && ++delay > 9 )
 	      delay = -1;
-	    int retval = select( inputfileFd+1, &rfds, NULL, NULL, &tv );
+	    int retval = select( std::max( inputfileFd, exitFd )+1, &rfds, NULL, NULL, &tv );
 
 	    if ( retval == -1 )
 	    {
@@ -487,7 +496,7 @@ namespace zypp {
 	      if ( errno != EINTR )
 		break;
 	    }
-	    else if ( retval )
+	    else if ( retval && FD_ISSET( inputfileFd, &rfds ) )
 	    {
 	      // Data is available now.
 	      static size_t linebuffer_size = 0;      // static because getline allocs
@@ -501,7 +510,7 @@ namespace zypp {
 	    }
 	    else
 	    {
-	      // No data within time.
+	      // No data within time (or the command exited).
 	      if ( ! running() )
 		break;
 	    }
@@ -526,6 +535,7 @@ namespace zypp {
 	  pid = -1;
 	}
       }
+      closePidfd();
 
       return _exitStatus;
     }
@@ -611,9 +621,60 @@ namespace zypp {
       // Here: completed...
       _exitStatus = checkStatus( status );
       pid = -1;
+      closePidfd();
       return false;
     }
 
+    bool ExternalProgram::waitForExit( int timeout_r )
+    {
+      if ( pid < 0 ) return true;
+
+      int exitFd = pidfd();
+      if ( exitFd >= 0 )
+      {
+        struct pollfd pfd;
+        pfd.fd = exitFd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+
+        int ret;
+        do
+        {
+          ret = ::poll( &pfd, 1, timeout_r );
+        } while ( ret == -1 && errno == EINTR );
+
+        if ( ret == -1 )
+          ERR << "poll( pidfd " << pid << " ) returned error '" << strerror(errno) << "'" << endl;
+        return ! running();
+      }
+
+      // No pidfd: fall back to polling waitpid.
+      auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds( timeout_r );
+      while ( running() )
+      {
+        if ( timeout_r == 0 || ( timeout_r > 0 && std::chrono::steady_clock::now() >= deadline ) )
+          return false;
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+      }
+      return true;
+    }
+
+    int ExternalProgram::pidfd()
+    {
+      if ( pid > 0 && _pidfd < 0 )
+        _pidfd = base::openPidFd( pid );
+      return _pidfd;
+    }
+
+    void ExternalProgram::closePidfd()
+    {
+      if ( _pidfd >= 0 )
+      {
+        ::close( _pidfd );
+        _pidfd = -1;
+      }
+    }
+
     // origfd will be accessible as newfd and closed (unless they were equal)
     void ExternalProgram::renumber_fd (int origfd, int newfd)
     {
@@ -165,6 +165,35 @@ namespace zypp {
        */
       bool running();
 
+      /**
+       * Wait up to \a timeout_r milliseconds for the program to exit,
+       * without touching its io. A negative timeout waits forever, \c 0
+       * just checks. Once this returned \c true, \ref close will not block
+       * and returns the exit status.
+       *
+       * \note Programs writing more output than fits into the pipe will not
+       * exit until their output is read.
+       */
+      bool waitForExit( int timeout_r = -1 );
+
+      /**
+       * Return a file descriptor that becomes readable as soon as the
+       * program exited, or \c -1 if it is not running or the kernel does not
+       * support pidfds (Linux < 5.3). The fd is owned by \c this and closed
+       * once the program was reaped.
+       *
+       * Use this to wait for several programs at once, e.g. via \c poll or
+       * by watching it with a \c zyppng::SocketNotifier in an event loop:
+       * \code
+       *   auto notifier = zyppng::SocketNotifier::create( prog.pidfd(), zyppng::SocketNotifier::Read );
+       *   notifier->sigActivated().connect( [&]( const zyppng::SocketNotifier &, int ) {
+       *     notifier->setEnabled( false );
+       *     int ret = prog.close(); // does not block
+       *   });
+       * \endcode
+       */
+      int pidfd();
+
       /**
        * return pid
        * */
@@ -216,6 +245,9 @@ namespace zypp {
     protected:
       int checkStatus( int );
 
+    private:
+      void closePidfd();
+
     private:
 
       /**
@@ -226,6 +258,8 @@ namespace zypp {
 
       pid_t pid;
       int _exitStatus;
+      /** pidfd of the running program, opened on demand. */
+      int _pidfd = -1;
       /** Store the command we're executing. */
       std::string _command;
       /** Remember execution errors like failed fork/exec. */
@@ -11,8 +11,17 @@
 */
 
 #include <utime.h>     // for ::utime
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
 #include <sys/statvfs.h>
 #include <sys/sysmacros.h> // for ::minor, ::major macros
+#include <sys/xattr.h>
+#include <linux/fs.h>  // for FICLONE
+
+#include <map>
+#include <memory>
+#include <mutex>
 
 #include <iostream>
 #include <fstream>
@@ -25,10 +34,10 @@
 #include <zypp/base/Errno.h>
 
 #include <zypp/AutoDispose.h>
-#include <zypp/ExternalProgram.h>
 #include <zypp/PathInfo.h>
 #include <zypp/Digest.h>
 #include <zypp/TmpPath.h>
+#include <zypp/ZConfig.h>
 
 using std::endl;
 using std::string;
@@ -447,6 +456,230 @@ namespace zypp
       return logResult( recursive_rmdir_1( path, false/* don't remove path itself */ ) );
     }
 
+    ///////////////////////////////////////////////////////////////////
+    namespace
+    {
+      /** Copy the content of \a srcfd_r to \a destfd_r.
+       * Tries a reflink first (btrfs, xfs), then \c copy_file_range and \c sendfile,
+       * which copy inside the kernel, and finally plain read/write.
+       * \returns 0 or errno
+       */
+      int copyFileData( int srcfd_r, int destfd_r, off_t size_r )
+      {
+#ifdef FICLONE
+	if ( ::ioctl( destfd_r, FICLONE, srcfd_r ) == 0 )
+	  return 0;
+#endif
+	off_t done = 0;
+	bool useCopyFileRange = true;
+	bool useSendfile = true;
+	while ( done < size_r )
+	{
+	  size_t chunk = std::min( size_r - done, off_t(1) << 30 );
+	  ssize_t ret = -1;
+	  if ( useCopyFileRange )
+	  {
+	    ret = ::copy_file_range( srcfd_r, nullptr, destfd_r, nullptr, chunk, 0 );
+	    if ( ret == -1 && ( errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP ) )
+	    {
+	      useCopyFileRange = false;
+	      continue;
+	    }
+	  }
+	  else if ( useSendfile )
+	  {
+	    ret = ::sendfile( destfd_r, srcfd_r, nullptr, chunk );
+	    if ( ret == -1 && ( errno == ENOSYS || errno == EINVAL ) )
+	    {
+	      useSendfile = false;
+	      continue;
+	    }
+	  }
+	  else
+	  {
+	    char buf[128*1024];
+	    ret = ::read( srcfd_r, buf, std::min( chunk, sizeof(buf) ) );
+	    for ( ssize_t put = 0; ret > 0 && put < ret; )
+	    {
+	      ssize_t w = ::write( destfd_r, buf + put, ret - put );
+	      if ( w == -1 )
+	      {
+		if ( errno == EINTR )
+		  continue;
+		return errno;
+	      }
+	      put += w;
+	    }
+	  }
+
+	  if ( ret == -1 )
+	  {
+	    if ( errno == EINTR )
+	      continue;
+	    return errno;
+	  }
+	  if ( ret == 0 )
+	    break;	// file shrunk while copying
+	  done += ret;
+	}
+	return 0;
+      }
+
+      /** Copy mode, ownership, timestamps and extended attributes of \a src_r to \a dest_r (like <tt>cp -a</tt>).
+       * Failing to change the ownership or to set an attribute is not an error, as with \c mv.
+       */
+      void copyMetadata( const Pathname & dest_r, const struct stat & src_r, const Pathname & srcpath_r )
+      {
+	bool islink = S_ISLNK( src_r.st_mode );
+	if ( ::lchown( dest_r.c_str(), src_r.st_uid, src_r.st_gid ) == -1 && errno != EPERM )
+	  WAR << "lchown " << dest_r << ": " << Errno() << endl;
+	if ( ! islink )
+	  ::chmod( dest_r.c_str(), src_r.st_mode & 07777 );
+
+	ssize_t len = ::llistxattr( srcpath_r.c_str(), nullptr, 0 );
+	if ( len > 0 )
+	{
+	  std::string names( len, '\0' );
+	  len = ::llistxattr( srcpath_r.c_str(), &names[0], names.size() );
+	  for ( ssize_t pos = 0; pos < len; pos += ::strlen( names.c_str() + pos ) + 1 )
+	  {
+	    const char * name = names.c_str() + pos;
+	    ssize_t vlen = ::lgetxattr( srcpath_r.c_str(), name, nullptr, 0 );
+	    if ( vlen < 0 )
+	      continue;
+	    std::string value( vlen, '\0' );
+	    vlen = ::lgetxattr( srcpath_r.c_str(), name, &value[0], value.size() );
+	    if ( vlen >= 0 && ::lsetxattr( dest_r.c_str(), name, value.data(), vlen, 0 ) == -1 && errno != ENOTSUP && errno != EPERM )
+	      WAR << "lsetxattr " << name << " " << dest_r << ": " << Errno() << endl;
+	  }
+	}
+
+	struct timespec times[2] = { src_r.st_atim, src_r.st_mtim };
+	::utimensat( AT_FDCWD, dest_r.c_str(), times, AT_SYMLINK_NOFOLLOW );
+      }
+
+      /** Copy the regular file \a src_r to \a dest_r.
+       * Without \a truncate_r an existing \a dest_r is removed first (<tt>cp --remove-destination</tt>),
+       * otherwise it is overwritten in place. A new \a dest_r gets the mode of \a src_r (less the umask).
+       * \returns 0 or errno
+       */
+      int copyFile( const Pathname & src_r, const Pathname & dest_r, bool truncate_r = false )
+      {
+	AutoFD srcfd( ::open( src_r.c_str(), O_RDONLY | O_CLOEXEC ) );
+	if ( srcfd == -1 )
+	  return errno;
+	struct stat st;
+	if ( ::fstat( srcfd, &st ) == -1 )
+	  return errno;
+
+	struct stat dst;
+	if ( ::stat( dest_r.c_str(), &dst ) == 0 && dst.st_dev == st.st_dev && dst.st_ino == st.st_ino )
+	  return EEXIST;	// same file
+
+	int flags = O_WRONLY | O_CREAT | O_CLOEXEC;
+	if ( truncate_r )
+	  flags |= O_TRUNC;
+	else
+	{
+	  if ( ::unlink( dest_r.c_str() ) == -1 && errno != ENOENT )
+	    return errno;
+	  flags |= O_EXCL;
+	}
+	AutoFD destfd( ::open( dest_r.c_str(), flags, st.st_mode & 0777 ) );
+	if ( destfd == -1 )
+	  return errno;
+
+	::posix_fadvise( srcfd, 0, 0, POSIX_FADV_SEQUENTIAL );
+	int ret = copyFileData( srcfd, destfd, st.st_size );
+	if ( ::close( destfd.value() ) == -1 && ret == 0 )
+	  ret = errno;	// e.g. delayed write errors on NFS
+	destfd.resetDispose();
+	if ( ret != 0 )
+	  ::unlink( dest_r.c_str() );
+	return ret;
+      }
+
+      /** Recursive copy like <tt>cp -dR</tt> (or <tt>cp -a</tt> if \a preserve_r).
+       * Symlinks are copied as symlinks and hardlinks within the tree are kept.
+       * Existing directories are merged, existing files overwritten.
+       */
+      struct CopyTree
+      {
+	CopyTree( bool preserve_r = false )
+	: _preserve( preserve_r )
+	{}
+
+	int operator()( const Pathname & src_r, const Pathname & dest_r )
+	{
+	  struct stat st;
+	  if ( ::lstat( src_r.c_str(), &st ) == -1 )
+	    return errno;
+
+	  int ret = 0;
+	  if ( S_ISDIR( st.st_mode ) )
+	  {
+	    // keep the directory writable while filling it
+	    if ( ::mkdir( dest_r.c_str(), ( st.st_mode & 0777 ) | S_IRWXU ) == -1
+	         && ( errno != EEXIST || ! PathInfo( dest_r, PathInfo::LSTAT ).isDir() ) )
+	      return errno;
+
+	    std::list<std::string> entries;
+	    ret = readdir( entries, src_r, /*dots*/true );
+	    for ( auto it = entries.begin(); ret == 0 && it != entries.end(); ++it )
+	      ret = (*this)( src_r / *it, dest_r / *it );
+	    if ( ret != 0 )
+	      return ret;
+
+	    if ( ! _preserve && ( st.st_mode & S_IRWXU ) != S_IRWXU )
+	    {
+	      struct stat dst;
+	      if ( ::stat( dest_r.c_str(), &dst ) == 0 )
+		::chmod( dest_r.c_str(), ( dst.st_mode & 07077 ) | ( st.st_mode & S_IRWXU ) );
+	    }
+	  }
+	  else if ( S_ISREG( st.st_mode ) )
+	  {
+	    if ( st.st_nlink > 1 )
+	    {
+	      auto it = _hardlinks.find( { st.st_dev, st.st_ino } );
+	      if ( it != _hardlinks.end() )
+	      {
+		::unlink( dest_r.c_str() );
+		return ::link( it->second.c_str(), dest_r.c_str() ) == -1 ? errno : 0;
+	      }
+	      _hardlinks[{ st.st_dev, st.st_ino }] = dest_r;
+	    }
+	    ret = copyFile( src_r, dest_r, /*truncate*/true );
+	  }
+	  else if ( S_ISLNK( st.st_mode ) )
+	  {
+	    Pathname target;
+	    if ( ( ret = readlink( src_r, target ) ) != 0 )
+	      return ret;
+	    ::unlink( dest_r.c_str() );
+	    if ( ::symlink( target.c_str(), dest_r.c_str() ) == -1 )
+	      return errno;
+	  }
+	  else
+	  {
+	    // fifo, socket or device
+	    ::unlink( dest_r.c_str() );
+	    if ( ::mknod( dest_r.c_str(), st.st_mode, st.st_rdev ) == -1 )
+	      return errno;
+	  }
+
+	  if ( ret == 0 && _preserve )
+	    copyMetadata( dest_r, st, src_r );
+	  return ret;
+	}
+
+      private:
+	bool _preserve;
+	std::map<std::pair<dev_t,ino_t>,Pathname> _hardlinks;
+      };
+    } // namespace
+    ///////////////////////////////////////////////////////////////////
+
     ///////////////////////////////////////////////////////////////////
     //
     //	METHOD NAME : copy_dir
@@ -471,21 +704,7 @@ namespace zypp
         return logResult( EEXIST );
       }
 
-
-      const char *const argv[] = {
-        "/bin/cp",
-        "-dR",
-        "--",
-        srcpath.asString().c_str(),
-        destpath.asString().c_str(),
-        NULL
-      };
-      ExternalProgram prog( argv, ExternalProgram::Stderr_To_Stdout );
-      for ( string output( prog.receiveLine() ); output.length(); output = prog.receiveLine() ) {
-        MIL << "  " << output;
-      }
-      int ret = prog.close();
-      return logResult( ret, "returned" );
+      return logResult( CopyTree()( srcpath, tp.path() ) );
     }
 
     ///////////////////////////////////////////////////////////////////
@@ -511,22 +730,13 @@ namespace zypp
         return logResult( EEXIST );
       }
 
-      std::string src( srcpath.asString());
-      src += "/.";
-      const char *const argv[] = {
-        "/bin/cp",
-        "-dR",
-        "--",
-        src.c_str(),
-        destpath.asString().c_str(),
-        NULL
-      };
-      ExternalProgram prog( argv, ExternalProgram::Stderr_To_Stdout );
-      for ( string output( prog.receiveLine() ); output.length(); output = prog.receiveLine() ) {
-        MIL << "  " << output;
-      }
-      int ret = prog.close();
-      return logResult( ret, "returned" );
+      // like 'cp -dR srcpath/. destpath'
+      std::list<std::string> entries;
+      int ret = readdir( entries, srcpath, /*dots*/true );
+      CopyTree copytree;
+      for ( auto it = entries.begin(); ret == 0 && it != entries.end(); ++it )
+        ret = copytree( srcpath / *it, destpath / *it );
+      return logResult( ret );
     }
 
     ///////////////////////////////////////////////////////////////////////
@@ -666,20 +876,30 @@ namespace zypp
       {
         int ret = ::rename( oldpath.asString().c_str(), newpath.asString().c_str() );
 
-        // rename(2) can fail on OverlayFS. Fallback to using mv(1), which is
-        // explicitly mentioned in the kernel docs to deal correctly with OverlayFS.
+        // rename(2) can fail on OverlayFS. Fallback to copy and remove, as mv(1)
+        // does, which is explicitly mentioned in the kernel docs to deal correctly
+        // with OverlayFS.
         if ( ret == -1 && errno == EXDEV ) {
-          const char *const argv[] = {
-            "/usr/bin/mv",
-            oldpath.asString().c_str(),
-            newpath.asString().c_str(),
-            NULL
-          };
-          ExternalProgram prog( argv, ExternalProgram::Stderr_To_Stdout );
-          for ( string output( prog.receiveLine() ); output.length(); output = prog.receiveLine() ) {
-            MIL << "  " << output;
+          PathInfo oldinfo( oldpath, PathInfo::LSTAT );
+          PathInfo newinfo( newpath, PathInfo::LSTAT );
+          if ( oldinfo.isDir() && newinfo.isDir() ) {
+            ret = ::rmdir( newpath.c_str() );	// like rename(2) fails unless empty
+          }
+          else if ( ! oldinfo.isDir() && newinfo.isExist() && ! newinfo.isDir() ) {
+            ret = ::unlink( newpath.c_str() );
+          }
+          else {
+            ret = 0;
+          }
+          if ( ret == 0 ) {
+            int err = CopyTree( /*preserve*/true )( oldpath, newpath );
+            if ( err == 0 )
+              err = oldinfo.isDir() ? recursive_rmdir( oldpath ) : ( ::unlink( oldpath.c_str() ) == -1 ? errno : 0 );
+            if ( err != 0 ) {
+              errno = err;
+              ret = -1;
+            }
           }
-          ret = prog.close();
         }
 
         return ret;
@@ -784,20 +1004,7 @@ namespace zypp
         return logResult( EISDIR );
       }
 
-      const char *const argv[] = {
-        "/bin/cp",
-        "--remove-destination",
-        "--",
-        file.asString().c_str(),
-        dest.asString().c_str(),
-        NULL
-      };
-      ExternalProgram prog( argv, ExternalProgram::Stderr_To_Stdout );
-      for ( string output( prog.receiveLine() ); output.length(); output = prog.receiveLine() ) {
-        MIL << "  " << output;
-      }
-      int ret = prog.close();
-      return logResult( ret, "returned" );
+      return logResult( copyFile( file, dest ) );
     }
 
     ///////////////////////////////////////////////////////////////////
@@ -954,19 +1161,7 @@ namespace zypp
         return logResult( ENOTDIR );
       }
 
-      const char *const argv[] = {
-        "/bin/cp",
-        "--",
-        file.asString().c_str(),
-        dest.asString().c_str(),
-        NULL
-      };
-      ExternalProgram prog( argv, ExternalProgram::Stderr_To_Stdout );
-      for ( string output( prog.receiveLine() ); output.length(); output = prog.receiveLine() ) {
-        MIL << "  " << output;
-      }
-      int ret = prog.close();
-      return logResult( ret, "returned" );
+      return logResult( copyFile( file, dest / file.basename(), /*truncate*/true ) );
     }
 
     ///////////////////////////////////////////////////////////////////
@@ -976,14 +1171,7 @@ namespace zypp
     //
     std::string md5sum( const Pathname & file )
     {
-      if ( ! PathInfo( file ).isFile() ) {
-        return string();
-      }
-      std::ifstream istr( file.asString().c_str() );
-      if ( ! istr ) {
-        return string();
-      }
-      return Digest::digest( "MD5", istr );
+      return checksum(file, "MD5");
     }
 
     ///////////////////////////////////////////////////////////////////
@@ -996,6 +1184,219 @@ namespace zypp
       return checksum(file, "SHA1");
     }
 
+    ///////////////////////////////////////////////////////////////////
+    namespace
+    {
+      /** Remembers the digests computed for a file.
+       * They are valid as long as the files device, inode, size and mtime
+       * (the key) are unchanged. Kept in memory and, if \a persist_r is
+       * passed (see \ref persistDigests), in an extended attribute of the file:
+       * \code
+       *   key\n
+       *   algorithm digest\n
+       *   ...
+       * \endcode
+       */
+      class DigestCache
+      {
+      public:
+	typedef std::map<std::string,std::string> Digests;	// lowercase algorithm -> digest
+
+	static DigestCache & instance()
+	{
+	  static DigestCache _instance;
+	  return _instance;
+	}
+
+	static std::string key( const struct stat & st_r )
+	{ return str::form( "%llx:%llx:%lld:%lld.%09ld", (unsigned long long)st_r.st_dev, (unsigned long long)st_r.st_ino,
+			    (long long)st_r.st_size, (long long)st_r.st_mtim.tv_sec, st_r.st_mtim.tv_nsec ); }
+
+	/** The cached digests of the open file \a fd_r. */
+	Digests get( int fd_r, const struct stat & st_r, bool persist_r )
+	{
+	  const std::string & k { key( st_r ) };
+	  {
+	    std::lock_guard<std::mutex> lock( _mutex );
+	    auto it = _mem.find( k );
+	    if ( it != _mem.end() )
+	      return it->second;
+	  }
+
+	  Digests ret;
+	  if ( ! persist_r )
+	    return ret;
+	  char buf[1024];
+	  ssize_t len = ::fgetxattr( fd_r, xattrName, buf, sizeof(buf) );
+	  if ( len <= 0 )
+	    return ret;
+
+	  std::vector<std::string> lines;
+	  str::split( std::string( buf, len ), std::back_inserter( lines ), "\n" );
+	  if ( lines.empty() || lines[0] != k )
+	    return ret;	// file changed since
+	  for ( auto it = lines.begin() + 1; it != lines.end(); ++it )
+	  {
+	    std::string::size_type sep = it->find( ' ' );
+	    if ( sep != std::string::npos )
+	      ret[it->substr( 0, sep )] = it->substr( sep + 1 );
+	  }
+	  remember( k, ret );
+	  return ret;
+	}
+
+	/** Add \a digests_r to the cached digests of the open file \a fd_r. */
+	void set( int fd_r, const struct stat & st_r, Digests digests_r, bool persist_r )
+	{
+	  const std::string & k { key( st_r ) };
+	  {
+	    std::lock_guard<std::mutex> lock( _mutex );
+	    auto it = _mem.find( k );
+	    if ( it != _mem.end() )
+	      digests_r.insert( it->second.begin(), it->second.end() );
+	  }
+	  remember( k, digests_r );
+
+	  if ( ! persist_r || st_r.st_uid != ::geteuid() )
+	    return;
+	  std::string value { k };
+	  for ( const auto & digest : digests_r )
+	    value += "\n" + digest.first + " " + digest.second;
+	  if ( ::fsetxattr( fd_r, xattrName, value.data(), value.size(), 0 ) == -1
+	       && errno != ENOTSUP && errno != EROFS && errno != EPERM && errno != EACCES )
+	    DBG << "Can't cache digests: " << Errno() << endl;
+	}
+
+      private:
+	void remember( const std::string & key_r, const Digests & digests_r )
+	{
+	  std::lock_guard<std::mutex> lock( _mutex );
+	  if ( _mem.size() >= 512 )
+	    _mem.clear();	// just a simple bound
+	  _mem[key_r] = digests_r;
+	}
+
+	static constexpr const char * xattrName = "user.zypp.digests";
+	std::mutex _mutex;
+	std::map<std::string,Digests> _mem;
+      };
+
+      /** Whether the digests of \a file_r may be kept in (and taken from) its xattr.
+       * Only if enabled in zypp.conf and only for files below zypps own cache
+       * dirs, which nobody but us (or root) can modify. The xattr could be
+       * forged by anyone able to write the file or to replace it.
+       */
+      bool persistDigests( const Pathname & file_r, const struct stat & st_r )
+      {
+	const ZConfig & zconfig { ZConfig::instance() };
+	if ( ! zconfig.download_persist_checksums() || ! file_r.absolute() )
+	  return false;
+
+	auto trusted = []( const struct stat & st ) {
+	  return ( st.st_uid == 0 || st.st_uid == ::geteuid() ) && ! ( st.st_mode & ( S_IWGRP | S_IWOTH ) );
+	};
+	if ( ! trusted( st_r ) )
+	  return false;
+
+	for ( const Pathname & cache : { zconfig.repoCachePath(), zconfig.repoPackagesPath() } )
+	{
+	  const std::string & prefix { cache.asString() + "/" };
+	  if ( file_r.asString().compare( 0, prefix.size(), prefix ) != 0 )
+	    continue;
+	  // each dir up to the cache dir must be a real dir nobody else may write
+	  bool ok = true;
+	  for ( Pathname dir { file_r.dirname() }; ok; dir = dir.dirname() )
+	  {
+	    struct stat st;
+	    ok = ::lstat( dir.c_str(), &st ) == 0 && S_ISDIR( st.st_mode ) && trusted( st );
+	    if ( dir == cache )
+	      break;
+	  }
+	  if ( ok )
+	    return true;
+	}
+	return false;
+      }
+    } // namespace
+    ///////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //  METHOD NAME : checksums
+    //  METHOD TYPE : std::vector<std::string>
+    //
+    std::vector<std::string> checksums( const Pathname & file, const std::vector<std::string> & algorithms )
+    {
+      std::vector<std::string> ret( algorithms.size() );
+      // Check before opening, a FIFO would block the open.
+      if ( ! PathInfo( file ).isFile() ) {
+        return ret;
+      }
+      AutoFD fd( ::open( file.c_str(), O_RDONLY | O_CLOEXEC | O_NONBLOCK ) );
+      struct stat st;
+      if ( fd == -1 || ::fstat( fd, &st ) == -1 || ! S_ISREG( st.st_mode ) ) {
+        return ret;
+      }
+
+      // Take what's cached, compute the rest in one pass.
+      DigestCache & cache { DigestCache::instance() };
+      bool persist = persistDigests( file, st );
+      DigestCache::Digests cached { cache.get( fd, st, persist ) };
+      std::vector<std::unique_ptr<Digest>> todo( algorithms.size() );
+      bool needRead = false;
+      for ( unsigned i = 0; i < algorithms.size(); ++i )
+      {
+        auto it = cached.find( str::toLower( algorithms[i] ) );
+        if ( it != cached.end() ) {
+          ret[i] = it->second;
+        }
+        else {
+          todo[i].reset( new Digest );
+          if ( todo[i]->create( algorithms[i] ) )
+            needRead = true;
+          else
+            todo[i].reset();
+        }
+      }
+      if ( ! needRead ) {
+        return ret;
+      }
+
+      // Large reads; mmap would SIGBUS if the file is truncated meanwhile.
+      ::posix_fadvise( fd, 0, 0, POSIX_FADV_SEQUENTIAL );
+      std::vector<char> buf( 1024*1024 );
+      for ( ;; )
+      {
+        ssize_t got = ::read( fd, buf.data(), buf.size() );
+        if ( got == -1 && errno == EINTR )
+          continue;
+        if ( got == -1 ) {
+          ERR << "read " << file << ": " << Errno() << endl;
+          return std::vector<std::string>( algorithms.size() );
+        }
+        if ( got == 0 )
+          break;
+        for ( auto & digest : todo )
+          if ( digest && ! digest->update( buf.data(), got ) )
+            digest.reset();
+      }
+
+      DigestCache::Digests computed;
+      for ( unsigned i = 0; i < algorithms.size(); ++i )
+      {
+        if ( todo[i] ) {
+          ret[i] = todo[i]->digest();
+          computed[str::toLower( algorithms[i] )] = ret[i];
+        }
+      }
+
+      // Remember them unless the file changed while we were reading.
+      struct stat after;
+      if ( ::fstat( fd, &after ) == 0 && DigestCache::key( after ) == DigestCache::key( st ) )
+        cache.set( fd, st, std::move(computed), persist );
+      return ret;
+    }
+
     ///////////////////////////////////////////////////////////////////
     //
     //  METHOD NAME : checksum
@@ -1003,14 +1404,7 @@ namespace zypp
     //
     std::string checksum( const Pathname & file, const std::string &algorithm )
     {
-      if ( ! PathInfo( file ).isFile() ) {
-        return string();
-      }
-      std::ifstream istr( file.asString().c_str() );
-      if ( ! istr ) {
-        return string();
-      }
-      return Digest::digest( algorithm, istr );
+      return checksums( file, { algorithm } )[0];
     }
 
     bool is_checksum( const Pathname & file, const CheckSum &checksum )
@@ -1091,7 +1485,10 @@ namespace zypp
             ret = ZT_BZ2;
           } else if ( magic[0] == '\0' && magic[1] == 'Z' && magic[2] == 'C' && magic[3] == 'K' && magic[4] == '1') {
             ret = ZT_ZCHNK;
-
+          } else if ( magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD ) {
+            ret = ZT_ZSTD;
+          } else if ( magic[0] == 0xFD && magic[1] == '7' && magic[2] == 'z' && magic[3] == 'X' && magic[4] == 'Z' ) {
+            ret = ZT_XZ;
           }
         }
         close( fd );
@@ -26,6 +26,7 @@ extern "C"
 #include <list>
 #include <set>
 #include <map>
+#include <vector>
 
 #include <zypp/Pathname.h>
 #include <zypp/CheckSum.h>
@@ -435,21 +436,21 @@ namespace zypp
     int clean_dir( const Pathname & path );
 
     /**
-     * Like 'cp -a srcpath destpath'. Copy directory tree. srcpath/destpath must be
+     * Like 'cp -dR srcpath destpath'. Copy directory tree. srcpath/destpath must be
      * directories. 'basename srcpath' must not exist in destpath.
+     * Symlinks are copied as symlinks, hardlinks within the tree are kept.
      *
      * @return 0 on success, ENOTDIR if srcpath/destpath is not a directory, EEXIST if
-     * 'basename srcpath' exists in destpath, otherwise the commands return value.
+     * 'basename srcpath' exists in destpath, otherwise errno.
      **/
     int copy_dir( const Pathname & srcpath, const Pathname & destpath );
 
     /**
-     * Like 'cp -a srcpath/. destpath'. Copy the content of srcpath recursively
+     * Like 'cp -dR srcpath/. destpath'. Copy the content of srcpath recursively
      * into destpath. Both \p srcpath and \p destpath has to exists.
      *
      * @return 0 on success, ENOTDIR if srcpath/destpath is not a directory,
-     * EEXIST if srcpath and destpath are equal, otherwise the commands
-     * return value.
+     * EEXIST if srcpath and destpath are equal, otherwise errno.
      */
     int copy_dir_content( const Pathname & srcpath, const Pathname & destpath);
 
@@ -603,9 +604,10 @@ namespace zypp
 
     /**
      * Like '::rename'. Renames a file, moving it between directories if
-     * required. It falls back to using mv(1) in case errno is set to
-     * EXDEV, indicating a cross-device rename, which is likely to happen when
-     * oldpath and newpath are not on the same OverlayFS layer.
+     * required. It falls back to copy and remove, preserving the metadata
+     * like mv(1), in case errno is set to EXDEV, indicating a cross-device
+     * rename, which is likely to happen when oldpath and newpath are not on
+     * the same OverlayFS layer.
      *
      * @return 0 on success, errno on failure
      **/
@@ -640,10 +642,12 @@ namespace zypp
     int exchange( const Pathname & lpath, const Pathname & rpath );
 
     /**
-     * Like 'cp file dest'. Copy file to destination file.
+     * Like 'cp --remove-destination file dest'. Copy file to destination file.
+     * Uses a reflink or an in-kernel copy if the filesystem supports it.
      *
      * @return 0 on success, EINVAL if file is not a file, EISDIR if
-     * destiantion is a directory, otherwise the commands return value.
+     * destiantion is a directory, EEXIST if file and dest are the same,
+     * otherwise errno.
      **/
     int copy( const Pathname & file, const Pathname & dest );
 
@@ -703,7 +707,7 @@ namespace zypp
      * Like 'cp file dest'. Copy file to dest dir.
      *
      * @return 0 on success, EINVAL if file is not a file, ENOTDIR if dest
-     * is no directory, otherwise the commands return value.
+     * is no directory, otherwise errno.
      **/
     int copy_file2dir( const Pathname & file, const Pathname & dest );
     //@}
@@ -731,10 +735,25 @@ namespace zypp
     /**
      * Compute a files checksum
      *
+     * The file is read with large sequential reads. Computed checksums are
+     * remembered, keyed by the files device, inode, size and mtime, so an
+     * unchanged file is not read again. Below zypps cache dirs they may also
+     * be kept in the files extended attributes, see
+     * \ref ZConfig::download_persist_checksums.
+     *
      * @return the files checksum on success, otherwise an empty string..
      **/
     std::string checksum( const Pathname & file, const std::string &algorithm );
 
+    /**
+     * Compute several checksums of a file, reading it only once.
+     * \see \ref checksum
+     *
+     * @return the files checksums in the order of \a algorithms, empty strings
+     * for failed ones.
+     **/
+    std::vector<std::string> checksums( const Pathname & file, const std::vector<std::string> & algorithms );
+
     /**
      * check files checksum
      *
@@ -771,11 +790,13 @@ namespace zypp
     /** \name Misc. */
     //@{
     /**
-     * Test whether a file is compressed (gzip/bzip2).
+     * Test whether a file is compressed (gzip/bzip2/zchunk/zstd/xz).
+     *
+     * The type is guessed from the files magic bytes.
      *
-     * @return ZT_GZ, ZT_BZ2 if file is compressed, otherwise ZT_NONE.
+     * @return ZT_GZ, ZT_BZ2, ZT_ZCHNK, ZT_ZSTD, ZT_XZ if file is compressed, otherwise ZT_NONE.
      **/
-    enum ZIP_TYPE { ZT_NONE, ZT_GZ, ZT_BZ2, ZT_ZCHNK };
+    enum ZIP_TYPE { ZT_NONE, ZT_GZ, ZT_BZ2, ZT_ZCHNK, ZT_ZSTD, ZT_XZ };
 
     ZIP_TYPE zipType( const Pathname & file );
 
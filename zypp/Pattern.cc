@@ -11,8 +11,11 @@
 */
 #include <iostream>
 #include <zypp/base/LogTools.h>
+#include <zypp/base/SerialNumber.h>
 
 #include <zypp/ResPool.h>
+#include <zypp/sat/Pool.h>
+#include <zypp/sat/detail/PoolImpl.h>
 #include <zypp/Pattern.h>
 #include <zypp/Filter.h>
 
@@ -33,134 +36,6 @@ namespace zypp
       return Capability();
     }
 
-    ///////////////////////////////////////////////////////////////////
-    //
-    //	CLASS NAME : PatternExpander
-    //
-    /** Recursively expand a Pattern.
-     *
-     * This means recursively expanding Patterns included by this or
-     * extending this. The result is a \c set of <tt>Pattern::constPtr</tt>
-     * accessible via iterator.
-     */
-    class PatternExpander
-    {
-      public:
-        typedef std::map<Pattern::constPtr, DefaultIntegral<bool, false> > PatternMap;
-        typedef PatternMap::size_type size_type;
-        typedef PatternMap::key_type  value_type;
-        typedef MapKVIteratorTraits<PatternMap>::Key_const_iterator const_iterator;
-
-      public:
-        PatternExpander()
-        {}
-
-        /** Recursively expand Pattern. */
-        size_type doExpand( Pattern::constPtr pat_r )
-        {
-          // INT << "+++ " << pat_r << " ++++++++++++++++++++++++++++++++++" << endl;
-          _patternMap.clear();
-          if ( pat_r )
-          {
-            _patternMap[pat_r];
-            Pattern::constPtr unprocessed( pat_r );
-            // MIL << _patternMap << endl;
-            do {
-              expandIncludes( unprocessed );
-              expandExtending( unprocessed );
-              _patternMap[unprocessed] = true;
-              // MIL << _patternMap << endl;
-            } while( (unprocessed = nextUnprocessed()) );
-          }
-          // SEC << "--- " << _patternMap.size() << " ----------------------------------" << endl;
-          return _patternMap.size();
-        }
-
-        const_iterator begin() const
-        { return make_map_key_begin( _patternMap ); }
-
-        const_iterator end() const
-        { return make_map_key_end( _patternMap ); }
-
-      private:
-        /** Get the next unprocessed Pattern in \c _patternMap. */
-        Pattern::constPtr nextUnprocessed() const
-        {
-          for_( it, _patternMap.begin(), _patternMap.end() )
-          {
-            if ( ! it->second )
-              return it->first;
-          }
-          return NULL;
-        }
-
-      private:
-        /** Store all included patterns in \c _patternMap. */
-        void expandIncludes( const Pattern::constPtr & pat_r )
-        {
-          Pattern::NameList c( pat_r->includes() );
-          for_( it, c.begin(), c.end() )
-          {
-            expandInclude( Capability( it->c_str()/*, *ResKind::pattern*/ ) );
-          }
-        }
-
-        /** Store Patterns matching an \c Includes capability in \c _patternMap. */
-        void expandInclude( const Capability & include_r )
-        {
-          sat::WhatProvides w( include_r );
-          for_( it, w.begin(), w.end() )
-          {
-            _patternMap[asKind<Pattern>(PoolItem(*it))];
-          }
-        }
-
-      private:
-        /** Store all patterns extending \c pat_r in \c _patternMap. */
-        void expandExtending( const Pattern::constPtr & pat_r )
-        {
-          ResPool pool( ResPool::instance() );
-          for_( it, pool.byKindBegin<Pattern>(), pool.byKindEnd<Pattern>() )
-          {
-            expandIfExtends( pat_r, *it );
-          }
-        }
-
-        /** Store \c extending_r if it extends \c pat_r. */
-        void expandIfExtends( const Pattern::constPtr & pat_r, const PoolItem & extending_r )
-        {
-          Pattern::constPtr extending( asKind<Pattern>(extending_r) );
-          Pattern::NameList c( extending->extends() );
-          for_( it, c.begin(), c.end() )
-          {
-            if ( providedBy( pat_r, Capability( it->c_str()/*, *ResKind::pattern*/ ) ) )
-            {
-              // an extends matches the Pattern
-              _patternMap[extending];
-              break;
-            }
-          }
-        }
-
-        /** Return true if Capability \c extends_r is provided by Pattern. */
-        bool providedBy( const Pattern::constPtr & pat_r, const Capability & extends_r )
-        {
-          if ( !pat_r )
-            return false;
-
-          sat::Solvable pat( pat_r->satSolvable() );
-          sat::WhatProvides w( extends_r );
-          for_( it, w.begin(), w.end() )
-          {
-            if ( pat == *it )
-              return true;
-          }
-          return false;
-        }
-
-      private:
-        PatternMap _patternMap;
-    };
   } // namespace
   ///////////////////////////////////////////////////////////////////
 
@@ -281,20 +156,165 @@ namespace zypp
                               make_filter_end( filter::byKind<Package>(), prv ) );
   }
 
-  Pattern::Contents Pattern::contents( bool includeSuggests_r ) const
+  ///////////////////////////////////////////////////////////////////
+  namespace
   {
-    PatternExpander expander;
-    if ( ! expander.doExpand( this ) )
-      return Contents(); // empty pattern set
-
-    Contents result;
-    for_( it, expander.begin(), expander.end() )
+    ///////////////////////////////////////////////////////////////////
+    /// \class PatternGraph
+    /// \brief Recursive expansion of all patterns, remembered until the pools
+    /// dependency related indices change (content, requested locales, namespaces).
+    ///
+    /// Expanding a pattern means recursively adding the patterns it
+    /// includes and the patterns extending it. The graph of these
+    /// relations is built for all patterns at once. Its strongly
+    /// connected components (patterns expanding each other) are
+    /// processed in topological order, so the contents of a component
+    /// are its own patterns \ref Pattern::depends plus the already
+    /// computed contents of the components it expands to.
+    ///////////////////////////////////////////////////////////////////
+    class PatternGraph
     {
-      Contents c( (*it)->depends( includeSuggests_r ) );
-      result.get().insert( c.begin(), c.end() );
-    }
-    return result;
-  }
+    public:
+      static PatternGraph & instance()
+      {
+	static PatternGraph _instance;
+	if ( _instance._serial.remember( sat::detail::PoolMember::myPool().serialDeps() ) )
+	  _instance.build();
+	return _instance;
+      }
+
+      /** The contents of all patterns \a pat_r expands to. */
+      Pattern::Contents contents( sat::Solvable pat_r, bool includeSuggests_r )
+      {
+	auto it = _component.find( pat_r );
+	if ( it == _component.end() )
+	  return Pattern::Contents();
+
+	std::vector<Pattern::Contents> & contents { _contents[includeSuggests_r] };
+	if ( contents.empty() )
+	{
+	  // Successors precede their predecessors in _components.
+	  contents.resize( _components.size() );
+	  for ( unsigned comp = 0; comp < _components.size(); ++comp )
+	  {
+	    Pattern::Contents & result { contents[comp] };
+	    for ( sat::Solvable pat : _components[comp] )
+	    {
+	      Pattern::Contents c( make<Pattern>( pat )->depends( includeSuggests_r ) );
+	      result.get().insert( c.begin(), c.end() );
+	    }
+	    for ( unsigned succ : _componentSucc[comp] )
+	      result.get().insert( contents[succ].begin(), contents[succ].end() );
+	  }
+	}
+	return contents[it->second];
+      }
+
+    private:
+      void build()
+      {
+	_succ.clear();
+	_component.clear();
+	_components.clear();
+	_componentSucc.clear();
+	_contents[0].clear();
+	_contents[1].clear();
+
+	// The edges: pattern -> included pattern, extended pattern -> extending pattern
+	std::vector<sat::Solvable> patterns;
+	ResPool pool( ResPool::instance() );
+	for_( it, pool.byKindBegin<Pattern>(), pool.byKindEnd<Pattern>() )
+	{
+	  sat::Solvable pat( it->satSolvable() );
+	  patterns.push_back( pat );
+	  _succ[pat];
+	}
+	for ( sat::Solvable pat : patterns )
+	{
+	  Pattern::constPtr pattern( make<Pattern>( pat ) );
+	  for ( IdString include : pattern->includes() )
+	    for ( sat::Solvable solv : sat::WhatProvides( Capability( include.c_str() ) ) )
+	      if ( solv.isKind<Pattern>() )
+		_succ[pat].insert( solv );
+	  for ( IdString extends : pattern->extends() )
+	    for ( sat::Solvable solv : sat::WhatProvides( Capability( extends.c_str() ) ) )
+	      if ( solv.isKind<Pattern>() )
+		_succ[solv].insert( pat );
+	}
+
+	// Tarjan's algorithm emits a component after all components reachable from it.
+	_index.clear();
+	_lowlink.clear();
+	_stack.clear();
+	_onStack.clear();
+	for ( sat::Solvable pat : patterns )
+	  if ( ! _index.count( pat ) )
+	    strongConnect( pat );
+	_index.clear();
+	_lowlink.clear();
+	_onStack.clear();
+	MIL << "PatternGraph: " << patterns.size() << " patterns in " << _components.size() << " components" << endl;
+      }
+
+      void strongConnect( sat::Solvable pat_r )
+      {
+	unsigned idx = _index.size();
+	_index[pat_r] = _lowlink[pat_r] = idx;
+	_stack.push_back( pat_r );
+	_onStack.insert( pat_r );
+
+	for ( sat::Solvable succ : _succ[pat_r] )
+	{
+	  if ( ! _index.count( succ ) )
+	  {
+	    strongConnect( succ );
+	    _lowlink[pat_r] = std::min( _lowlink[pat_r], _lowlink[succ] );
+	  }
+	  else if ( _onStack.count( succ ) )
+	    _lowlink[pat_r] = std::min( _lowlink[pat_r], _index[succ] );
+	}
+
+	if ( _lowlink[pat_r] == _index[pat_r] )
+	{
+	  unsigned comp = _components.size();
+	  _components.emplace_back();
+	  sat::Solvable member;
+	  do {
+	    member = _stack.back();
+	    _stack.pop_back();
+	    _onStack.erase( member );
+	    _components[comp].push_back( member );
+	    _component[member] = comp;
+	  } while ( member != pat_r );
+
+	  // all successors outside this component are already assigned
+	  std::set<unsigned> succs;
+	  for ( sat::Solvable pat : _components[comp] )
+	    for ( sat::Solvable succ : _succ[pat] )
+	      if ( _component[succ] != comp )
+		succs.insert( _component[succ] );
+	  _componentSucc.emplace_back( succs.begin(), succs.end() );
+	}
+      }
+
+    private:
+      SerialNumberWatcher _serial;
+      std::map<sat::Solvable,std::set<sat::Solvable>> _succ;		///< pattern graph
+      std::map<sat::Solvable,unsigned> _component;			///< component of a pattern
+      std::vector<std::vector<sat::Solvable>> _components;		///< patterns per component, topologically ordered
+      std::vector<std::vector<unsigned>> _componentSucc;		///< components a component expands to
+      std::vector<Pattern::Contents> _contents[2];			///< [includeSuggests] contents per component
+      // strongConnect
+      std::map<sat::Solvable,unsigned> _index;
+      std::map<sat::Solvable,unsigned> _lowlink;
+      std::vector<sat::Solvable> _stack;
+      std::set<sat::Solvable> _onStack;
+    };
+  } // namespace
+  ///////////////////////////////////////////////////////////////////
+
+  Pattern::Contents Pattern::contents( bool includeSuggests_r ) const
+  { return PatternGraph::instance().contents( satSolvable(), includeSuggests_r ); }
 
   ///////////////////////////////////////////////////////////////////
   namespace
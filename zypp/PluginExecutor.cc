@@ -9,6 +9,7 @@
 /** \file	zypp/PluginExecutor.cc
  */
 #include <iostream>
+#include <vector>
 #include <zypp/base/LogTools.h>
 #include <zypp/base/NonCopyable.h>
 
@@ -80,12 +81,17 @@ namespace zypp
       DBG << "--------------- load " << pi << endl;
     }
 
+    /** Send the frame to all plugins concurrently (\ref PluginScript::sendReceive). */
     void send( const PluginFrame & frame_r )
     {
       DBG << "+++++++++++++++ send " << frame_r << endl;
-      for ( auto it = _scripts.begin(); it != _scripts.end(); )
+      std::vector<PluginScript> scripts( _scripts.begin(), _scripts.end() );
+      std::vector<PluginFrame> responses( PluginScript::sendReceive( scripts, frame_r ) );
+
+      auto rit = responses.begin();
+      for ( auto it = _scripts.begin(); it != _scripts.end(); ++rit )
       {
-	doSend( *it, frame_r );
+	checkResponse( *it, frame_r, *rit );	// closes on error
 	if ( it->isOpen() )
 	  ++it;
 	else
@@ -134,15 +140,20 @@ namespace zypp
 	WAR << e.asUserHistory() << endl;
       }
 
+      checkResponse( script_r, frame_r, ret );
+      return ret;
+    }
+
+    /** Close the plugin unless it ACKed (or does not know) the command. */
+    void checkResponse( PluginScript & script_r, const PluginFrame & frame_r, const PluginFrame & ret_r )
+    {
       // Allow using "/bin/cat" as reflector-script for testing
-      if ( ! ( ret.isAckCommand() || ret.isEnomethodCommand() || ( script_r.script() == "/bin/cat" && frame_r.command() != "ERROR" ) ) )
+      if ( ! ( ret_r.isAckCommand() || ret_r.isEnomethodCommand() || ( script_r.script() == "/bin/cat" && frame_r.command() != "ERROR" ) ) )
       {
-	WAR << "Bad plugin response from " << script_r << ": " << ret << endl;
+	WAR << "Bad plugin response from " << script_r << ": " << ret_r << endl;
 	WAR << "(Expected " << PluginFrame::ackCommand() << " or " << PluginFrame::enomethodCommand() << ")" << endl;
 	script_r.close();
       }
-
-      return ret;
     }
   private:
     std::list<PluginScript> _scripts;
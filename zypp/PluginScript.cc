@@ -11,7 +11,10 @@
 */
 #include <sys/types.h>
 #include <signal.h>
+#include <poll.h>
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <sstream>
 
@@ -157,6 +160,8 @@ namespace zypp
 
       PluginFrame receive() const;
 
+      static std::vector<PluginFrame> sendReceive( const std::vector<PluginScript> & scripts_r, const PluginFrame & frame_r );
+
     private:
       Pathname _script;
       Arguments _args;
@@ -427,6 +432,191 @@ namespace zypp
     return ret;
   }
 
+  std::vector<PluginFrame> PluginScript::Impl::sendReceive( const std::vector<PluginScript> & scripts_r, const PluginFrame & frame_r )
+  {
+    typedef std::chrono::steady_clock Clock;
+
+    /** Per script state while frames are exchanged. */
+    struct Pending
+    {
+      const Impl * _impl = nullptr;
+      FILE * _outp = nullptr;
+      FILE * _inp = nullptr;
+      std::string::size_type _written = 0;
+      std::string _data;		// received so far
+      Clock::time_point _deadline;	// for the current write/read to make progress
+      bool _done = true;
+    };
+
+    std::vector<PluginFrame> ret( scripts_r.size() );
+    if ( scripts_r.empty() )
+      return ret;
+
+    if ( frame_r.command().empty() )
+      WAR << "Send: No command in frame" << frame_r << endl;
+
+    // prepare frame data to write
+    std::string data;
+    {
+      std::ostringstream datas;
+      frame_r.writeTo( datas );
+      datas.str().swap( data );
+    }
+
+    if ( PLUGIN_DEBUG )
+    {
+      std::istringstream datas( data );
+      iostr::copyIndent( datas, L_DBG("PLUGIN") ) << endl;
+    }
+
+    const Clock::time_point start( Clock::now() );
+    std::vector<Pending> pending( scripts_r.size() );
+    size_t open = 0;
+    for ( size_t i = 0; i < scripts_r.size(); ++i )
+    {
+      Pending & p( pending[i] );
+      p._impl = scripts_r[i]._pimpl.get();
+      if ( ! p._impl->_cmd )
+      {
+	WAR << *p._impl << " Send: Not connected" << endl;
+	continue;
+      }
+      p._outp = p._impl->_cmd->outputFile();
+      p._inp = p._impl->_cmd->inputFile();
+      if ( ! p._outp || ! p._inp || ::fileno( p._outp ) == -1 || ::fileno( p._inp ) == -1 )
+      {
+	WAR << *p._impl << " Send: Bad file descriptor" << endl;
+	continue;
+      }
+      ::clearerr( p._inp );
+      p._deadline = start + std::chrono::seconds( p._impl->_sendTimeout );
+      p._done = false;
+      ++open;
+      DBG << *p._impl << " ->send " << frame_r << endl;
+    }
+
+    // A script is done once it responded or failed. Failed scripts keep an empty response.
+    auto finish = [&]( size_t i_r, const char * error_r = nullptr ) {
+      Pending & p( pending[i_r] );
+      p._done = true;
+      --open;
+      {
+	PluginDebugBuffer _debug( p._data ); // dump receive buffer if PLUGIN_DEBUG
+	PluginDumpStderr _dump( *p._impl->_cmd ); // dump scripts stderr
+      }
+      long ms = std::chrono::duration_cast<std::chrono::milliseconds>( Clock::now() - start ).count();
+      if ( error_r )
+      {
+	WAR << *p._impl << " " << frame_r.command() << ": " << error_r << " after " << ms << "ms" << endl;
+	return;
+      }
+      try
+      {
+	std::istringstream datas( p._data );
+	ret[i_r] = PluginFrame( datas );
+	DBG << *p._impl << " <-" << ret[i_r] << endl;
+	MIL << *p._impl << " " << frame_r.command() << " -> " << ret[i_r].command() << " after " << ms << "ms" << endl;
+      }
+      catch( const zypp::Exception & e )
+      {
+	ZYPP_CAUGHT(e);
+	WAR << *p._impl << " " << frame_r.command() << ": " << e.asUserHistory() << " after " << ms << "ms" << endl;
+      }
+    };
+
+    SignalSaver sigsav( SIGPIPE, SIG_IGN );
+    std::vector<pollfd> fds;
+    while ( open )
+    {
+      const Clock::time_point now( Clock::now() );
+      Clock::time_point next( Clock::time_point::max() );
+      fds.clear();
+
+      for ( size_t i = 0; i < pending.size(); ++i )
+      {
+	Pending & p( pending[i] );
+	if ( p._done )
+	  continue;
+
+	if ( p._written < data.size() )
+	{
+	  ssize_t res = ::write( ::fileno( p._outp ), data.c_str() + p._written, data.size() - p._written );
+	  if ( res > 0 )
+	  {
+	    p._written += res;
+	    p._deadline = now + std::chrono::seconds( p._written < data.size() ? p._impl->_sendTimeout : p._impl->_receiveTimeout );
+	    ::fflush( p._outp );
+	  }
+	  else if ( errno != EAGAIN && errno != EINTR )
+	  {
+	    ERR << "write(): " << Errno() << endl;
+	    finish( i, errno == EPIPE ? "Send: script died unexpectedly" : "Send: send error" );
+	    continue;
+	  }
+	}
+
+	if ( p._written == data.size() )
+	{
+	  // read what's available (maybe already buffered in the FILE)
+	  int ch = EOF;
+	  while ( ( ch = ::fgetc( p._inp ) ) != EOF )
+	  {
+	    p._data.push_back( ch );
+	    if ( ch == '\0' )
+	      break;
+	  }
+	  if ( ch == '\0' )
+	  {
+	    finish( i );
+	    continue;
+	  }
+	  if ( ::feof( p._inp ) )
+	  {
+	    WAR << "Unexpected EOF" << endl;
+	    finish( i, "Receive: script died unexpectedly" );
+	    continue;
+	  }
+	  if ( errno != EWOULDBLOCK && errno != EINTR )
+	  {
+	    ERR << "read(): " << Errno() << endl;
+	    finish( i, "Receive: receive error" );
+	    continue;
+	  }
+	  ::clearerr( p._inp );
+	}
+
+	if ( now >= p._deadline )
+	{
+	  finish( i, p._written < data.size() ? "Not ready to write within timeout." : "Not ready to read within timeout." );
+	  continue;
+	}
+
+	pollfd pfd;
+	pfd.fd = ::fileno( p._written < data.size() ? p._outp : p._inp );
+	pfd.events = ( p._written < data.size() ? POLLOUT : POLLIN );
+	pfd.revents = 0;
+	fds.push_back( pfd );
+	next = std::min( next, p._deadline );
+      }
+
+      if ( fds.empty() )
+	break;
+
+      // no need to check revents, the next round tries to write/read on all
+      int timeout = std::chrono::duration_cast<std::chrono::milliseconds>( next - now ).count() + 1;
+      if ( ::poll( &fds[0], fds.size(), timeout ) == -1 && errno != EINTR )
+      {
+	ERR << "poll(): " << Errno() << endl;
+	for ( size_t i = 0; i < pending.size(); ++i )
+	{
+	  if ( ! pending[i]._done )
+	    finish( i, "Error waiting on file descriptor" );
+	}
+      }
+    }
+    return ret;
+  }
+
   ///////////////////////////////////////////////////////////////////
   //
   //	CLASS NAME : PluginScript
@@ -507,6 +697,9 @@ namespace zypp
   PluginFrame PluginScript::receive() const
   { return _pimpl->receive(); }
 
+  std::vector<PluginFrame> PluginScript::sendReceive( const std::vector<PluginScript> & scripts_r, const PluginFrame & frame_r )
+  { return Impl::sendReceive( scripts_r, frame_r ); }
+
   ///////////////////////////////////////////////////////////////////
 
   std::ostream & operator<<( std::ostream & str, const PluginScript & obj )
@@ -180,6 +180,17 @@ namespace zypp
        */
       PluginFrame receive() const;
 
+      /** Send a \ref PluginFrame to all \a scripts_r and receive their responses.
+       * The frame is written to all scripts at once and the responses are
+       * collected in a single \c poll loop, so a slow script does not delay
+       * the others. The time each script took to respond is logged.
+       *
+       * Instead of throwing, a script which is not connected, times out or
+       * fails otherwise gets an empty \ref PluginFrame as response.
+       * \return The responses in the order of \a scripts_r.
+       */
+      static std::vector<PluginFrame> sendReceive( const std::vector<PluginScript> & scripts_r, const PluginFrame & frame_r );
+
     public:
       /** Implementation. */
       struct Impl;
@@ -197,6 +197,9 @@ namespace zypp
   PoolItem::~PoolItem()
   {}
 
+  size_t PoolItem::implSize()
+  { return sizeof(Impl); }
+
   ResPool PoolItem::pool() const
   { return ResPool::instance(); }
 
@@ -28,6 +28,7 @@ namespace zypp
   namespace pool
   {
     class PoolImpl;
+    struct PoolMemoryStats;
   }
   ///////////////////////////////////////////////////////////////////
   /// \class PoolItem
@@ -142,6 +143,9 @@ namespace zypp
       static PoolItem makePoolItem( const sat::Solvable & solvable_r );
       /** Buddies are set by \ref pool::PoolImpl.*/
       void setBuddy( const sat::Solvable & solv_r );
+      friend struct pool::PoolMemoryStats;
+      /** Size of an items data (without the \ref ResObject). */
+      static size_t implSize();
       /** internal ctor */
     public:
       struct Impl;	///< Expose type only
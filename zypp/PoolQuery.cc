@@ -11,6 +11,8 @@
 */
 #include <iostream>
 #include <sstream>
+#include <map>
+#include <unordered_map>
 
 #include <zypp/base/Gettext.h>
 #include <zypp/base/LogTools.h>
@@ -20,6 +22,7 @@
 #include <zypp/RelCompare.h>
 
 #include <zypp/sat/Pool.h>
+#include <zypp/sat/detail/SearchIndex.h>
 #include <zypp/sat/Solvable.h>
 #include <zypp/base/StrMatcher.h>
 
@@ -43,6 +46,86 @@ namespace zypp
     // some Helpers and Predicates
     /////////////////////////////////////////////////////////////////
 
+    /** Literal strings any value matched by \a matcher_r contains.
+     * Empty if there are none or they are unknown (e.g. a regex).
+     */
+    std::vector<std::string> requiredLiterals( const StrMatcher & matcher_r )
+    {
+      std::vector<std::string> ret;
+      const std::string & str( matcher_r.searchstring() );
+      switch ( matcher_r.flags().mode() )
+      {
+        case Match::STRING:
+        case Match::STRINGSTART:
+        case Match::STRINGEND:
+        case Match::SUBSTRING:
+          ret.push_back( str );
+          break;
+
+        case Match::GLOB:
+        {
+          std::string lit;
+          for ( std::string::size_type i = 0; i < str.size(); ++i )
+          {
+            char ch = str[i];
+            if ( ch == '*' || ch == '?' || ch == '[' )
+            {
+              if ( ! lit.empty() )
+                ret.push_back( std::move( lit ) );
+              lit.clear();
+              if ( ch == '[' )	// skip the bracket expression ('[]...]' and '[!]...]' include the ']')
+              {
+                std::string::size_type j = i+1;
+                if ( j < str.size() && ( str[j] == '!' || str[j] == '^' ) )
+                  ++j;
+                if ( j < str.size() && str[j] == ']' )
+                  ++j;
+                while ( j < str.size() && str[j] != ']' )
+                {
+                  if ( str[j] == '[' && j+1 < str.size() && ( str[j+1] == ':' || str[j+1] == '=' || str[j+1] == '.' ) )
+                  {
+                    // '[:class:]', '[=equiv=]' and '[.coll.]' may contain a ']'
+                    std::string::size_type end = str.find( std::string( 1, str[j+1] ) + ']', j+2 );
+                    if ( end == std::string::npos )
+                    {
+                      j = str.size();
+                      break;
+                    }
+                    j = end + 2;
+                  }
+                  else if ( str[j] == '\\' && j+1 < str.size() )
+                    j += 2;
+                  else
+                    ++j;
+                }
+                i = j;	// at the ']', or at the end if unterminated (we can't tell what's literal then)
+              }
+            }
+            else if ( ch == '\\' && i+1 < str.size() )
+              lit += str[++i];
+            else
+              lit += ch;
+          }
+          if ( ! lit.empty() )
+            ret.push_back( std::move( lit ) );
+        }
+        break;
+
+        default:
+          break;
+      }
+
+      // The index folds ASCII only, so there's nothing to tell about non-ASCII ignoring case.
+      if ( matcher_r.flags().test( Match::NOCASE ) )
+      {
+        for ( const std::string & lit : ret )
+          for ( char ch : lit )
+            if ( (unsigned char)ch >= 0x80 )
+              return std::vector<std::string>();
+      }
+      return ret;
+    }
+
     bool isDependencyAttribute( sat::SolvAttr attr_r )
     {
       static sat::SolvAttr deps[] = {
@@ -1501,6 +1584,10 @@ namespace zypp
      * to the first match. Otherwise advance moves to the next match, or
      * to the \ref end, if there is no more match.
      *
+     * A file list search is narrowed by the repos \ref sat::detail::SearchIndex
+     * (if available). The base query is then performed per segment: each
+     * candidate solvable of an indexed repo and each repo without index.
+     *
      * \note The original implementation treated an empty search string as
      * <it>"match always"</it>. We stay compatible.
      */
@@ -1518,20 +1605,29 @@ namespace zypp
 
 	bool advance( base_iterator & base_r ) const
 	{
+	  unsigned segment = 0;
 	  if ( base_r == end() )
 	    base_r = startNewQyery(); // first candidate
 	  else
           {
+	    if ( _narrowed )
+	      segment = segmentOf( base_r.inSolvable() );
             base_r.nextSkipSolvable(); // assert we don't visit this Solvable again
 	    ++base_r; // advance to next candidate
           }
 
-	  while ( base_r != end() )
+	  while ( true )
 	  {
-	    if ( isAMatch( base_r ) )
-	      return true;
-	    // No match: try next
-            ++base_r;
+	    while ( base_r != end() )
+	    {
+	      if ( isAMatch( base_r ) )
+		return true;
+	      // No match: try next
+	      ++base_r;
+	    }
+	    if ( ! _narrowed || ++segment >= _segments.size() )
+	      break;
+	    base_r = segmentQuery( segment );
 	  }
 	  return false;
 	}
@@ -1619,12 +1715,76 @@ namespace zypp
 	  _status_flags = query_r->_status_flags;
           // StrMatcher
           _attrMatchList = query_r->_attrMatchList;
+
+	  // File list search: let the search index preselect the candidates
+	  if ( ! _neverMatchRepo && _attrMatchList.size() == 1
+	       && _attrMatchList.front().attr == sat::SolvAttr::filelist && _attrMatchList.front().strMatcher )
+	  {
+	    std::vector<std::string> literals( requiredLiterals( _attrMatchList.front().strMatcher ) );
+	    if ( ! literals.empty() )
+	      narrowBySearchIndex( literals );
+	  }
 	}
 
 	~PoolQueryMatcher()
 	{}
 
       private:
+	/** Build the \ref _segments if any repos search index knows the candidates. */
+	void narrowBySearchIndex( const std::vector<std::string> & literals_r )
+	{
+	  std::vector<sat::detail::SolvableIdType> candidates;
+	  for ( const Repository & repo : sat::Pool::instance().repos() )
+	  {
+	    if ( ! _repos.empty() && _repos.find( repo ) == _repos.end() )
+	      continue;
+
+	    if ( sat::detail::SearchIndex::candidates( repo.get(), literals_r, candidates ) )
+	    {
+	      _narrowed = true;
+	      for ( sat::detail::SolvableIdType id : candidates )
+	      {
+		_solvSegment[id] = _segments.size();
+		_segments.push_back( Segment{ Repository::noRepository, sat::Solvable( id ) } );
+	      }
+	    }
+	    else
+	    {
+	      _repoSegment[repo] = _segments.size();
+	      _segments.push_back( Segment{ repo, sat::Solvable::noSolvable } );
+	    }
+	  }
+	  if ( ! _narrowed )
+	  {
+	    _segments.clear();
+	    _solvSegment.clear();
+	    _repoSegment.clear();
+	  }
+	  else
+	    DBG << "Search index narrowed the file list search to " << _segments.size() << " segments" << endl;
+	}
+
+	/** The segment containing \a solv_r. */
+	unsigned segmentOf( sat::Solvable solv_r ) const
+	{
+	  auto sit { _solvSegment.find( solv_r.id() ) };
+	  if ( sit != _solvSegment.end() )
+	    return sit->second;
+	  auto rit { _repoSegment.find( solv_r.repository() ) };
+	  return( rit != _repoSegment.end() ? rit->second : _segments.size() );
+	}
+
+	/** The base query restricted to \a segment_r. */
+	base_iterator segmentQuery( unsigned segment_r ) const
+	{
+	  const Segment & segment( _segments[segment_r] );
+	  const AttrMatchData & matchData( _attrMatchList.front() );
+	  sat::LookupAttr q( segment._solv ? sat::LookupAttr( matchData.attr, segment._solv )
+	                                   : sat::LookupAttr( matchData.attr, segment._repo ) );
+	  q.setStrMatcher( matchData.strMatcher );
+	  return q.begin();
+	}
+
 	/** Initialize a new base query. */
 	base_iterator startNewQyery() const
 	{
@@ -1633,6 +1793,9 @@ namespace zypp
 	  if ( _neverMatchRepo )
 	    return q.end();
 
+	  if ( _narrowed )
+	    return( _segments.empty() ? q.end() : segmentQuery( 0 ) );
+
 	  // Repo restriction:
 	  if ( _repos.size() == 1 )
 	    q.setRepo( *_repos.begin() );
@@ -1773,6 +1936,18 @@ namespace zypp
         int _status_flags;
         /** StrMatcher per attribtue. */
         AttrMatchList _attrMatchList;
+
+	/** Part of a narrowed search: a candidate solvable or a repo without search index. */
+	struct Segment
+	{
+	  Repository    _repo;
+	  sat::Solvable _solv;
+	};
+	/** Whether the search index narrowed the search to \ref _segments. */
+	DefaultIntegral<bool,false> _narrowed;
+	std::vector<Segment> _segments;
+	std::unordered_map<sat::detail::SolvableIdType,unsigned> _solvSegment;
+	std::map<Repository,unsigned> _repoSegment;
     };
     ///////////////////////////////////////////////////////////////////
 
@@ -1813,7 +1988,12 @@ namespace zypp
       {
         for_( it, obj.matchesBegin(), obj.matchesEnd() )
         {
-          str << endl << "    " << it->inSolvAttr() << "\t" << it->asString();
+          str << endl << "    " << it->inSolvAttr() << "\t";
+          std::string_view val { it->asStringView() };
+          if ( val.data() )
+            str << val;
+          else
+            str << it->asString();
         }
       }
       return str;
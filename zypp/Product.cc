@@ -238,7 +238,7 @@ namespace zypp
   }
 
   bool Product::isTargetDistribution() const
-  { return isSystem() && lookupStrAttribute( sat::SolvAttr::productType ) == "base"; }
+  { return isSystem() && lookupStrAttributeView( sat::SolvAttr::productType ) == "base"; }
 
   std::string Product::registerTarget() const
   { return lookupStrAttribute( sat::SolvAttr::productRegisterTarget ); }
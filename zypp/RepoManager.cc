@@ -34,6 +34,7 @@
 #include <zypp/RepoManager.h>
 
 #include <zypp/media/MediaManager.h>
+#include <zypp/media/CurlHelper.h>
 #include <zypp/media/CredentialManager.h>
 #include <zypp/MediaSetAccess.h>
 #include <zypp/ExternalProgram.h>
@@ -45,6 +46,7 @@
 #include <zypp/repo/yum/Downloader.h>
 #include <zypp/repo/susetags/Downloader.h>
 #include <zypp/repo/PluginServices.h>
+#include <zypp/repo/PlaindirSolv_p.h>
 
 #include <zypp/Target.h> // for Target::targetDistribution() for repo index services
 #include <zypp/ZYppFactory.h> // to get the Target from ZYpp instance
@@ -52,6 +54,11 @@
 
 #include <zypp/ZYppCallbacks.h>
 
+#include <zypp/zyppng/base/EventDispatcher>
+#include <zypp/zyppng/media/network/networkrequestdispatcher.h>
+#include <zypp/zyppng/media/network/networkrequesterror.h>
+#include <zypp/zyppng/media/network/request.h>
+
 #include "sat/Pool.h"
 
 using std::endl;
@@ -597,6 +604,8 @@ namespace zypp
 
     RefreshCheckStatus checkIfToRefreshMetadata( const RepoInfo & info, const Url & url, RawMetadataRefreshPolicy policy );
 
+    std::map<std::string,RefreshCheckStatus> checkIfToRefreshMetadata( const std::list<RepoInfo> & repos, RawMetadataRefreshPolicy policy );
+
     void refreshMetadata( const RepoInfo & info, RawMetadataRefreshPolicy policy, OPT_PROGRESS );
 
     void cleanMetadata( const RepoInfo & info, OPT_PROGRESS );
@@ -685,6 +694,13 @@ namespace zypp
 
     void touchIndexFile( const RepoInfo & info );
 
+    /** The part of \ref checkIfToRefreshMetadata which does not need to access the repo.
+     * Returns \c true and the \a result if that's sufficient, otherwise the cached \a oldstatus
+     * must be compared to the repos current status.
+     */
+    bool checkIfToRefreshMetadataLocally( const RepoInfo & info, const Url & url, RawMetadataRefreshPolicy policy,
+                                          RepoStatus & oldstatus, RefreshCheckStatus & result );
+
     template<typename OutputIterator>
     void getRepositoriesInService( const std::string & alias, OutputIterator out ) const
     {
@@ -963,69 +979,84 @@ namespace zypp
   }
 
 
-  RepoManager::RefreshCheckStatus RepoManager::Impl::checkIfToRefreshMetadata( const RepoInfo & info, const Url & url, RawMetadataRefreshPolicy policy )
+  bool RepoManager::Impl::checkIfToRefreshMetadataLocally( const RepoInfo & info, const Url & url, RawMetadataRefreshPolicy policy,
+                                                           RepoStatus & oldstatus, RefreshCheckStatus & result )
   {
-    assert_alias(info);
-    try
+    // first check old (cached) metadata
+    Pathname mediarootpath = rawcache_path_for_repoinfo( _options, info );
+    filesystem::assert_dir( mediarootpath );
+    oldstatus = metadataStatus( info );
+    if ( oldstatus.empty() )
     {
-      MIL << "Going to try to check whether refresh is needed for " << url << " (" << info.type() << ")" << endl;
-
-      // first check old (cached) metadata
-      Pathname mediarootpath = rawcache_path_for_repoinfo( _options, info );
-      filesystem::assert_dir( mediarootpath );
-      RepoStatus oldstatus = metadataStatus( info );
-      if ( oldstatus.empty() )
-      {
-        MIL << "No cached metadata, going to refresh" << endl;
-        return REFRESH_NEEDED;
-      }
+      MIL << "No cached metadata, going to refresh" << endl;
+      result = REFRESH_NEEDED;
+      return true;
+    }
 
-      if ( url.schemeIsVolatile() )
-      {
-	MIL << "Never refresh CD/DVD" << endl;
-	return REPO_UP_TO_DATE;
-      }
+    if ( url.schemeIsVolatile() )
+    {
+      MIL << "Never refresh CD/DVD" << endl;
+      result = REPO_UP_TO_DATE;
+      return true;
+    }
 
-      if ( policy == RefreshForced )
-      {
-	MIL << "Forced refresh!" << endl;
-	return REFRESH_NEEDED;
-      }
+    if ( policy == RefreshForced )
+    {
+      MIL << "Forced refresh!" << endl;
+      result = REFRESH_NEEDED;
+      return true;
+    }
 
-      if ( url.schemeIsLocal() )
-      {
-	policy = RefreshIfNeededIgnoreDelay;
-      }
+    if ( url.schemeIsLocal() )
+    {
+      policy = RefreshIfNeededIgnoreDelay;
+    }
 
-      // now we've got the old (cached) status, we can decide repo.refresh.delay
-      if ( policy != RefreshIfNeededIgnoreDelay )
-      {
-        // difference in seconds
-        double diff = difftime(
-          (Date::ValueType)Date::now(),
-          (Date::ValueType)oldstatus.timestamp()) / 60;
+    // now we've got the old (cached) status, we can decide repo.refresh.delay
+    if ( policy != RefreshIfNeededIgnoreDelay )
+    {
+      // difference in seconds
+      double diff = difftime(
+        (Date::ValueType)Date::now(),
+        (Date::ValueType)oldstatus.timestamp()) / 60;
 
-        DBG << "oldstatus: " << (Date::ValueType)oldstatus.timestamp() << endl;
-        DBG << "current time: " << (Date::ValueType)Date::now() << endl;
-        DBG << "last refresh = " << diff << " minutes ago" << endl;
+      DBG << "oldstatus: " << (Date::ValueType)oldstatus.timestamp() << endl;
+      DBG << "current time: " << (Date::ValueType)Date::now() << endl;
+      DBG << "last refresh = " << diff << " minutes ago" << endl;
 
-        if ( diff < ZConfig::instance().repo_refresh_delay() )
+      if ( diff < ZConfig::instance().repo_refresh_delay() )
+      {
+        if ( diff < 0 )
         {
-	  if ( diff < 0 )
-	  {
-	    WAR << "Repository '" << info.alias() << "' was refreshed in the future!" << endl;
-	  }
-	  else
-	  {
-	    MIL << "Repository '" << info.alias()
-		<< "' has been refreshed less than repo.refresh.delay ("
-		<< ZConfig::instance().repo_refresh_delay()
-		<< ") minutes ago. Advising to skip refresh" << endl;
-	    return REPO_CHECK_DELAYED;
-	  }
+          WAR << "Repository '" << info.alias() << "' was refreshed in the future!" << endl;
+        }
+        else
+        {
+          MIL << "Repository '" << info.alias()
+              << "' has been refreshed less than repo.refresh.delay ("
+              << ZConfig::instance().repo_refresh_delay()
+              << ") minutes ago. Advising to skip refresh" << endl;
+          result = REPO_CHECK_DELAYED;
+          return true;
         }
       }
+    }
+    return false;
+  }
+
+  RepoManager::RefreshCheckStatus RepoManager::Impl::checkIfToRefreshMetadata( const RepoInfo & info, const Url & url, RawMetadataRefreshPolicy policy )
+  {
+    assert_alias(info);
+    try
+    {
+      MIL << "Going to try to check whether refresh is needed for " << url << " (" << info.type() << ")" << endl;
+
+      RepoStatus oldstatus;
+      RefreshCheckStatus result;
+      if ( checkIfToRefreshMetadataLocally( info, url, policy, oldstatus, result ) )
+        return result;
 
+      Pathname mediarootpath = rawcache_path_for_repoinfo( _options, info );
       repo::RepoType repokind = info.type();
       // if unknown: probe it
       if ( repokind == RepoType::NONE )
@@ -1050,7 +1081,7 @@ namespace zypp
 	break;
 
 	case RepoType::RPMPLAINDIR_e:
-	  newstatus = RepoStatus( MediaMounter(url).getPathName(info.path()) );	// dir status
+	  newstatus = RepoStatus::fromDirectory( MediaMounter(url).getPathName(info.path()), oldstatus );	// dir status
 	  break;
 
 	default:
@@ -1083,6 +1114,206 @@ namespace zypp
   }
 
 
+  ///////////////////////////////////////////////////////////////////
+  namespace
+  {
+    /** Request downloading \a file_r relative to the repos \a url_r into \a target_r.
+     * Transfer settings are taken from the url like \ref media::MediaCurl does.
+     */
+    zyppng::NetworkRequest::Ptr masterIndexRequest( const Url & url_r, const Pathname & file_r, const Pathname & target_r )
+    {
+      // see MediaCurl::getFileUrl
+      Url fileurl( url_r );
+      fileurl.setPathName( ( Pathname("./"+url_r.getPathName()) / file_r ).asString().substr(1) );
+
+      auto req = std::make_shared<zyppng::NetworkRequest>( internal::clearQueryString( fileurl ), target_r );
+      media::TransferSettings & settings { req->transferSettings() };
+      internal::fillSettingsFromUrl( url_r, settings );
+      if ( settings.proxy().empty() )
+        internal::fillSettingsSystemProxy( url_r, settings );
+      return req;
+    }
+
+    /** 1 if downloaded, 0 if not on the server, -1 if the request failed otherwise (or was not sent). */
+    int masterIndexFound( const zyppng::NetworkRequest::Ptr & req_r )
+    {
+      if ( ! req_r )
+        return -1;
+      if ( ! req_r->hasError() )
+        return 1;
+      if ( req_r->error().type() == zyppng::NetworkRequestError::NotFound )
+        return 0;
+      DBG << req_r->url() << ": " << req_r->error().toString() << endl;
+      return -1;
+    }
+  } // namespace
+  ///////////////////////////////////////////////////////////////////
+
+  std::map<std::string,RepoManager::RefreshCheckStatus> RepoManager::Impl::checkIfToRefreshMetadata( const std::list<RepoInfo> & repos, RawMetadataRefreshPolicy policy )
+  {
+    std::map<std::string,RefreshCheckStatus> ret;
+
+    // Repos needing a remote check. Those we can't do concurrently
+    // (no http/ftp, plaindir, needing authentication, errors...) are
+    // finally checked one by one.
+    struct Check
+    {
+      RepoInfo _info;
+      Url _url;
+      RepoStatus _oldstatus;
+      zyppng::NetworkRequest::Ptr _repomd;	// RPMMD
+      zyppng::NetworkRequest::Ptr _content;	// YAST2
+      zyppng::NetworkRequest::Ptr _media;	// optional /media.1/media
+    };
+    std::vector<Check> checks;
+    std::vector<RepoInfo> serial;
+
+    // Don't interfere with an event loop the application may run in this thread.
+    bool concurrent = ! zyppng::EventDispatcher::instance();
+    zyppng::EventDispatcher::Ptr ev;
+    if ( concurrent )
+      ev = zyppng::EventDispatcher::createForThread( zyppng::EventDispatcher::EpollBackend );
+    filesystem::TmpDir tmpdir;
+
+    for ( const RepoInfo & info : repos )
+    {
+      assert_alias( info );
+      if ( info.baseUrlsEmpty() )
+      {
+        ret[info.alias()] = REFRESH_NEEDED;	// refreshMetadata will complain
+        continue;
+      }
+
+      Check check { info, *info.baseUrlsBegin() };
+      MIL << "Going to try to check whether refresh is needed for " << check._url << " (" << info.type() << ")" << endl;
+      RefreshCheckStatus result;
+      if ( checkIfToRefreshMetadataLocally( info, check._url, policy, check._oldstatus, result ) )
+      {
+        ret[info.alias()] = result;
+        continue;
+      }
+
+      repo::RepoType repokind = info.type();
+      if ( ! concurrent
+           || ! ( repokind == RepoType::NONE || repokind == RepoType::RPMMD || repokind == RepoType::YAST2 )
+           || ! check._url.schemeIsDownloading()
+           || ! zyppng::NetworkRequestDispatcher::supportsProtocol( check._url ) )
+      {
+        serial.push_back( info );
+        continue;
+      }
+
+      try
+      {
+        const Pathname target { tmpdir.path() / str::numstring( checks.size() ) };
+        filesystem::assert_dir( target );
+        if ( repokind != RepoType::YAST2 )
+          check._repomd = masterIndexRequest( check._url, info.path() / "/repodata/repomd.xml", target / "repomd.xml" );
+        if ( repokind != RepoType::RPMMD )
+          check._content = masterIndexRequest( check._url, info.path() / "/content", target / "content" );
+        check._media = masterIndexRequest( check._url, "/media.1/media", target / "media" );
+        checks.push_back( std::move(check) );
+      }
+      catch ( const Exception & excpt )
+      {
+        ZYPP_CAUGHT( excpt );	// e.g. bad url query parameters; let the serial check report it
+        serial.push_back( info );
+      }
+    }
+
+    if ( ! checks.empty() )
+    {
+      zyppng::NetworkRequestDispatcher disp;
+      disp.setMaximumConcurrentConnections( std::max( ZConfig::instance().download_max_concurrent_connections(), 1L ) );
+      disp.sigQueueFinished().connect( [&ev]( zyppng::NetworkRequestDispatcher & ){ ev->quit(); } );
+      for ( const Check & check : checks )
+      {
+        for ( const auto & req : { check._repomd, check._content, check._media } )
+        {
+          if ( req )
+            disp.enqueue( req );
+        }
+      }
+      MIL << "Checking " << checks.size() << " repos concurrently..." << endl;
+      disp.run();
+      ev->run();
+    }
+
+    for ( const Check & check : checks )
+    {
+      const RepoInfo & info { check._info };
+      repo::RepoType repokind = info.type();
+      if ( repokind == RepoType::NONE )
+      {
+        // probe like RepoManager::Impl::probe does
+        if ( masterIndexFound( check._repomd ) == 1 )
+          repokind = RepoType::RPMMD;
+        else if ( masterIndexFound( check._content ) == 1 )
+          repokind = RepoType::YAST2;
+        else
+        {
+          serial.push_back( info );
+          continue;
+        }
+      }
+
+      const zyppng::NetworkRequest::Ptr & master { repokind == RepoType::RPMMD ? check._repomd : check._content };
+      int masterFound = masterIndexFound( master );
+      int mediaFound = masterIndexFound( check._media );
+      if ( masterFound < 0 || mediaFound < 0 )
+      {
+        serial.push_back( info );
+        continue;
+      }
+
+      // like the Downloaders status()
+      RepoStatus newstatus;
+      if ( masterFound )	// else: mandatory master index is missing -> stay empty
+      {
+        newstatus = RepoStatus( master->targetFilePath() );
+        if ( mediaFound )
+          newstatus = newstatus && RepoStatus( check._media->targetFilePath() );
+      }
+
+      if ( check._oldstatus == newstatus )
+      {
+        MIL << info.alias() << ": repo has not changed" << endl;
+        touchIndexFile( info );
+        ret[info.alias()] = REPO_UP_TO_DATE;
+      }
+      else
+      {
+        MIL << info.alias() << ": repo has changed, going to refresh" << endl;
+        ret[info.alias()] = REFRESH_NEEDED;
+      }
+    }
+    ev.reset();
+
+    for ( const RepoInfo & info : serial )
+    {
+      RefreshCheckStatus & result { ret[info.alias()] };
+      result = REFRESH_NEEDED;	// if no url checks out fine, refreshMetadata will report it
+
+      // Suppress (interactive) media::MediaChangeReport if we in have multiple basurls (>1)
+      media::ScopedDisableMediaChangeReport guard( info.baseUrlsSize() > 1 );
+      for ( const Url & url : info.baseUrls() )
+      {
+        try
+        {
+          result = checkIfToRefreshMetadata( info, url, policy );
+          break;
+        }
+        catch ( const Exception & excpt )
+        {
+          ZYPP_CAUGHT( excpt );
+          ERR << "*** Repository '" << info.alias() << "': " << url << " doesn't look good. Trying another url." << endl;
+        }
+      }
+    }
+
+    return ret;
+  }
+
   void RepoManager::Impl::refreshMetadata( const RepoInfo & info, RawMetadataRefreshPolicy policy, const ProgressData::ReceiverFnc & progress )
   {
     assert_alias(info);
@@ -1184,7 +1415,8 @@ namespace zypp
         else if ( repokind.toEnum() == RepoType::RPMPLAINDIR_e )
         {
           MediaMounter media( url );
-          RepoStatus newstatus = RepoStatus( media.getPathName( info.path() ) );	// dir status
+          // reuse the file digests of the last refresh for unchanged files
+          RepoStatus newstatus = RepoStatus::fromDirectory( media.getPathName( info.path() ), metadataStatus( info ) );	// dir status
 
           Pathname productpath( tmpdir.path() / info.path() );
           filesystem::assert_dir( productpath );
@@ -1267,10 +1499,11 @@ namespace zypp
     }
 
     bool needs_cleaning = false;
+    RepoStatus cache_status;
     if ( isCached( info ) )
     {
       MIL << info.alias() << " is already cached." << endl;
-      RepoStatus cache_status = cacheStatus(info);
+      cache_status = cacheStatus(info);
 
       if ( cache_status == raw_metadata_status )
       {
@@ -1281,6 +1514,8 @@ namespace zypp
 	  const Pathname & base = solv_path_for_repoinfo( _options, info);
 	  if ( ! PathInfo(base/"solv.idx").isExist() )
 	    sat::updateSolvFileIndex( base/"solv" );
+	  if ( ZConfig::instance().repo_searchindex() && ! PathInfo(base/"solv.trigrams").isExist() )
+	    sat::updateSolvFileSearchIndex( base/"solv" );
 
 	  return;
         }
@@ -1298,8 +1533,15 @@ namespace zypp
     progress.name(str::form(_("Building repository '%s' cache"), info.label().c_str()));
     progress.toMin();
 
+    filesystem::TmpPath oldsolvdir;	// plaindir: keeps the old solv file for an incremental update
     if (needs_cleaning)
     {
+      if ( ! cache_status.fileTable().empty() )
+      {
+	oldsolvdir = filesystem::TmpDir( _options.repoCachePath );
+	if ( filesystem::hardlinkCopy( solv_path_for_repoinfo( _options, info ) / "solv", oldsolvdir.path() / "solv" ) != 0 )
+	  oldsolvdir = filesystem::TmpPath();
+      }
       cleanCache(info);
     }
 
@@ -1354,9 +1596,26 @@ namespace zypp
 	cmd.push_back( "-X" );	// autogenerate pattern from pattern-package
         // bsc#1104415: no more application support // cmd.push_back( "-A" );	// autogenerate application pseudo packages
 
-        if ( repokind == RepoType::RPMPLAINDIR )
+        if ( repokind == RepoType::RPMPLAINDIR && ! raw_metadata_status.fileTable().empty() )
         {
+          // Reuse the unchanged packages of the old solv file and read the rest in parallel.
           forPlainDirs.reset( new MediaMounter( info.url() ) );
+          Pathname oldsolv( oldsolvdir.path().empty() ? Pathname() : oldsolvdir.path() / "solv" );
+          if ( repo::buildPlaindirSolv( forPlainDirs->getPathName( info.path() ), oldsolv, cache_status, raw_metadata_status, solvfile ) )
+          {
+            guard.resetDispose();
+            sat::updateSolvFileIndex( solvfile );	// content digest for zypper bash completion
+            if ( ZConfig::instance().repo_searchindex() )
+              sat::updateSolvFileSearchIndex( solvfile );
+            break;
+          }
+          WAR << "Incremental plaindir update failed, using repo2solv" << endl;
+        }
+
+        if ( repokind == RepoType::RPMPLAINDIR )
+        {
+          if ( ! forPlainDirs )
+            forPlainDirs.reset( new MediaMounter( info.url() ) );
           // recusive for plaindir as 2nd arg!
           cmd.push_back( "-R" );
           // FIXME this does only work form dir: URLs
@@ -1388,6 +1647,8 @@ namespace zypp
         // We keep it.
         guard.resetDispose();
 	sat::updateSolvFileIndex( solvfile );	// content digest for zypper bash completion
+	if ( ZConfig::instance().repo_searchindex() )
+	  sat::updateSolvFileSearchIndex( solvfile );
       }
       break;
       default:
@@ -2563,6 +2824,9 @@ namespace zypp
   RepoManager::RefreshCheckStatus RepoManager::checkIfToRefreshMetadata( const RepoInfo &info, const Url &url, RawMetadataRefreshPolicy policy )
   { return _pimpl->checkIfToRefreshMetadata( info, url, policy ); }
 
+  std::map<std::string,RepoManager::RefreshCheckStatus> RepoManager::checkIfToRefreshMetadata( const std::list<RepoInfo> & repos, RawMetadataRefreshPolicy policy )
+  { return _pimpl->checkIfToRefreshMetadata( repos, policy ); }
+
   Pathname RepoManager::metadataPath( const RepoInfo &info ) const
   { return _pimpl->metadataPath( info ); }
 
@@ -14,6 +14,7 @@
 
 #include <iosfwd>
 #include <list>
+#include <map>
 
 #include <zypp/base/PtrTypes.h>
 #include <zypp/base/Iterator.h>
@@ -257,6 +258,28 @@ namespace zypp
                                    const Url &url,
                                    RawMetadataRefreshPolicy policy = RefreshIfNeeded);
 
+    /**
+     * Checks whether to refresh metadata for many repositories at once.
+     *
+     * The result is the same as calling \ref checkIfToRefreshMetadata for
+     * each repo, trying its baseurls one by one. But the master index files
+     * of remote repos are downloaded concurrently, using at most
+     * \ref ZConfig::download_max_concurrent_connections connections.
+     * Repos which can't be checked this way (local or plaindir repos, if
+     * authentication is needed or the download failed) are checked one by
+     * one afterwards.
+     *
+     * If none of a repos baseurls can be checked, \c REFRESH_NEEDED is
+     * returned for it, so \ref refreshMetadata will report the problem.
+     *
+     * \param repos
+     * \param policy
+     * \return the \ref RefreshCheckStatus for each repo alias.
+     * \throws repo::RepoNoAliasException if a repo has no alias
+     */
+    std::map<std::string,RefreshCheckStatus> checkIfToRefreshMetadata( const std::list<RepoInfo> & repos,
+                                                                       RawMetadataRefreshPolicy policy = RefreshIfNeeded );
+
     /**
      * \short Path where the metadata is downloaded and kept
      *
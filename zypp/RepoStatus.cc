@@ -12,10 +12,12 @@
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <algorithm>
 #include <zypp/base/Logger.h>
 #include <zypp/base/String.h>
 #include <zypp/RepoStatus.h>
 #include <zypp/PathInfo.h>
+#include <zypp/Digest.h>
 
 using std::endl;
 
@@ -33,6 +35,7 @@ namespace zypp
   public:
     std::string _checksum;
     Date _timestamp;
+    FileTable _files;
 
     // NOTE: Changing magic will at once invalidate all solv file caches.
     // Helpfull if solv file content must be refreshed (e.g. due to different
@@ -68,6 +71,93 @@ namespace zypp
       }
     }
 
+    /** Recursively collect the regular files below \a dir_r into \a files_r. */
+    static void collectFiles( const Pathname & dir_r, const std::string & prefix_r, FileTable & files_r, time_t & max_r )
+    {
+      std::list<std::string> dircontent;
+      if ( filesystem::readdir( dircontent, dir_r, false/*no dots*/ ) != 0 )
+	return; // readdir logged the error
+
+      for ( const std::string & name : dircontent )
+      {
+	PathInfo pi( dir_r + name, PathInfo::LSTAT );
+	if ( pi.mtime() > max_r )
+	  max_r = pi.mtime();
+	if ( pi.isDir() )
+	  collectFiles( pi.path(), prefix_r + name + "/", files_r, max_r );
+	else if ( pi.isFile() )
+	{
+	  FileInfo file;
+	  file._path = prefix_r + name;
+	  file._inode = pi.ino();
+	  file._size = pi.size();
+	  file._mtime = pi.mtime();
+	  files_r.push_back( std::move(file) );
+	}
+      }
+    }
+
+    /** End of the signature and main header if \a file_r is an rpm, else \c 0. */
+    static unsigned long long rpmHeaderEnd( std::istream & file_r, unsigned long long size_r )
+    {
+      static const unsigned char leadMagic[]   = { 0xed, 0xab, 0xee, 0xdb };
+      static const unsigned char headerMagic[] = { 0x8e, 0xad, 0xe8 };
+      auto be32 = []( const unsigned char * p ) -> unsigned long long
+      { return ( (unsigned long long)p[0] << 24 ) | ( p[1] << 16 ) | ( p[2] << 8 ) | p[3]; };
+
+      unsigned char buf[16];
+      if ( ! file_r.read( (char *)buf, 4 ) || ! std::equal( leadMagic, leadMagic+4, buf ) )
+	return 0;
+
+      unsigned long long pos = 96;	// the lead
+      for ( unsigned hdr = 0; hdr < 2; ++hdr )	// signature and main header
+      {
+	file_r.seekg( pos );
+	if ( ! file_r.read( (char *)buf, 16 ) || ! std::equal( headerMagic, headerMagic+3, buf ) )
+	  return 0;
+	pos += 16 + 16 * be32( buf+8 ) + be32( buf+12 );	// intro + index entries + data
+	if ( hdr == 0 )
+	  pos = ( pos + 7 ) & ~7ULL;	// the signature is padded to 8 bytes
+	if ( pos > size_r )
+	  return 0;
+      }
+      return pos;
+    }
+
+    /** Binary sha1 of the files head and last 64K. The head is at least
+     * 64K, for rpms it is the lead, the signature and the whole main header
+     * (including the payload digest).
+     */
+    static std::string fileDigest( const Pathname & file_r, unsigned long long size_r )
+    {
+      static const unsigned long long chunk = 64 * 1024;
+      std::ifstream file( file_r.c_str(), std::ios::binary );
+      if ( ! file )
+	return std::string();
+
+      unsigned long long head = std::max( rpmHeaderEnd( file, size_r ), chunk );
+      file.clear();
+
+      Digest digest;
+      digest.create( Digest::sha1() );
+      std::vector<char> buf( chunk );
+      auto hashRange = [&]( unsigned long long from_r, unsigned long long to_r ) {
+	file.seekg( from_r );
+	while ( from_r < to_r && file.read( buf.data(), std::min( chunk, to_r - from_r ) ).gcount() > 0 )
+	{
+	  digest.update( buf.data(), file.gcount() );
+	  from_r += file.gcount();
+	}
+	file.clear();
+      };
+      hashRange( 0, std::min( head, size_r ) );
+      if ( size_r > head )
+	hashRange( std::max( head, size_r - chunk ), size_r );
+
+      std::vector<unsigned char> ret { digest.digestVector() };
+      return std::string( ret.begin(), ret.end() );
+    }
+
   private:
     friend Impl * rwcowClone<Impl>( const Impl * rhs );
     /** clone for RWCOW_pointer */
@@ -118,14 +208,158 @@ namespace zypp
   RepoStatus::~RepoStatus()
   {}
 
+  RepoStatus RepoStatus::fromDirectory( const Pathname & dir_r, const RepoStatus & previous_r )
+  {
+    RepoStatus ret;
+    PathInfo info( dir_r );
+    if ( ! info.isDir() )
+      return ret;
+
+    time_t t = info.mtime();
+    FileTable files;
+    Impl::collectFiles( dir_r, std::string(), files, t );
+    std::sort( files.begin(), files.end(), []( const FileInfo & lhs, const FileInfo & rhs ) { return lhs._path < rhs._path; } );
+
+    const FileTable & prevfiles { previous_r.fileTable() };
+    auto prev = prevfiles.begin();
+    unsigned reused = 0;
+    std::string sum;
+    for ( FileInfo & file : files )
+    {
+      while ( prev != prevfiles.end() && prev->_path < file._path )
+	++prev;
+      if ( prev != prevfiles.end() && prev->_path == file._path
+	   && prev->_inode == file._inode && prev->_size == file._size && prev->_mtime == file._mtime )
+      {
+	file._digest = prev->_digest;
+	++reused;
+      }
+      else
+	file._digest = Impl::fileDigest( dir_r / file._path, file._size );
+
+      sum += file._path;
+      sum += '\0';
+      sum += str::numstring( file._size );
+      sum += ' ';
+      sum += str::numstring( file._mtime );
+      sum += ' ';
+      sum += file._digest;
+    }
+    MIL << "Dir status " << dir_r << ": " << files.size() << " files, " << ( files.size() - reused ) << " digests computed" << endl;
+
+    ret._pimpl->assignFromCtor( CheckSum::sha1FromString( sum ).checksum(), Date( t ) );
+    ret._pimpl->_files = std::move(files);
+    return ret;
+  }
+
+  const RepoStatus::FileTable & RepoStatus::fileTable() const
+  { return _pimpl->_files; }
+
+  RepoStatus::FileChanges RepoStatus::fileChanges( const RepoStatus & old_r, const RepoStatus & new_r )
+  {
+    FileChanges ret;
+    const FileTable & oldfiles { old_r.fileTable() };
+    const FileTable & newfiles { new_r.fileTable() };
+    auto oit = oldfiles.begin();
+    auto nit = newfiles.begin();
+    while ( oit != oldfiles.end() || nit != newfiles.end() )
+    {
+      if ( nit == newfiles.end() || ( oit != oldfiles.end() && oit->_path < nit->_path ) )
+	ret._removed.push_back( (oit++)->_path );
+      else if ( oit == oldfiles.end() || nit->_path < oit->_path )
+	ret._added.push_back( (nit++)->_path );
+      else
+      {
+	if ( oit->_size != nit->_size || oit->_mtime != nit->_mtime || oit->_digest != nit->_digest )
+	  ret._changed.push_back( nit->_path );
+	++oit;
+	++nit;
+      }
+    }
+    return ret;
+  }
+
+  ///////////////////////////////////////////////////////////////////
+  namespace
+  {
+    // Binary cookie:
+    //   magic "\0ZRS" version(1)
+    //   checksum(str) timestamp(64) count(32)
+    //   count * { path(str) inode(64) size(64) mtime(64) digest(str) }
+    // Integers are little endian, str is a 16 bit length followed by the bytes.
+    const char binaryCookieMagic[] = { '\0', 'Z', 'R', 'S', '\1' };
+
+    template <class TInt>
+    void putInt( std::ostream & str_r, TInt val_r, unsigned bytes_r = sizeof(TInt) )
+    {
+      unsigned long long val = val_r;
+      for ( unsigned i = 0; i < bytes_r; ++i, val >>= 8 )
+	str_r.put( char( val & 0xff ) );
+    }
+
+    void putStr( std::ostream & str_r, const std::string & val_r )
+    {
+      putInt( str_r, val_r.size(), 2 );
+      str_r.write( val_r.data(), val_r.size() );
+    }
+
+    template <class TInt>
+    bool getInt( std::istream & str_r, TInt & val_r, unsigned bytes_r = sizeof(TInt) )
+    {
+      unsigned long long val = 0;
+      for ( unsigned i = 0; i < bytes_r; ++i )
+      {
+	int ch = str_r.get();
+	if ( ch == EOF )
+	  return false;
+	val |= (unsigned long long)( ch & 0xff ) << ( 8 * i );
+      }
+      val_r = TInt( val );
+      return true;
+    }
+
+    bool getStr( std::istream & str_r, std::string & val_r )
+    {
+      unsigned len = 0;
+      if ( ! getInt( str_r, len, 2 ) )
+	return false;
+      val_r.resize( len );
+      return str_r.read( &val_r[0], len ).gcount() == len;
+    }
+  } // namespace
+  ///////////////////////////////////////////////////////////////////
+
   RepoStatus RepoStatus::fromCookieFile( const Pathname & path_r )
   {
     RepoStatus ret;
-    std::ifstream file( path_r.c_str() );
+    std::ifstream file( path_r.c_str(), std::ios::binary );
     if ( !file )
     {
       WAR << "No cookie file " << path_r << endl;
     }
+    else if ( file.peek() == binaryCookieMagic[0] )
+    {
+      char magic[sizeof(binaryCookieMagic)];
+      long long timestamp = 0;
+      unsigned count = 0;
+      Impl & impl { *ret._pimpl };
+      bool ok = file.read( magic, sizeof(magic) ) && std::equal( magic, magic+sizeof(magic), binaryCookieMagic )
+	     && getStr( file, impl._checksum ) && getInt( file, timestamp, 8 ) && getInt( file, count, 4 );
+      impl._timestamp = Date( timestamp );
+      // No reserve( count ): a broken cookie file must not make us allocate GBs.
+      for ( unsigned i = 0; ok && i < count; ++i )
+      {
+	FileInfo info;
+	ok = getStr( file, info._path ) && getInt( file, info._inode, 8 ) && getInt( file, info._size, 8 )
+	  && getInt( file, info._mtime, 8 ) && getStr( file, info._digest );
+	impl._files.push_back( std::move(info) );
+      }
+      if ( ! ok )
+      {
+	WAR << "Broken cookie file " << path_r << endl;
+	ret = RepoStatus();
+      }
+    }
     else
     {
       // line := "[checksum] time_t"
@@ -138,12 +372,33 @@ namespace zypp
 
   void RepoStatus::saveToCookieFile( const Pathname & path_r ) const
   {
-    std::ofstream file(path_r.c_str());
+    std::ofstream file( path_r.c_str(), std::ios::binary );
     if (!file) {
       ZYPP_THROW (Exception( "Can't open " + path_r.asString() ) );
     }
-    file << _pimpl->_checksum << " " << (time_t)_pimpl->_timestamp << endl;
+    if ( _pimpl->_files.empty() )
+    {
+      file << _pimpl->_checksum << " " << (time_t)_pimpl->_timestamp << endl;
+    }
+    else
+    {
+      file.write( binaryCookieMagic, sizeof(binaryCookieMagic) );
+      putStr( file, _pimpl->_checksum );
+      putInt( file, (long long)(time_t)_pimpl->_timestamp, 8 );
+      putInt( file, _pimpl->_files.size(), 4 );
+      for ( const FileInfo & info : _pimpl->_files )
+      {
+	putStr( file, info._path );
+	putInt( file, info._inode, 8 );
+	putInt( file, info._size, 8 );
+	putInt( file, info._mtime, 8 );
+	putStr( file, info._digest );
+      }
+    }
     file.close();
+    if ( !file ) {
+      ZYPP_THROW (Exception( "Can't write " + path_r.asString() ) );
+    }
   }
 
   bool RepoStatus::empty() const
@@ -13,6 +13,8 @@
 #define ZYPP2_REPOSTATUS_H
 
 #include <iosfwd>
+#include <string>
+#include <vector>
 #include <zypp/base/PtrTypes.h>
 #include <zypp/CheckSum.h>
 #include <zypp/Date.h>
@@ -34,6 +36,10 @@ namespace zypp
   /// The checksum however is an implementation detail and of no
   /// use outside this class. \ref operator== tells if the checksums
   /// of two rRepoStatus are the same.
+  ///
+  /// A status built by \ref fromDirectory also remembers each file
+  /// in the directory (\ref fileTable), so \ref fileChanges can tell
+  /// which files were added, removed or changed.
   ///////////////////////////////////////////////////////////////////
   class RepoStatus
   {
@@ -55,6 +61,18 @@ namespace zypp
     /** Explicitly specify checksum string and timestamp to use. */
     RepoStatus( std::string checksum_r, Date timestamp_r );
 
+    /** Compute status for a directory (recursively) including a \ref fileTable.
+     *
+     * The checksum covers each files path, size, mtime and digest.
+     * Digests of files whose inode, size and mtime did not change
+     * since \a previous_r are taken from there, so only new or
+     * changed files are read.
+     *
+     * \note Construction from a non existing directory will result
+     * in an empty status.
+     */
+    static RepoStatus fromDirectory( const Pathname & dir_r, const RepoStatus & previous_r = RepoStatus() );
+
     /** Dtor */
     ~RepoStatus();
 
@@ -67,11 +85,47 @@ namespace zypp
     static RepoStatus fromCookieFile( const Pathname & path );
 
     /** Save the status information to a cookie file
+     *
+     * A status with a \ref fileTable is stored in a compact binary
+     * format, otherwise as a single \c "checksum timestamp" line.
+     * \ref fromCookieFile reads both.
+     *
      * \throws Exception if the file can't be saved
      * \see \ref fromCookieFile
      */
     void saveToCookieFile( const Pathname & path_r ) const;
 
+  public:
+    /** A file remembered in the \ref fileTable. */
+    struct FileInfo
+    {
+      std::string _path;		///< path relative to the directory
+      unsigned long long _inode = 0;
+      unsigned long long _size = 0;
+      time_t _mtime = 0;
+      std::string _digest;		///< binary sha1 of the files head (at least 64K, for rpms up to the end of the main header) and last 64K
+    };
+    typedef std::vector<FileInfo> FileTable;
+
+    /** Files in a directory status, sorted by path.
+     * Empty unless built by \ref fromDirectory (or read from its cookie).
+     */
+    const FileTable & fileTable() const;
+
+    /** Paths of the files added, removed or changed between two \ref fileTable. */
+    struct FileChanges
+    {
+      std::vector<std::string> _added;
+      std::vector<std::string> _removed;
+      std::vector<std::string> _changed;
+
+      bool empty() const
+      { return _added.empty() && _removed.empty() && _changed.empty(); }
+    };
+
+    /** Compare the \ref fileTable of \a old_r and \a new_r. */
+    static FileChanges fileChanges( const RepoStatus & old_r, const RepoStatus & new_r );
+
   public:
     /** Whether the status is empty (default constucted) */
     bool empty() const;
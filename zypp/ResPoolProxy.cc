@@ -103,7 +103,66 @@ namespace zypp
 
     Impl( ResPool pool_r, const pool::PoolImpl & poolImpl_r )
     : _pool( pool_r )
+    { build( poolImpl_r ); }
+
+    /** Take over the Selectables of \a prev_r, except for those
+     * whose items changed (\ref pool::PoolImpl::touchedIdents).
+     * If a repos priority changed, the order of available items may
+     * have changed for all of them, so all are built from scratch.
+     */
+    Impl( ResPool pool_r, const pool::PoolImpl & poolImpl_r, const Impl & prev_r )
+    : _pool( pool_r )
+    {
+      for ( const Repository & repo : _pool.knownRepositories() )
+      {
+        auto it( prev_r._repoPriorities.find( repo ) );
+        if ( it != prev_r._repoPriorities.end() && it->second != repo.satInternalPriority() )
+        {
+          MIL << "Priority of " << repo << " changed. Rebuild all Selectables." << endl;
+          build( poolImpl_r );
+          return;
+        }
+      }
+      rememberRepoPriorities();
+
+      const pool::PoolImpl::Id2ItemT & id2item( poolImpl_r.id2item() );
+      const pool::PoolImpl::IdentSet & touched( poolImpl_r.touchedIdents() );
+
+      _selIndex.reserve( prev_r._selIndex.size() + touched.size() );
+      for ( const auto & sel : prev_r._selIndex )
+      {
+        if ( ! touched.count( sel.first ) )
+          insert( sel.first, sel.second );
+      }
+      for ( sat::detail::IdType ident : touched )
+      {
+        auto range( id2item.equal_range( ident ) );
+        if ( range.first != range.second )
+          insert( ident, makeSelectablePtr( range.first, range.second ) );
+      }
+      DBG << "Updated " << touched.size() << " of " << _selIndex.size() << " Selectables." << endl;
+    }
+
+  private:
+    void insert( sat::detail::IdType ident_r, const ui::Selectable::Ptr & sel_r )
+    {
+      _selPool.insert( SelectablePool::value_type( sel_r->kind(), sel_r ) );
+      _selIndex[ident_r] = sel_r;
+    }
+
+    void rememberRepoPriorities()
     {
+      _repoPriorities.clear();
+      for ( const Repository & repo : _pool.knownRepositories() )
+        _repoPriorities[repo] = repo.satInternalPriority();
+    }
+
+    void build( const pool::PoolImpl & poolImpl_r )
+    {
+      _selPool.clear();
+      _selIndex.clear();
+      rememberRepoPriorities();
+
       const pool::PoolImpl::Id2ItemT & id2item( poolImpl_r.id2item() );
       if ( ! id2item.empty() )
       {
@@ -115,17 +174,13 @@ namespace zypp
           if ( it->first != cbegin->first )
           {
             // starting a new Selectable, create the previous one
-            ui::Selectable::Ptr p( makeSelectablePtr( cbegin, it ) );
-            _selPool.insert( SelectablePool::value_type( p->kind(), p ) );
-            _selIndex[cbegin->first] = p;
+            insert( cbegin->first, makeSelectablePtr( cbegin, it ) );
             // remember new startpoint
             cbegin = it;
           }
         }
         // create the final one
-        ui::Selectable::Ptr p( makeSelectablePtr( cbegin, id2item.end() ) );
-        _selPool.insert( SelectablePool::value_type( p->kind(), p ) );
-        _selIndex[cbegin->first] = p;
+        insert( cbegin->first, makeSelectablePtr( cbegin, id2item.end() ) );
       }
     }
 
@@ -198,6 +253,7 @@ namespace zypp
     ResPool _pool;
     mutable SelectablePool _selPool;
     mutable SelectableIndex _selIndex;
+    std::map<Repository,int> _repoPriorities;	///< to detect changes which reorder all Selectables
 
   public:
     /** Offer default Impl. */
@@ -258,6 +314,15 @@ namespace zypp
   : _pimpl( new Impl( pool_r, poolImpl_r ) )
   {}
 
+  ///////////////////////////////////////////////////////////////////
+  //
+  //	METHOD NAME : ResPoolProxy::ResPoolProxy
+  //	METHOD TYPE : Ctor
+  //
+  ResPoolProxy::ResPoolProxy( ResPool pool_r, const pool::PoolImpl & poolImpl_r, const ResPoolProxy & prev_r )
+  : _pimpl( new Impl( pool_r, poolImpl_r, *prev_r._pimpl ) )
+  {}
+
   ///////////////////////////////////////////////////////////////////
   //
   //	METHOD NAME : ResPoolProxy::~ResPoolProxy
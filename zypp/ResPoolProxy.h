@@ -247,6 +247,8 @@ namespace zypp
     friend class pool::PoolImpl;
     /** Ctor */
     ResPoolProxy( ResPool pool_r, const pool::PoolImpl & poolImpl_r );
+    /** Ctor updating the \ref ui::Selectable of \a prev_r for the changed pool. */
+    ResPoolProxy( ResPool pool_r, const pool::PoolImpl & poolImpl_r, const ResPoolProxy & prev_r );
     /** Pointer to implementation */
     RW_pointer<Impl> _pimpl;
   };
@@ -80,6 +80,7 @@ namespace zypp
     std::string		_details;
     ProblemSolutionList	_solutions;
     std::vector<std::string> _completeProblemInfo;
+    Compute		_compute;	//< pending lazy computation
 
   private:
     friend Impl * rwcowClone<Impl>( const Impl * rhs );
@@ -105,21 +106,36 @@ namespace zypp
       : _pimpl( new Impl( std::move(description), std::move(details), std::move(completeProblemInfo) ) )
   {}
 
+  ResolverProblem::ResolverProblem( Compute compute_r )
+  : _pimpl( new Impl() )
+  { _pimpl->_compute = std::move(compute_r); }
+
   ResolverProblem::~ResolverProblem()
   {}
 
+  void ResolverProblem::compute() const
+  {
+    if ( _pimpl->_compute )
+    {
+      // Logically const; the setters used by the function must not recurse into compute.
+      ResolverProblem & self( const_cast<ResolverProblem &>(*this) );
+      Compute compute;
+      compute.swap( self._pimpl->_compute );
+      compute( self );
+    }
+  }
 
   const std::string & ResolverProblem::description() const
-  { return _pimpl->_description; }
+  { compute(); return _pimpl->_description; }
 
   const std::string & ResolverProblem::details() const
-  { return _pimpl->_details; }
+  { compute(); return _pimpl->_details; }
 
   const ProblemSolutionList & ResolverProblem::solutions() const
-  { return _pimpl->_solutions; }
+  { compute(); return _pimpl->_solutions; }
 
   const std::vector<std::string> & ResolverProblem::completeProblemInfo() const
-  { return _pimpl->_completeProblemInfo; }
+  { compute(); return _pimpl->_completeProblemInfo; }
 
   void ResolverProblem::setDescription( std::string description )
   { _pimpl->_description = std::move(description); }
@@ -127,6 +143,9 @@ namespace zypp
   void ResolverProblem::setDetails( std::string details )
   { _pimpl->_details = std::move(details); }
 
+  void ResolverProblem::setCompleteProblemInfo( std::vector<std::string> completeProblemInfo )
+  { _pimpl->_completeProblemInfo = std::move(completeProblemInfo); }
+
   void ResolverProblem::addSolution( ProblemSolution_Ptr solution, bool inFront )
   {
     if ( ! solutionInList( _pimpl->_solutions, solution ) )	// bsc#985674: filter duplicate solutions
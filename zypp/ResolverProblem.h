@@ -9,6 +9,7 @@
 #ifndef ZYPP_RESOLVERPROBLEM_H
 #define ZYPP_RESOLVERPROBLEM_H
 
+#include <functional>
 #include <list>
 #include <string>
 #include <vector>
@@ -35,6 +36,16 @@ namespace zypp
     /** Constructor. */
     ResolverProblem( std::string description, std::string details, std::vector<std::string> &&completeProblemInfo );
 
+    /** Function filling in a lazily computed problem. */
+    typedef std::function<void(ResolverProblem &)> Compute;
+
+    /** Constructor for a lazily computed problem.
+     *  compute_r is invoked (once) when the problem data are first accessed.
+     * Until then the problem is just a cheap placeholder, so computing a list of
+     * problems does not need to evaluate all solutions up front.
+     */
+    ResolverProblem( Compute compute_r );
+
     /** Destructor. */
     ~ResolverProblem();
 
@@ -82,12 +93,21 @@ namespace zypp
      **/
     void setDetails( std::string details );
 
+    /**
+     * Set the one-line descriptions of the problematic rules.
+     **/
+    void setCompleteProblemInfo( std::vector<std::string> completeProblemInfo );
+
     /**
      * Add a solution to this problem. This class takes over ownership of
      * the problem and will delete it when neccessary.
      **/
     void addSolution( ProblemSolution_Ptr solution, bool inFront = false );
 
+  private:
+    /** Invoke a pending \ref Compute function. */
+    void compute() const;
+
   private:
     struct Impl;
     RWCOW_pointer<Impl> _pimpl;
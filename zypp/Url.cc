@@ -14,7 +14,7 @@
 #include <zypp/Pathname.h>
 #include <zypp/base/Gettext.h>
 #include <zypp/base/String.h>
-#include <zypp/base/Regex.h>
+#include <algorithm>
 #include <stdexcept>
 #include <iostream>
 
@@ -371,40 +371,51 @@ namespace zypp
   Url::parseUrl(const std::string &encodedUrl)
   {
     UrlRef      url;
-    str::smatch out;
-    bool        ret = false;
 
-    try
+    // Split like RX_SPLIT_URL would, without compiling it on each call.
+    std::string::size_type pos = 0;
+    std::string::size_type end = encodedUrl.find_first_of(":/?#");
+
+    std::string scheme;
+    if( end != std::string::npos && end > 0 && encodedUrl[end] == ':')
+    {
+      scheme = encodedUrl.substr(0, end);
+      pos = end + 1;
+    }
+
+    std::string authority;
+    if( encodedUrl.compare(pos, 2, "//") == 0)
     {
-      str::regex  rex(RX_SPLIT_URL);
-      ret = str::regex_match(encodedUrl, out, rex);
+      end = std::min( encodedUrl.find_first_of("/?#", pos + 2), encodedUrl.size());
+      authority = encodedUrl.substr(pos + 2, end - pos - 2);
+      pos = end;
     }
-    catch( ... )
-    {}
 
-    if(ret && out.size() == 6)
+    end = std::min( encodedUrl.find_first_of("?#", pos), encodedUrl.size());
+    std::string pathname( encodedUrl.substr(pos, end - pos));
+    pos = end;
+
+    std::string query;
+    if( pos < encodedUrl.size() && encodedUrl[pos] == '?')
     {
-      std::string scheme = out[1];
-      if (scheme.size() > 1)
-        scheme = scheme.substr(0, scheme.size()-1);
-      std::string authority = out[2];
-      if (authority.size() >= 2)
-        authority = authority.substr(2);
-      std::string query = out[4];
+      end = std::min( encodedUrl.find('#', pos), encodedUrl.size());
+      query = encodedUrl.substr(pos, end - pos);
       if (query.size() > 1)
         query = query.substr(1);
-      std::string fragment = out[5];
-      if (fragment.size() > 1)
-        fragment = fragment.substr(1);
+      pos = end;
+    }
 
-      url = g_urlSchemeRepository().getUrlByScheme(scheme);
-      if( !url)
-      {
-        url.reset( new UrlBase());
-      }
-      url->init(scheme, authority, out[3],
-                query, fragment);
+    std::string fragment( encodedUrl.substr(pos));
+    if (fragment.size() > 1)
+      fragment = fragment.substr(1);
+
+    url = g_urlSchemeRepository().getUrlByScheme(scheme);
+    if( !url)
+    {
+      url.reset( new UrlBase());
     }
+    url->init(scheme, authority, pathname,
+              query, fragment);
     return url;
   }
 
@@ -312,11 +312,13 @@ namespace zypp
         , updateMessagesNotify		( "" )
         , repo_add_probe          	( false )
         , repo_refresh_delay      	( 10 )
+        , repo_searchindex        	( false )
         , repoLabelIsAlias              ( false )
         , download_use_deltarpm   	( true )
         , download_use_deltarpm_always  ( false )
         , download_media_prefer_download( true )
 	, download_mediaMountdir	( "/var/adm/mount" )
+        , download_persist_checksums	( false )
         , download_max_concurrent_connections( 5 )
         , download_min_download_speed	( 0 )
         , download_max_download_speed	( 0 )
@@ -420,6 +422,10 @@ namespace zypp
                 {
                   str::strtonum(value, repo_refresh_delay);
                 }
+                else if ( entry == "repo.searchindex" )
+                {
+                  repo_searchindex = str::strToBool( value, repo_searchindex );
+                }
                 else if ( entry == "repo.refresh.locales" )
 		{
 		  std::vector<std::string> tmp;
@@ -449,6 +455,11 @@ namespace zypp
 		  download_mediaMountdir.restoreToDefault( Pathname(value) );
                 }
 
+                else if ( entry == "download.persist_checksums" )
+                {
+                  download_persist_checksums.restoreToDefault( str::strToBool( value, download_persist_checksums ) );
+                }
+
                 else if ( entry == "download.max_concurrent_connections" )
                 {
                   str::strtonum(value, download_max_concurrent_connections);
@@ -651,6 +662,7 @@ namespace zypp
 
     bool	repo_add_probe;
     unsigned	repo_refresh_delay;
+    bool	repo_searchindex;
     LocaleSet	repoRefreshLocales;
     bool	repoLabelIsAlias;
 
@@ -658,6 +670,7 @@ namespace zypp
     bool download_use_deltarpm_always;
     DefaultOption<bool> download_media_prefer_download;
     DefaultOption<Pathname> download_mediaMountdir;
+    DefaultOption<bool> download_persist_checksums;
 
     int download_max_concurrent_connections;
     int download_min_download_speed;
@@ -1019,6 +1032,9 @@ namespace zypp
   unsigned ZConfig::repo_refresh_delay() const
   { return _pimpl->repo_refresh_delay; }
 
+  bool ZConfig::repo_searchindex() const
+  { return _pimpl->repo_searchindex; }
+
   LocaleSet ZConfig::repoRefreshLocales() const
   { return _pimpl->repoRefreshLocales.empty() ? Target::requestedLocales("") :_pimpl->repoRefreshLocales; }
 
@@ -1034,6 +1050,9 @@ namespace zypp
   bool ZConfig::download_use_deltarpm_always() const
   { return download_use_deltarpm() && _pimpl->download_use_deltarpm_always; }
 
+  void ZConfig::set_download_use_deltarpm_always( bool yesno_r )
+  { _pimpl->download_use_deltarpm_always = yesno_r; }
+
   bool ZConfig::download_media_prefer_download() const
   { return _pimpl->download_media_prefer_download; }
 
@@ -1043,6 +1062,12 @@ namespace zypp
   void ZConfig::set_default_download_media_prefer_download()
   { _pimpl->download_media_prefer_download.restoreToDefault(); }
 
+  bool ZConfig::download_persist_checksums() const
+  { return _pimpl->download_persist_checksums; }
+
+  void ZConfig::set_download_persist_checksums( bool yesno_r )
+  { _pimpl->download_persist_checksums.set( yesno_r ); }
+
   long ZConfig::download_max_concurrent_connections() const
   { return _pimpl->download_max_concurrent_connections; }
 
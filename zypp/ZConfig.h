@@ -242,6 +242,14 @@ namespace zypp
        */
       LocaleSet repoRefreshLocales() const;
 
+      /**
+       * Whether to build a trigram index for file list searches
+       * along with the repos solv file.
+       * Config option <tt>repo.searchindex (false)</tt>
+       * \see \ref sat::updateSolvFileSearchIndex
+       */
+      bool repo_searchindex() const;
+
       /**
        * Whether to use repository alias or name in user messages (progress,
        * exceptions, ...).
@@ -295,6 +303,8 @@ namespace zypp
        * Config option <tt>download.use_deltarpm.always (false)</tt>
        */
       bool download_use_deltarpm_always() const;
+      /** Set alternate value. */
+      void set_download_use_deltarpm_always( bool yesno_r );
 
       /**
        * Hint which media to prefer when installing packages (download vs. CD).
@@ -323,6 +333,17 @@ namespace zypp
       /** Reset to zypp.cong default. */
       void set_default_download_mediaMountdir();
 
+      /** Whether computed file checksums are kept in the files \c user.zypp.digests
+       * extended attribute, to avoid rereading unchanged files.
+       * This is done only for files below \ref repoCachePath and \ref repoPackagesPath
+       * which are not writable by anyone else.
+       * Config option <tt>download.persist_checksums (false)</tt>
+       * \see \ref filesystem::checksum
+       */
+      bool download_persist_checksums() const;
+      /** Set alternate value. */
+      void set_download_persist_checksums( bool yesno_r );
+
       /**
        * Commit download policy to use as default.
        */
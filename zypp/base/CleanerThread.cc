@@ -10,15 +10,30 @@
  */
 
 #include <zypp/base/CleanerThread_p.h>
+#include <zypp/base/PidFd_p.h>
 #include <algorithm>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <chrono>
 #include <vector>
+#include <map>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 
+/*!
+ * The cleaner thread reaps children we lost interest in.
+ *
+ * Each watched PID is turned into a pidfd and registered with an epoll
+ * instance, so the thread sleeps until one of the children actually exits.
+ * New PIDs are passed in via \ref _pendingPIDs and an eventfd to wake the loop.
+ *
+ * If the kernel does not support pidfds (or epoll could not be set up) the PID
+ * is put on \ref _polledPIDs and checked via \c waitpid(WNOHANG) every 100ms,
+ * which is what we used to do for all PIDs.
+ */
 struct CleanerData
 {
   static CleanerData &instance ()
@@ -31,48 +46,147 @@ struct CleanerData
 
   CleanerData ()
   {
+    _epollFd = ::epoll_create1( EPOLL_CLOEXEC );
+    if ( _epollFd >= 0 )
+    {
+      _wakeupFd = ::eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+      epoll_event ev {};
+      ev.events = EPOLLIN;
+      ev.data.fd = _wakeupFd;
+      if ( _wakeupFd < 0 || ::epoll_ctl( _epollFd, EPOLL_CTL_ADD, _wakeupFd, &ev ) != 0 )
+      {
+        if ( _wakeupFd >= 0 )
+          ::close( _wakeupFd );
+        ::close( _epollFd );
+        _wakeupFd = _epollFd = -1;
+      }
+    }
+
     std::thread t ( [&](){
-      this->run();
+      if ( _epollFd >= 0 )
+        this->runEpoll();
+      else
+        this->runPolling();
     } );
     t.detach(); //we will control the thread otherwise
   }
 
-  void run ()
+  /** Reap \a pid if it exited (or is not our child at all). */
+  static bool reaped( pid_t pid )
+  {
+    int status = 0;
+    int res = waitpid( pid, &status, WNOHANG );
+    // we either got an error, or the child has exited
+    return ( res == -1 || res == pid );
+  }
+
+  /** Legacy mode: check all PIDs every 100ms. */
+  void runPolling ()
   {
     std::unique_lock<std::mutex> lk( _m );
 
     while ( true )
     {
-      auto filter = []( pid_t pid ){
-        int status = 0;
-        int res = waitpid( pid, &status, WNOHANG );
-         // we either got an error, or the child has exited, remove it from list
-        bool removeMe = ( res == -1 || res == pid  );
-        return removeMe;
-      };
-      _watchedPIDs.erase( std::remove_if( _watchedPIDs.begin(), _watchedPIDs.end(), filter ), _watchedPIDs.end() );
-
-      if ( _watchedPIDs.size() )
+      _polledPIDs.insert( _polledPIDs.end(), _pendingPIDs.begin(), _pendingPIDs.end() );
+      _pendingPIDs.clear();
+      _polledPIDs.erase( std::remove_if( _polledPIDs.begin(), _polledPIDs.end(), &CleanerData::reaped ), _polledPIDs.end() );
+
+      if ( _polledPIDs.size() )
         _cv.wait_for( lk, std::chrono::milliseconds(100) );
       else
         _cv.wait( lk );
     }
   }
 
-  std::mutex _m; // < locks all data in CleanerData, do not access it without owning the mutex
+  /** Default mode: sleep until a pidfd becomes readable. */
+  void runEpoll ()
+  {
+    std::map<int,pid_t> pidFds;	// only touched by the cleaner thread
+    epoll_event events[16];
+
+    while ( true )
+    {
+      std::vector<pid_t> newPIDs;
+      {
+        std::lock_guard<std::mutex> guard( _m );
+        newPIDs.swap( _pendingPIDs );
+      }
+
+      for ( pid_t pid : newPIDs )
+      {
+        int fd = zypp::base::openPidFd( pid );
+        if ( fd < 0 )
+        {
+          if ( ! reaped( pid ) )
+            _polledPIDs.push_back( pid );
+          continue;
+        }
+        epoll_event ev {};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        if ( ::epoll_ctl( _epollFd, EPOLL_CTL_ADD, fd, &ev ) != 0 )
+        {
+          ::close( fd );
+          if ( ! reaped( pid ) )
+            _polledPIDs.push_back( pid );
+          continue;
+        }
+        pidFds[fd] = pid;
+      }
+
+      _polledPIDs.erase( std::remove_if( _polledPIDs.begin(), _polledPIDs.end(), &CleanerData::reaped ), _polledPIDs.end() );
+
+      int nfds = ::epoll_wait( _epollFd, events, sizeof(events)/sizeof(epoll_event), _polledPIDs.empty() ? -1 : 100 );
+      for ( int i = 0; i < nfds; ++i )
+      {
+        int fd = events[i].data.fd;
+        if ( fd == _wakeupFd )
+        {
+          eventfd_t dummy;
+          ::eventfd_read( _wakeupFd, &dummy );
+          continue;
+        }
+
+        auto it = pidFds.find( fd );
+        if ( it == pidFds.end() )
+          continue;
+
+        if ( reaped( it->second ) )
+        {
+          ::epoll_ctl( _epollFd, EPOLL_CTL_DEL, fd, nullptr );
+          ::close( fd );
+          pidFds.erase( it );
+        }
+      }
+    }
+  }
+
+  /** Hand a new PID to the thread and wake it up. */
+  void add ( pid_t pid_r )
+  {
+    {
+      std::lock_guard<std::mutex> guard( _m );
+      _pendingPIDs.push_back( pid_r );
+    }
+    //wake the thread up
+    if ( _wakeupFd >= 0 )
+      ::eventfd_write( _wakeupFd, 1 );
+    else
+      _cv.notify_one();
+  }
+
+  std::mutex _m; // < locks _pendingPIDs, do not access it without owning the mutex
   std::condition_variable _cv;
 
-  std::vector<pid_t> _watchedPIDs;
+  std::vector<pid_t> _pendingPIDs;	//< PIDs not yet seen by the thread
+  std::vector<pid_t> _polledPIDs;	//< PIDs without pidfd, owned by the thread
+
+  int _epollFd  = -1;
+  int _wakeupFd = -1;
 };
 
 
 void zypp::CleanerThread::watchPID( pid_t pid_r )
 {
-  CleanerData &data = CleanerData::instance();
-  {
-    std::lock_guard<std::mutex> guard( data._m );
-    data._watchedPIDs.push_back( pid_r );
-  }
-  //wake the thread up
-  data._cv.notify_one();
+  CleanerData::instance().add( pid_r );
 }
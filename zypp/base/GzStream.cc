@@ -19,8 +19,14 @@
 
 /-*/
 
+#include <algorithm>
 #include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <future>
 #include <iostream>
+#include <thread>
 #include <zypp/base/LogControl.h>
 #include <zypp/base/LogTools.h>
 using std::endl;
@@ -30,6 +36,7 @@ using std::endl;
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <unistd.h>
 
 ///////////////////////////////////////////////////////////////////
 namespace zypp
@@ -59,12 +66,516 @@ namespace zypp
       return ret;
     }
 
+    namespace
+    {
+      inline void putLE32( std::string & str_r, uLong val_r )
+      {
+        for ( int i = 0; i < 4; ++i, val_r >>= 8 )
+          str_r += char( val_r & 0xff );
+      }
+
+      inline bool writeAll( int fd_r, const char * data_r, size_t size_r )
+      {
+        while ( size_r )
+        {
+          ssize_t written = ::write( fd_r, data_r, size_r );
+          if ( written < 0 )
+          {
+            if ( errno == EINTR )
+              continue;
+            return false;
+          }
+          data_r += written;
+          size_r -= written;
+        }
+        return true;
+      }
+    } // namespace
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : gzstreambufimpl::Deflater
+    //
+    /** Write a gzip file compressing blocks in parallel (like pigz).
+     *
+     * Input is split into \ref _blockSize blocks. Each block is compressed
+     * as raw deflate data, primed with the last 32K of the previous block
+     * and ended by a sync flush, so the blocks simply concatenate into one
+     * deflate stream. Only the final block is finished. A block is handed
+     * to a worker thread as soon as the next one is started, so small files
+     * are compressed in the calling thread only.
+     */
+    class gzstreambufimpl::Deflater
+    {
+    public:
+      Deflater( int fd_r, ZlibError & error_r )
+      : _fd( fd_r )
+      , _error( error_r )
+      , _maxJobs( std::min( std::max( std::thread::hardware_concurrency(), 1U ), 8U ) )
+      { _block.reserve( _blockSize ); }
+
+      /** Uncompressed bytes written. */
+      off_t total() const
+      { return _total; }
+
+      bool write( const char * data_r, size_t size_r )
+      {
+        _total += size_r;
+        while ( size_r )
+        {
+          size_t chunk = std::min( size_r, _blockSize - _block.size() );
+          _block.append( data_r, chunk );
+          data_r += chunk;
+          size_r -= chunk;
+          if ( _block.size() == _blockSize && ! submit( false ) )
+            return false;
+        }
+        return true;
+      }
+
+      /** Compress the remaining data and write the gzip trailer. */
+      bool finish()
+      {
+        if ( ! submit( true ) )
+          return false;
+        std::string trailer;
+        putLE32( trailer, _crc );
+        putLE32( trailer, uLong( _total ) );	// ISIZE is modulo 2^32
+        return writeOut( trailer );
+      }
+
+    private:
+      struct Result
+      {
+        std::string _data;
+        uLong _crc = 0;
+        uLong _len = 0;
+        int _zError = Z_OK;
+      };
+
+      static Result compress( std::string in_r, std::string dict_r, bool last_r )
+      {
+        Result ret;
+        ret._len = in_r.size();
+        ret._crc = ::crc32( ::crc32( 0L, Z_NULL, 0 ), reinterpret_cast<const Bytef *>( in_r.data() ), in_r.size() );
+
+        z_stream zs {};
+        ret._zError = ::deflateInit2( &zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY );
+        if ( ret._zError != Z_OK )
+          return ret;
+        if ( ! dict_r.empty() )
+          ::deflateSetDictionary( &zs, reinterpret_cast<const Bytef *>( dict_r.data() ), dict_r.size() );
+
+        zs.next_in = reinterpret_cast<Bytef *>( &in_r[0] );
+        zs.avail_in = in_r.size();
+        const uLong bound = ::deflateBound( &zs, in_r.size() ) + 16;	// room for the sync flush marker
+        while ( true )
+        {
+          size_t have = zs.total_out;
+          ret._data.resize( have + bound );
+          zs.next_out = reinterpret_cast<Bytef *>( &ret._data[have] );
+          zs.avail_out = bound;
+
+          ret._zError = ::deflate( &zs, last_r ? Z_FINISH : Z_SYNC_FLUSH );
+          if ( ret._zError == Z_STREAM_END || ( ret._zError == Z_OK && zs.avail_out ) || ( ret._zError == Z_BUF_ERROR && ! last_r ) )
+          {
+            ret._zError = Z_OK;
+            break;
+          }
+          if ( ret._zError != Z_OK )
+            break;
+        }
+        ret._data.resize( zs.total_out );
+        ::deflateEnd( &zs );
+        return ret;
+      }
+
+      /** Hand the current block to a worker (or compress it right here if \a last_r). */
+      bool submit( bool last_r )
+      {
+        std::string in;
+        in.swap( _block );
+        _block.reserve( _blockSize );
+
+        std::string dict;
+        dict.swap( _dict );
+        if ( ! last_r )
+          _dict.assign( in, in.size() > _dictSize ? in.size() - _dictSize : 0, _dictSize );
+
+        if ( last_r || _maxJobs == 1 )
+        {
+          if ( ! drain( 0 ) )
+            return false;
+          return output( compress( std::move(in), std::move(dict), last_r ) );
+        }
+
+        _jobs.push_back( std::async( std::launch::async, &Deflater::compress, std::move(in), std::move(dict), false ) );
+        // write what's ready, but don't keep more than _maxJobs blocks in flight
+        while ( ! _jobs.empty() && _jobs.front().wait_for( std::chrono::seconds(0) ) == std::future_status::ready )
+        {
+          if ( ! drain( _jobs.size() - 1 ) )
+            return false;
+        }
+        return drain( _maxJobs );
+      }
+
+      /** Write completed jobs in order until at most \a keep_r are left. */
+      bool drain( size_t keep_r )
+      {
+        while ( _jobs.size() > keep_r )
+        {
+          Result result { _jobs.front().get() };
+          _jobs.pop_front();
+          if ( ! output( result ) )
+            return false;
+        }
+        return true;
+      }
+
+      bool output( const Result & result_r )
+      {
+        if ( result_r._zError != Z_OK )
+        {
+          _error._zError = result_r._zError;
+          return false;
+        }
+        _crc = ::crc32_combine( _crc, result_r._crc, result_r._len );
+
+        if ( ! _headerWritten )
+        {
+          // magic, deflate, no flags, no mtime, no extra flags, OS unix
+          static const char header[] = { '\037', '\213', '\010', 0, 0, 0, 0, 0, 0, 3 };
+          if ( ! writeOut( std::string( header, sizeof(header) ) ) )
+            return false;
+          _headerWritten = true;
+        }
+        return writeOut( result_r._data );
+      }
+
+      bool writeOut( const std::string & data_r )
+      {
+        if ( ! writeAll( _fd, data_r.data(), data_r.size() ) )
+        {
+          _error._zError = Z_ERRNO;
+          _error._errno = errno;
+          return false;
+        }
+        return true;
+      }
+
+    private:
+      static constexpr size_t _blockSize = 128 * 1024;
+      static constexpr size_t _dictSize = 32 * 1024;
+
+      int _fd;
+      ZlibError & _error;
+      unsigned _maxJobs;
+      std::string _block;		//< collecting the next block
+      std::string _dict;		//< tail of the previous block
+      std::deque<std::future<Result>> _jobs;
+      uLong _crc = 0;
+      off_t _total = 0;
+      bool _headerWritten = false;
+    };
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : gzstreambufimpl::Inflater
+    //
+    /** Read a gzip file (or a plain file), with fast backward seek.
+     *
+     * Concatenated gzip members are read as one stream, like gzread does.
+     *
+     * Once a backward seek happened, inflate stops at each deflate block
+     * boundary and remembers a restart point about every \ref _span bytes
+     * of output: the compressed offset, the bit offset into that byte and
+     * the 32K window needed to resume inflating there (see zlib's zran.c).
+     */
+    class gzstreambufimpl::Inflater
+    {
+    public:
+      Inflater( int fd_r, ZlibError & error_r )
+      : _fd( fd_r )
+      , _error( error_r )
+      , _in( 64 * 1024 )
+      {}
+
+      ~Inflater()
+      {
+        if ( _zsInit )
+          ::inflateEnd( &_zs );
+      }
+
+      /** Detect whether the file is gzip compressed and set up zlib. */
+      bool init()
+      {
+        if ( ! fill() )
+          return false;
+        _plain = ! ( _zs.avail_in >= 2 && _zs.next_in[0] == 0x1f && _zs.next_in[1] == 0x8b );
+        if ( _plain )
+          return true;
+
+        int ret = ::inflateInit2( &_zs, MAX_WBITS + 16 );
+        if ( ret != Z_OK )
+          return setError( ret );
+        _zsInit = true;
+        return true;
+      }
+
+      /** Uncompressed position. */
+      off_t tell() const
+      { return _out; }
+
+      std::streamsize read( char * buffer_r, std::streamsize maxcount_r )
+      {
+        if ( _plain )
+          return readPlain( buffer_r, maxcount_r );
+        if ( _streamEnd )
+          return 0;
+
+        const off_t start = _out;
+        _zs.next_out = reinterpret_cast<Bytef *>( buffer_r );
+        _zs.avail_out = maxcount_r;
+        while ( _zs.avail_out == uInt(maxcount_r) )
+        {
+          if ( _zs.avail_in == 0 )
+          {
+            if ( ! fill() )
+              return -1;
+            if ( _zs.avail_in == 0 )
+            {
+              setError( Z_BUF_ERROR );	// truncated
+              return -1;
+            }
+          }
+
+          int ret = ::inflate( &_zs, _indexing ? Z_BLOCK : Z_NO_FLUSH );
+          if ( ret == Z_NEED_DICT )
+            ret = Z_DATA_ERROR;
+          if ( ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR )
+          {
+            setError( ret );
+            return -1;
+          }
+          _out = start + ( maxcount_r - _zs.avail_out );
+
+          if ( _indexing )
+            addPoint();
+          if ( ret == Z_STREAM_END && ! nextMember() )
+          {
+            _streamEnd = true;
+            break;
+          }
+        }
+        return _out - start;
+      }
+
+      off_t seek( off_t off_r )
+      {
+        if ( _plain )
+        {
+          off_t ret = ::lseek( _fd, off_r, SEEK_SET );
+          if ( ret == -1 )
+          {
+            setError( Z_ERRNO );
+            return -1;
+          }
+          _zs.avail_in = 0;
+          return _out = ret;
+        }
+
+        // closest restart point at or before off_r
+        auto it = std::upper_bound( _index.begin(), _index.end(), off_r,
+                                    []( off_t off, const Point & point ) { return off < point._out; } );
+        const Point * point = ( it == _index.begin() ? nullptr : &*(it-1) );
+
+        if ( off_r < _out )
+        {
+          _indexing = true;	// seeking back once is a hint it will happen again
+          if ( ! ( point ? restore( *point ) : rewind() ) )
+            return -1;
+        }
+        else if ( point && point->_out > _out )
+        {
+          if ( ! restore( *point ) )
+            return -1;
+        }
+
+        char scratch[16 * 1024];
+        while ( _out < off_r )
+        {
+          std::streamsize got = read( scratch, std::min( off_t(sizeof(scratch)), off_r - _out ) );
+          if ( got < 0 )
+            return -1;
+          if ( got == 0 )
+            break;	// EOF
+        }
+        return _out;
+      }
+
+    private:
+      struct Point
+      {
+        off_t _out;			//< uncompressed offset
+        off_t _in;			//< compressed offset of the first complete byte
+        int _bits;			//< bits of the previous byte still to be used
+        std::vector<Bytef> _window;	//< inflate dictionary
+      };
+
+      bool setError( int zError_r )
+      {
+        _error._zError = zError_r;
+        _error._errno = errno;
+        return false;
+      }
+
+      /** Refill the input buffer if it's empty. \c false on error; EOF leaves \c avail_in at 0. */
+      bool fill()
+      {
+        if ( _zs.avail_in )
+          return true;
+        ssize_t got;
+        do {
+          got = ::read( _fd, _in.data(), _in.size() );
+        } while ( got < 0 && errno == EINTR );
+        if ( got < 0 )
+          return setError( Z_ERRNO );
+        _zs.next_in = _in.data();
+        _zs.avail_in = got;
+        _inPos += got;
+        return true;
+      }
+
+      std::streamsize readPlain( char * buffer_r, std::streamsize maxcount_r )
+      {
+        std::streamsize got;
+        if ( _zs.avail_in )
+        {
+          got = std::min( std::streamsize(_zs.avail_in), maxcount_r );
+          ::memcpy( buffer_r, _zs.next_in, got );
+          _zs.next_in += got;
+          _zs.avail_in -= got;
+        }
+        else
+        {
+          do {
+            got = ::read( _fd, buffer_r, maxcount_r );
+          } while ( got < 0 && errno == EINTR );
+          if ( got < 0 )
+            return setError( Z_ERRNO ), -1;
+        }
+        _out += got;
+        return got;
+      }
+
+      /** Continue with the next gzip member, if there is one. */
+      bool nextMember()
+      {
+        if ( _raw )
+        {
+          // restored from a restart point: zlib did not read the member trailer
+          for ( int i = 0; i < 8; ++i )
+          {
+            if ( ! fill() || _zs.avail_in == 0 )
+              return false;
+            ++_zs.next_in;
+            --_zs.avail_in;
+          }
+        }
+        if ( ! fill() || _zs.avail_in == 0 || _zs.next_in[0] != 0x1f )
+          return false;	// EOF or trailing garbage
+        ::inflateReset2( &_zs, MAX_WBITS + 16 );
+        _raw = false;
+        return true;
+      }
+
+      /** Remember a restart point if inflate stopped at a block boundary. */
+      void addPoint()
+      {
+        if ( ! ( _zs.data_type & 128 ) || ( _zs.data_type & 64 ) )
+          return;
+        if ( ! _index.empty() && _out < _index.back()._out + _span )
+          return;
+
+        Point point { _out, _inPos - off_t(_zs.avail_in), _zs.data_type & 7, std::vector<Bytef>( 32 * 1024 ) };
+        uInt len = point._window.size();
+        ::inflateGetDictionary( &_zs, point._window.data(), &len );
+        point._window.resize( len );
+        point._window.shrink_to_fit();
+        _index.push_back( std::move(point) );
+      }
+
+      /** Position the input at \a off_r and drop buffered data. */
+      bool seekIn( off_t off_r )
+      {
+        if ( ::lseek( _fd, off_r, SEEK_SET ) == -1 )
+          return setError( Z_ERRNO );
+        _inPos = off_r;
+        _zs.avail_in = 0;
+        return true;
+      }
+
+      bool rewind()
+      {
+        if ( ! seekIn( 0 ) )
+          return false;
+        ::inflateReset2( &_zs, MAX_WBITS + 16 );
+        _raw = false;
+        _streamEnd = false;
+        _out = 0;
+        return true;
+      }
+
+      bool restore( const Point & point_r )
+      {
+        if ( ! seekIn( point_r._in - ( point_r._bits ? 1 : 0 ) ) )
+          return false;
+        ::inflateReset2( &_zs, -MAX_WBITS );
+        _raw = true;
+        _streamEnd = false;
+        if ( point_r._bits )
+        {
+          if ( ! fill() || _zs.avail_in == 0 )
+            return setError( Z_BUF_ERROR );
+          int ch = *_zs.next_in++;
+          --_zs.avail_in;
+          ::inflatePrime( &_zs, point_r._bits, ch >> ( 8 - point_r._bits ) );
+        }
+        if ( ! point_r._window.empty() )
+          ::inflateSetDictionary( &_zs, point_r._window.data(), point_r._window.size() );
+        _out = point_r._out;
+        return true;
+      }
+
+    private:
+      static constexpr off_t _span = 1024 * 1024;
+
+      int _fd;
+      ZlibError & _error;
+      z_stream _zs {};
+      bool _zsInit = false;
+      std::vector<Bytef> _in;
+      off_t _inPos = 0;		//< compressed offset at the end of _in
+      off_t _out = 0;
+      bool _plain = false;
+      bool _raw = false;		//< inflating raw deflate data after a restore
+      bool _streamEnd = false;
+      bool _indexing = false;
+      std::vector<Point> _index;
+    };
+
     ///////////////////////////////////////////////////////////////////
     //
     //	CLASS NAME : fgzstreambuf
     //
     ///////////////////////////////////////////////////////////////////
 
+    gzstreambufimpl::gzstreambufimpl()
+    {}
+
+    gzstreambufimpl::~gzstreambufimpl()
+    { closeImpl(); }
+
     ///////////////////////////////////////////////////////////////////
     //
     //	METHOD NAME : gzstreambufimpl::openImpl
@@ -76,27 +587,47 @@ namespace zypp
       bool ret = false;
       if ( ! isOpen() )
       {
-        // we expect gzdopen to handle errors of ::open
         if ( mode_r == std::ios_base::in )
         {
           _fd = ::open( name_r, O_RDONLY | O_CLOEXEC );
-          _file = gzdopen( _fd, "rb" );
+          if ( _fd >= 0 )
+          {
+            _inflater.reset( new Inflater( _fd, _error ) );
+            ret = _inflater->init();
+          }
         }
         else if ( mode_r == std::ios_base::out )
         {
-          _fd = ::open( name_r, O_WRONLY|O_CREAT|O_CLOEXEC, 0666 );
-          _file = gzdopen( _fd, "wb" );
+          _fd = ::open( name_r, O_WRONLY|O_CREAT|O_TRUNC|O_CLOEXEC, 0666 );
+          if ( _fd >= 0 )
+          {
+            _deflater.reset( new Deflater( _fd, _error ) );
+            ret = true;
+          }
+        }
+        else
+        {
+          // not supported
+          _error._zError = Z_STREAM_ERROR;
+          return false;
         }
-        // else: not supported
 
-        if ( isOpen() )
+        if ( _fd < 0 )
+        {
+          _error._zError = Z_ERRNO;
+          _error._errno = errno;
+        }
+        else if ( ret )
         {
           // Store mode
           _mode = mode_r;
-          ret   = true;
         }
         else
-          setZError();
+        {
+          _inflater.reset();
+          ::close( _fd );
+          _fd = -1;
+        }
       }
       return ret;
     }
@@ -114,19 +645,20 @@ namespace zypp
         {
           bool failed = false;
 
-	  // it also closes _fd, fine
-          int r = gzclose( _file );
-          if ( r != Z_OK )
+          if ( _deflater && ! _deflater->finish() )
+            failed = true;
+          _deflater.reset();
+          _inflater.reset();
+
+          if ( ::close( _fd ) != 0 && ! failed )
             {
               failed = true;
-              // DONT call setZError() here, as _file is no longer valid
-              _error._zError = r;
+              _error._zError = Z_ERRNO;
               _error._errno = errno;
             }
 
           // Reset everything
 	  _fd = -1;
-          _file = NULL;
           _mode = std::ios_base::openmode(0);
           if ( ! failed )
             ret = true;
@@ -142,10 +674,9 @@ namespace zypp
     std::streamsize
     gzstreambufimpl::readData( char * buffer_r, std::streamsize maxcount_r )
     {
-      int read = gzread( _file, buffer_r, maxcount_r );
-      if ( read < 0 )
-        setZError();
-      return read;
+      if ( ! _inflater )
+        return -1;
+      return _inflater->read( buffer_r, maxcount_r );
     }
 
     ///////////////////////////////////////////////////////////////////
@@ -156,13 +687,9 @@ namespace zypp
     bool
     gzstreambufimpl::writeData( const char * buffer_r, std::streamsize count_r )
     {
-      int written = 0;
-      if ( count_r )
-        {
-          if ( (written = gzwrite( _file, buffer_r, count_r )) == 0 )
-            setZError();
-        }
-      return( written == count_r );
+      if ( ! _deflater )
+        return false;
+      return _deflater->write( buffer_r, count_r );
     }
 
     ///////////////////////////////////////////////////////////////////
@@ -173,10 +700,33 @@ namespace zypp
     off_t
     gzstreambufimpl::seekTo( off_t off_r, std::ios_base::seekdir way_r, std::ios_base::openmode )
     {
-      z_off_t ret = gzseek( _file, off_r, way_r );
-      if ( ret == -1 )
-        setZError();
-      return ret;
+      if ( way_r == std::ios_base::cur )
+        off_r += tell();
+      else if ( way_r != std::ios_base::beg )
+        off_r = -1;
+
+      if ( off_r < 0 )
+      {
+        _error._zError = Z_STREAM_ERROR;
+        return -1;
+      }
+
+      if ( _inflater )
+        return _inflater->seek( off_r );
+
+      // write mode: only forward, filling the gap with zeros like gzseek does
+      if ( ! _deflater || off_r < _deflater->total() )
+      {
+        _error._zError = Z_STREAM_ERROR;
+        return -1;
+      }
+      static const char zeros[4096] = { 0 };
+      while ( _deflater->total() < off_r )
+      {
+        if ( ! _deflater->write( zeros, std::min( off_t(sizeof(zeros)), off_r - _deflater->total() ) ) )
+          return -1;
+      }
+      return off_r;
     }
 
     ///////////////////////////////////////////////////////////////////
@@ -187,10 +737,11 @@ namespace zypp
     off_t
     gzstreambufimpl::tell() const
     {
-      z_off_t ret = gztell( _file );
-      if ( ret == -1 )
-        setZError();
-      return ret;
+      if ( _inflater )
+        return _inflater->tell();
+      if ( _deflater )
+        return _deflater->total();
+      return -1;
     }
 
     off_t
@@ -22,6 +22,7 @@
 #define ZYPP_BASE_GZSTREAM_H
 
 #include <iosfwd>
+#include <memory>
 #include <streambuf>
 #include <vector>
 #include <zlib.h>
@@ -79,9 +80,17 @@ namespace zypp
      * @short Streambuffer reading or writing gzip files.
      *
      * Read and write mode are mutual exclusive. Seek is supported,
-     * but zlib restrictions appy (only forward seek in write mode;
-     * backward seek in read mode might be expensive).Putback is not
-     * supported.
+     * but zlib restrictions appy (only forward seek in write mode).
+     * Putback is not supported.
+     *
+     * In write mode the data are compressed in blocks which are handed
+     * to worker threads (like \c pigz does), once there is more than one
+     * block to compress. The result is a single ordinary gzip member.
+     *
+     * In read mode the first backward seek has to decompress the file
+     * from the start. While doing so, an index of restart points
+     * (like \c zran does) is built, so later seeks resume decompression
+     * at the nearest restart point.
      *
      * Reading plain (no gziped) files is possible as well.
      *
@@ -92,12 +101,12 @@ namespace zypp
 
       using error_type = ZlibError;
 
-      ~gzstreambufimpl()
-      { closeImpl(); }
+      gzstreambufimpl();
+      ~gzstreambufimpl();
 
       bool
       isOpen   () const
-      { return _file; }
+      { return _fd >= 0; }
 
       bool
       canRead  () const
@@ -133,15 +142,15 @@ namespace zypp
       off_t tell() const;
 
     private:
-
-      void
-      setZError() const
-      { gzerror( _file, &_error._zError ); }
+      class Deflater;
+      class Inflater;
 
       //! file descriptor of the compressed file
       int		         _fd = -1;
 
-      gzFile                   _file = nullptr;
+      std::unique_ptr<Deflater> _deflater;	//< write mode
+
+      std::unique_ptr<Inflater> _inflater;	//< read mode
 
       std::ios_base::openmode  _mode = std::ios_base::openmode(0);
 
@@ -18,6 +18,12 @@
 #ifdef ENABLE_ZCHUNK_COMPRESSION
   #include <zypp/base/ZckStream.h>
 #endif
+#ifdef ENABLE_ZSTD_COMPRESSION
+  #include <zypp/base/ZStdStream.h>
+#endif
+#ifdef ENABLE_XZ_COMPRESSION
+  #include <zypp/base/XzStream.h>
+#endif
 
 #include <zypp/PathInfo.h>
 
@@ -39,15 +45,40 @@ namespace zypp
       return -1;
     }
 
-    inline shared_ptr<std::istream> streamForFile ( const Pathname & file_r )
+    template <class TStream>
+    shared_ptr<std::istream> makeStream( const Pathname & file_r )
+    { return shared_ptr<std::istream>( new TStream( file_r.asString().c_str() ) ); }
+
+    /** Decompressing stream to use for a \ref filesystem::ZIP_TYPE.
+     * Types not in the list are read by \ref ifgzstream, which also
+     * passes through uncompressed data.
+     */
+    struct Decompressor
     {
+      filesystem::ZIP_TYPE _type;
+      shared_ptr<std::istream> (*_create)( const Pathname & file_r );
+    };
+
+    const Decompressor decompressors[] = {
 #ifdef ENABLE_ZCHUNK_COMPRESSION
-      if ( const auto zType = filesystem::zipType( file_r ); zType == filesystem::ZT_ZCHNK )
-        return shared_ptr<std::istream>( new ifzckstream( file_r.asString().c_str() ) );
+      { filesystem::ZT_ZCHNK,	&makeStream<ifzckstream> },
 #endif
+#ifdef ENABLE_ZSTD_COMPRESSION
+      { filesystem::ZT_ZSTD,	&makeStream<ifzstdstream> },
+#endif
+#ifdef ENABLE_XZ_COMPRESSION
+      { filesystem::ZT_XZ,	&makeStream<ifxzstream> },
+#endif
+      { filesystem::ZT_GZ,	&makeStream<ifgzstream> },	// fallback, must be last
+    };
 
-      //fall back to gzstream
-      return shared_ptr<std::istream>( new ifgzstream( file_r.asString().c_str() ) );
+    inline shared_ptr<std::istream> streamForFile ( const Pathname & file_r )
+    {
+      const filesystem::ZIP_TYPE zType = filesystem::zipType( file_r );
+      const Decompressor * it = std::begin( decompressors );
+      while ( it->_type != zType && it != std::end( decompressors ) - 1 )
+        ++it;
+      return it->_create( file_r );
     }
 
     /////////////////////////////////////////////////////////////////
@@ -0,0 +1,57 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/base/PidFd_p.h
+ * This file contains private API, it will change without notice.
+ * You have been warned.
+*/
+#ifndef ZYPP_BASE_PIDFD_P_H
+#define ZYPP_BASE_PIDFD_P_H
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <cerrno>
+
+#ifndef SYS_pidfd_open
+#  ifdef __NR_pidfd_open
+#    define SYS_pidfd_open __NR_pidfd_open
+#  else
+#    define SYS_pidfd_open 434	// same number on all architectures
+#  endif
+#endif
+
+namespace zypp
+{
+  namespace base
+  {
+    /** Open a process file descriptor referring to \a pid_r (Linux >= 5.3).
+     *
+     * The returned fd becomes readable (POLLIN) as soon as the process
+     * terminated, so it can be watched by \c poll/\c epoll or a
+     * \ref zyppng::SocketNotifier instead of polling \c waitpid.
+     * The fd is opened \c O_CLOEXEC; the caller owns and must close it.
+     * The process still needs to be reaped via \c waitpid.
+     *
+     * \return The pidfd or \c -1 with \c errno set (e.g. \c ENOSYS on older kernels).
+     */
+    inline int openPidFd( pid_t pid_r )
+    {
+      if ( pid_r <= 0 )
+      {
+        errno = ESRCH;
+        return -1;
+      }
+      int fd = ::syscall( SYS_pidfd_open, pid_r, 0 );
+      if ( fd >= 0 )
+        ::fcntl( fd, F_SETFD, FD_CLOEXEC );	// pidfd_open implies it, but old headers/kernels may differ
+      return fd;
+    }
+  } // namespace base
+} // namespace zypp
+#endif // ZYPP_BASE_PIDFD_P_H
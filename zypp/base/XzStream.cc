@@ -0,0 +1,243 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+#include <zypp/base/XzStream.h>
+#include <zypp/base/String.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+extern "C" {
+#include <lzma.h>
+}
+
+namespace zypp {
+
+  namespace detail {
+
+    struct xzstreambufimpl::LzmaStream
+    {
+      LzmaStream()
+      : _strm( LZMA_STREAM_INIT )
+      {}
+
+      ~LzmaStream()
+      { ::lzma_end( &_strm ); }
+
+      lzma_stream _strm;
+    };
+
+    namespace
+    {
+      /** lzma error codes as text (liblzma does not provide them) */
+      const char * lzmaErrorString( int code_r )
+      {
+        switch ( code_r )
+        {
+          case LZMA_MEM_ERROR:		return "Memory allocation failed";
+          case LZMA_MEMLIMIT_ERROR:	return "Memory usage limit was reached";
+          case LZMA_FORMAT_ERROR:	return "File format not recognized";
+          case LZMA_OPTIONS_ERROR:	return "Invalid or unsupported options";
+          case LZMA_DATA_ERROR:		return "Compressed data is corrupt";
+          case LZMA_BUF_ERROR:		return "Unexpected end of compressed data";
+          case LZMA_PROG_ERROR:		return "Programming error";
+        }
+        return "Unknown error";
+      }
+    } // namespace
+
+    xzstreambufimpl::xzstreambufimpl()
+    {}
+
+    xzstreambufimpl::~xzstreambufimpl()
+    {
+      closeImpl();
+    }
+
+    bool xzstreambufimpl::openImpl( const char *name_r, std::ios_base::openmode mode_r )
+    {
+      if ( isOpen() )
+        return false;
+
+      if ( mode_r == std::ios_base::in ) {
+        _fd = ::open( name_r, O_RDONLY | O_CLOEXEC );
+        _isReading = true;
+
+      } else if ( mode_r == std::ios_base::out ) {
+        _fd = ::open( name_r, O_WRONLY|O_CREAT|O_TRUNC|O_CLOEXEC, 0666 );
+        _isReading = false;
+      } else {
+        //unsupported mode
+        _lastErr = str::Format("Xz backend does not support the given open mode.");
+        return false;
+      }
+
+      if ( _fd < 0 ) {
+        const int errSrv = errno;
+        _lastErr = str::Format("Opening file failed: %1%") % ::strerror( errSrv );
+        return false;
+      }
+
+      _lzma.reset( new LzmaStream );
+      lzma_ret ret = _isReading
+                   ? ::lzma_stream_decoder( &_lzma->_strm, UINT64_MAX, LZMA_CONCATENATED )
+                   : ::lzma_easy_encoder( &_lzma->_strm, 6, LZMA_CHECK_CRC64 );
+      if ( ret != LZMA_OK ) {
+        setError( ret );
+        _lzma.reset();
+        ::close( _fd );
+        _fd = -1;
+        return false;
+      }
+
+      _buffer.resize( BUFSIZ * 8 );
+      _inputEof = false;
+      _currfp = 0;
+      return true;
+    }
+
+    bool xzstreambufimpl::closeImpl()
+    {
+      if ( !isOpen() )
+        return true;
+
+      bool success = true;
+
+      if ( !_isReading )
+        success = writeOut( true );
+      _lzma.reset();
+
+      if ( ::close( _fd ) != 0 && success ) {
+        const int errSrv = errno;
+        _lastErr = str::Format("Closing file failed: %1%") % ::strerror( errSrv );
+        success = false;
+      }
+      _fd = -1;
+      _buffer.clear();
+      return success;
+    }
+
+    void xzstreambufimpl::setError( int code_r )
+    {
+      _lastErr = lzmaErrorString( code_r );
+    }
+
+    std::streamsize xzstreambufimpl::readData(char *buffer_r, std::streamsize maxcount_r)
+    {
+      if ( !isOpen() || !canRead() )
+        return -1;
+
+      lzma_stream & strm { _lzma->_strm };
+      strm.next_out = reinterpret_cast<uint8_t *>( buffer_r );
+      strm.avail_out = maxcount_r;
+
+      while ( strm.avail_out == size_t(maxcount_r) ) {
+        if ( strm.avail_in == 0 && !_inputEof ) {
+          ssize_t got = ::read( _fd, _buffer.data(), _buffer.size() );
+          if ( got < 0 ) {
+            if ( errno == EINTR )
+              continue;
+            const int errSrv = errno;
+            _lastErr = str::Format("Reading file failed: %1%") % ::strerror( errSrv );
+            return -1;
+          }
+          strm.next_in = _buffer.data();
+          strm.avail_in = got;
+          _inputEof = ( got == 0 );
+        }
+
+        // LZMA_FINISH lets LZMA_CONCATENATED know there is no further stream
+        lzma_ret ret = ::lzma_code( &strm, _inputEof ? LZMA_FINISH : LZMA_RUN );
+        if ( ret == LZMA_STREAM_END )
+          break;
+        if ( ret != LZMA_OK ) {
+          setError( ret );
+          return -1;
+        }
+      }
+
+      std::streamsize read = maxcount_r - strm.avail_out;
+      _currfp += read;
+      return read;
+    }
+
+    bool xzstreambufimpl::writeData(const char *buffer_r, std::streamsize count_r)
+    {
+      if ( !isOpen() || !canWrite() )
+        return false;
+
+      lzma_stream & strm { _lzma->_strm };
+      strm.next_in = reinterpret_cast<const uint8_t *>( buffer_r );
+      strm.avail_in = count_r;
+      if ( !writeOut( false ) )
+        return false;
+
+      _currfp += count_r;
+      return true;
+    }
+
+    bool xzstreambufimpl::writeOut( bool finish_r )
+    {
+      lzma_stream & strm { _lzma->_strm };
+      while ( true ) {
+        strm.next_out = _buffer.data();
+        strm.avail_out = _buffer.size();
+
+        lzma_ret ret = ::lzma_code( &strm, finish_r ? LZMA_FINISH : LZMA_RUN );
+        if ( ret != LZMA_OK && ret != LZMA_STREAM_END ) {
+          setError( ret );
+          return false;
+        }
+
+        size_t have = _buffer.size() - strm.avail_out;
+        if ( have && ::write( _fd, _buffer.data(), have ) != ssize_t(have) ) {
+          const int errSrv = errno;
+          _lastErr = str::Format("Writing file failed: %1%") % ::strerror( errSrv );
+          return false;
+        }
+
+        if ( finish_r ? ret == LZMA_STREAM_END : strm.avail_in == 0 )
+          return true;
+      }
+    }
+
+    bool xzstreambufimpl::isOpen() const
+    {
+      return ( _fd >= 0 );
+    }
+
+    bool xzstreambufimpl::canRead() const
+    {
+      return _isReading;
+    }
+
+    bool xzstreambufimpl::canWrite() const
+    {
+      return !_isReading;
+    }
+
+    bool xzstreambufimpl::canSeek( std::ios_base::seekdir ) const
+    {
+      return false;
+    }
+
+    off_t xzstreambufimpl::seekTo(off_t, std::ios_base::seekdir , std::ios_base::openmode)
+    {
+      return -1;
+    }
+
+    off_t xzstreambufimpl::tell() const
+    {
+      return _currfp;
+    }
+  }
+
+}
@@ -0,0 +1,81 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+#ifndef ZYPP_BASE_XZSTREAM_H
+#define ZYPP_BASE_XZSTREAM_H
+
+#include <iosfwd>
+#include <streambuf>
+#include <memory>
+#include <vector>
+#include <zypp/base/SimpleStreambuf.h>
+#include <zypp/base/fXstream.h>
+
+namespace zypp {
+
+  namespace detail {
+
+    /**
+     * @short Streambuffer reading or writing xz compressed files.
+     *
+     * Read and write mode are mutual exclusive. Seek is not supported.
+     * Concatenated streams are read as one stream, like \c xzcat does.
+     *
+     * This streambuf is used in @ref ifxzstream and  @ref ofxzstream.
+     **/
+    class xzstreambufimpl {
+      public:
+
+        using error_type = std::string;
+
+        xzstreambufimpl();
+        ~xzstreambufimpl();
+
+        bool isOpen   () const;
+        bool canRead  () const;
+        bool canWrite () const;
+        bool canSeek  ( std::ios_base::seekdir way_r ) const;
+
+        std::streamsize readData ( char * buffer_r, std::streamsize maxcount_r  );
+        bool writeData( const char * buffer_r, std::streamsize count_r );
+        off_t seekTo( off_t off_r, std::ios_base::seekdir way_r, std::ios_base::openmode omode_r );
+        off_t tell() const;
+
+        error_type error() const { return _lastErr; }
+
+      protected:
+        bool openImpl( const char * name_r, std::ios_base::openmode mode_r );
+        bool closeImpl ();
+
+      private:
+        struct LzmaStream;	//< wraps lzma_stream, hiding <lzma.h>
+        bool writeOut( bool finish_r );
+        void setError( int code_r );
+        int _fd = -1;
+        bool _isReading = false;
+        bool _inputEof = false;
+        std::unique_ptr<LzmaStream> _lzma;
+        std::vector<unsigned char> _buffer;	//< compressed data
+        off_t _currfp = 0;
+        error_type _lastErr;
+    };
+    using XzStreamBuf = detail::SimpleStreamBuf<detail::xzstreambufimpl>;
+  }
+
+  /**
+   * istream reading xz compressed files.
+   **/
+  using ifxzstream = detail::fXstream<std::istream,detail::XzStreamBuf>;
+
+  /**
+   * ostream writing xz compressed files.
+   **/
+  using ofxzstream = detail::fXstream<std::ostream,detail::XzStreamBuf>;
+}
+
+#endif
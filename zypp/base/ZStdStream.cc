@@ -0,0 +1,225 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+#include <zypp/base/ZStdStream.h>
+#include <zypp/base/String.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+extern "C" {
+#include <zstd.h>
+}
+
+namespace zypp {
+
+  namespace detail {
+
+    zstdstreambufimpl::~zstdstreambufimpl()
+    {
+      closeImpl();
+    }
+
+    bool zstdstreambufimpl::openImpl( const char *name_r, std::ios_base::openmode mode_r )
+    {
+      if ( isOpen() )
+        return false;
+
+      if ( mode_r == std::ios_base::in ) {
+        _fd = ::open( name_r, O_RDONLY | O_CLOEXEC );
+        _isReading = true;
+
+      } else if ( mode_r == std::ios_base::out ) {
+        _fd = ::open( name_r, O_WRONLY|O_CREAT|O_TRUNC|O_CLOEXEC, 0666 );
+        _isReading = false;
+      } else {
+        //unsupported mode
+        _lastErr = str::Format("Zstd backend does not support the given open mode.");
+        return false;
+      }
+
+      if ( _fd < 0 ) {
+        const int errSrv = errno;
+        _lastErr = str::Format("Opening file failed: %1%") % ::strerror( errSrv );
+        return false;
+      }
+
+      if ( _isReading ) {
+        _dContext = ::ZSTD_createDCtx();
+        _buffer.resize( ::ZSTD_DStreamInSize() );
+      } else {
+        _cContext = ::ZSTD_createCCtx();
+        _buffer.resize( ::ZSTD_CStreamOutSize() );
+      }
+
+      if ( !_dContext && !_cContext ) {
+        _lastErr = str::Format("Creating the zstd context failed.");
+        ::close( _fd );
+        _fd = -1;
+        return false;
+      }
+
+      _bufferPos = _bufferEnd = 0;
+      _frameLeft = 0;
+      _currfp = 0;
+      return true;
+    }
+
+    bool zstdstreambufimpl::closeImpl()
+    {
+      if ( !isOpen() )
+        return true;
+
+      bool success = true;
+
+      if ( _cContext ) {
+        success = writeOut( ZSTD_e_end );
+        ::ZSTD_freeCCtx( _cContext );
+        _cContext = nullptr;
+      }
+
+      if ( _dContext ) {
+        ::ZSTD_freeDCtx( _dContext );
+        _dContext = nullptr;
+      }
+
+      if ( ::close( _fd ) != 0 && success ) {
+        const int errSrv = errno;
+        _lastErr = str::Format("Closing file failed: %1%") % ::strerror( errSrv );
+        success = false;
+      }
+      _fd = -1;
+      _buffer.clear();
+      return success;
+    }
+
+    void zstdstreambufimpl::setError( size_t code_r )
+    {
+      _lastErr = ::ZSTD_getErrorName( code_r );
+    }
+
+    std::streamsize zstdstreambufimpl::readData(char *buffer_r, std::streamsize maxcount_r)
+    {
+      if ( !isOpen() || !canRead() )
+        return -1;
+
+      ZSTD_outBuffer out { buffer_r, size_t(maxcount_r), 0 };
+      while ( out.pos == 0 ) {
+        if ( _bufferPos == _bufferEnd ) {
+          ssize_t got = ::read( _fd, _buffer.data(), _buffer.size() );
+          if ( got < 0 ) {
+            if ( errno == EINTR )
+              continue;
+            const int errSrv = errno;
+            _lastErr = str::Format("Reading file failed: %1%") % ::strerror( errSrv );
+            return -1;
+          }
+          if ( got == 0 ) {
+            if ( _frameLeft != 0 ) {
+              _lastErr = str::Format("Unexpected end of zstd compressed data.");
+              return -1;
+            }
+            return 0;	// EOF
+          }
+          _bufferPos = 0;
+          _bufferEnd = got;
+        }
+
+        ZSTD_inBuffer in { _buffer.data(), _bufferEnd, _bufferPos };
+        size_t ret = ::ZSTD_decompressStream( _dContext, &out, &in );
+        _bufferPos = in.pos;
+        if ( ::ZSTD_isError( ret ) ) {
+          setError( ret );
+          return -1;
+        }
+        _frameLeft = ret;
+      }
+
+      _currfp += out.pos;
+      return out.pos;
+    }
+
+    bool zstdstreambufimpl::writeData(const char *buffer_r, std::streamsize count_r)
+    {
+      if ( !isOpen() || !canWrite() )
+        return false;
+
+      ZSTD_inBuffer in { buffer_r, size_t(count_r), 0 };
+      while ( in.pos < in.size ) {
+        ZSTD_outBuffer out { _buffer.data(), _buffer.size(), 0 };
+        size_t ret = ::ZSTD_compressStream2( _cContext, &out, &in, ZSTD_e_continue );
+        if ( ::ZSTD_isError( ret ) ) {
+          setError( ret );
+          return false;
+        }
+        if ( out.pos && ::write( _fd, out.dst, out.pos ) != ssize_t(out.pos) ) {
+          const int errSrv = errno;
+          _lastErr = str::Format("Writing file failed: %1%") % ::strerror( errSrv );
+          return false;
+        }
+      }
+
+      _currfp += count_r;
+      return true;
+    }
+
+    bool zstdstreambufimpl::writeOut( int endOp_r )
+    {
+      ZSTD_inBuffer in { nullptr, 0, 0 };
+      size_t left = 0;
+      do {
+        ZSTD_outBuffer out { _buffer.data(), _buffer.size(), 0 };
+        left = ::ZSTD_compressStream2( _cContext, &out, &in, ZSTD_EndDirective(endOp_r) );
+        if ( ::ZSTD_isError( left ) ) {
+          setError( left );
+          return false;
+        }
+        if ( out.pos && ::write( _fd, out.dst, out.pos ) != ssize_t(out.pos) ) {
+          const int errSrv = errno;
+          _lastErr = str::Format("Writing file failed: %1%") % ::strerror( errSrv );
+          return false;
+        }
+      } while ( left != 0 );
+      return true;
+    }
+
+    bool zstdstreambufimpl::isOpen() const
+    {
+      return ( _fd >= 0 );
+    }
+
+    bool zstdstreambufimpl::canRead() const
+    {
+      return _isReading;
+    }
+
+    bool zstdstreambufimpl::canWrite() const
+    {
+      return !_isReading;
+    }
+
+    bool zstdstreambufimpl::canSeek( std::ios_base::seekdir ) const
+    {
+      return false;
+    }
+
+    off_t zstdstreambufimpl::seekTo(off_t, std::ios_base::seekdir , std::ios_base::openmode)
+    {
+      return -1;
+    }
+
+    off_t zstdstreambufimpl::tell() const
+    {
+      return _currfp;
+    }
+  }
+
+}
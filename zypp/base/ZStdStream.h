@@ -0,0 +1,84 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+#ifndef ZYPP_BASE_ZSTDSTREAM_H
+#define ZYPP_BASE_ZSTDSTREAM_H
+
+#include <iosfwd>
+#include <streambuf>
+#include <vector>
+#include <zypp/base/SimpleStreambuf.h>
+#include <zypp/base/fXstream.h>
+
+typedef struct ZSTD_DCtx_s ZSTD_DCtx;
+typedef struct ZSTD_CCtx_s ZSTD_CCtx;
+
+namespace zypp {
+
+  namespace detail {
+
+    /**
+     * @short Streambuffer reading or writing zstd compressed files.
+     *
+     * Read and write mode are mutual exclusive. Seek is not supported.
+     * Concatenated frames are read as one stream, like \c zstdcat does.
+     *
+     * This streambuf is used in @ref ifzstdstream and  @ref ofzstdstream.
+     **/
+    class zstdstreambufimpl {
+      public:
+
+        using error_type = std::string;
+
+        ~zstdstreambufimpl();
+
+        bool isOpen   () const;
+        bool canRead  () const;
+        bool canWrite () const;
+        bool canSeek  ( std::ios_base::seekdir way_r ) const;
+
+        std::streamsize readData ( char * buffer_r, std::streamsize maxcount_r  );
+        bool writeData( const char * buffer_r, std::streamsize count_r );
+        off_t seekTo( off_t off_r, std::ios_base::seekdir way_r, std::ios_base::openmode omode_r );
+        off_t tell() const;
+
+        error_type error() const { return _lastErr; }
+
+      protected:
+        bool openImpl( const char * name_r, std::ios_base::openmode mode_r );
+        bool closeImpl ();
+
+      private:
+        bool writeOut( int endOp_r );
+        void setError( size_t code_r );
+        int _fd = -1;
+        bool _isReading = false;
+        ZSTD_DCtx *_dContext = nullptr;
+        ZSTD_CCtx *_cContext = nullptr;
+        std::vector<char> _buffer;	//< compressed data
+        size_t _bufferPos = 0;		//< read position in _buffer
+        size_t _bufferEnd = 0;		//< end of data in _buffer
+        size_t _frameLeft = 0;		//< hint of the decoder, != 0 if the current frame is incomplete
+        off_t _currfp = 0;
+        error_type _lastErr;
+    };
+    using ZStdStreamBuf = detail::SimpleStreamBuf<detail::zstdstreambufimpl>;
+  }
+
+  /**
+   * istream reading zstd compressed files.
+   **/
+  using ifzstdstream = detail::fXstream<std::istream,detail::ZStdStreamBuf>;
+
+  /**
+   * ostream writing zstd compressed files.
+   **/
+  using ofzstdstream = detail::fXstream<std::ostream,detail::ZStdStreamBuf>;
+}
+
+#endif
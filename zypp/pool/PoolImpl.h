@@ -174,6 +174,7 @@ namespace zypp
         typedef PoolTraits::size_type			size_type;
         typedef PoolTraits::const_iterator		const_iterator;
 	typedef PoolTraits::Id2ItemT			Id2ItemT;
+	typedef std::unordered_set<sat::detail::IdType>	IdentSet;
 
         typedef PoolTraits::repository_iterator		repository_iterator;
 
@@ -241,16 +242,31 @@ namespace zypp
         //
         ///////////////////////////////////////////////////////////////////
       public:
+        /** The \ref ResPoolProxy for the current pool content.
+         * After the pool changed, the new proxy is derived from the
+         * previous one, rebuilding only the \ref ui::Selectable of those
+         * idents which gained or lost items (\ref touchedIdents).
+         */
         ResPoolProxy proxy( ResPool self ) const
         {
           checkSerial();
           if ( !_poolProxy )
           {
-            _poolProxy.reset( new ResPoolProxy( self, *this ) );
+            store();	// collect the touchedIdents
+            if ( _prevPoolProxy )
+              _poolProxy.reset( new ResPoolProxy( self, *this, *_prevPoolProxy ) );
+            else
+              _poolProxy.reset( new ResPoolProxy( self, *this ) );
+            _prevPoolProxy.reset();
+            _touchedIdents.clear();
           }
           return *_poolProxy;
         }
 
+        /** \ref id2item keys of items added or removed since the last \ref proxy was built. */
+        const IdentSet & touchedIdents() const
+        { return _touchedIdents; }
+
         /** True factory for \ref ResPool::EstablishedStates.
 	 * Internally we maintain the ResPool::EstablishedStates::Impl
 	 * reference shared_ptr. Updated whenever the pool content changes.
@@ -370,7 +386,19 @@ namespace zypp
 	    bool reusedIDs = _watcherIDs.remember( pool.serialIDs() );
             std::list<PoolItem> addedProducts;
 
+	    if ( reusedIDs )
+	    {
+	      // all PoolItems are recreated
+	      _id2itemDirty = true;
+	      _id2item.clear();
+	      _prevPoolProxy.reset();
+	      _touchedIdents.clear();
+	    }
+	    // collect the changed idents only if there is a proxy to update
+	    bool touch = bool(_prevPoolProxy);
+
 	    _store.resize( pool.capacity() );
+	    _storeIdents.resize( pool.capacity() );
 
             if ( pool.capacity() )
             {
@@ -381,12 +409,20 @@ namespace zypp
                 if ( ! s &&  pi )
                 {
                   // the PoolItem got invalidated (e.g unloaded repo)
+                  id2itemErase( _storeIdents[i], pi );
+                  if ( touch )
+                    _touchedIdents.insert( _storeIdents[i] );
                   pi = PoolItem();
                 }
                 else if ( reusedIDs || (s && ! pi) )
                 {
                   // new PoolItem to add
                   pi = PoolItem::makePoolItem( s ); // the only way to create a new one!
+                  _storeIdents[i] = id2itemKey( s );
+                  if ( ! _id2itemDirty )
+                    _id2item.insert( std::make_pair( _storeIdents[i], pi ) );
+                  if ( touch )
+                    _touchedIdents.insert( _storeIdents[i] );
                   // remember products for buddy processing (requires clean store)
                   if ( s.isKind( ResKind::product ) )
                     addedProducts.push_back( pi );
@@ -421,20 +457,21 @@ namespace zypp
           return _store;
         }
 
+	/** Index of all PoolItems by ident.
+	 * Once built, \ref store keeps it up to date when items are added
+	 * or removed. It's rebuilt from scratch only if the pool reused
+	 * the solvable IDs.
+	 */
 	const Id2ItemT & id2item () const
 	{
 	  checkSerial();
+	  store();
 	  if ( _id2itemDirty )
 	  {
-	    store();
 	    _id2item = Id2ItemT( size() );
             for_( it, begin(), end() )
             {
-              const sat::Solvable &s = (*it)->satSolvable();
-              sat::detail::IdType id = s.ident().id();
-              if ( s.isKind( ResKind::srcpackage ) )
-                id = -id;
-              _id2item.insert( std::make_pair( id, *it ) );
+              _id2item.insert( std::make_pair( _storeIdents[it->satSolvable().id()], *it ) );
             }
             //INT << _id2item << endl;
 	    _id2itemDirty = false;
@@ -442,6 +479,15 @@ namespace zypp
 	  return _id2item;
 	}
 
+        /** The \ref id2item key of \a solv_r (srcpackage idents are negated). */
+        static sat::detail::IdType id2itemKey( const sat::Solvable & solv_r )
+        {
+          sat::detail::IdType id = solv_r.ident().id();
+          if ( solv_r.isKind( ResKind::srcpackage ) )
+            id = -id;
+          return id;
+        }
+
         ///////////////////////////////////////////////////////////////////
         //
         ///////////////////////////////////////////////////////////////////
@@ -456,12 +502,31 @@ namespace zypp
         void invalidate() const
         {
           _storeDirty = true;
-	  _id2itemDirty = true;
-	  _id2item.clear();
-          _poolProxy.reset();
+          if ( _poolProxy )
+          {
+            // remember it as base for the next one
+            _prevPoolProxy = _poolProxy;
+            _poolProxy.reset();
+          }
 	  _establishedStates.reset();
         }
 
+        /** Remove \a pi_r from \ref _id2item (unless it's rebuilt anyway). */
+        void id2itemErase( sat::detail::IdType key_r, const PoolItem & pi_r ) const
+        {
+          if ( _id2itemDirty )
+            return;
+          auto range( _id2item.equal_range( key_r ) );
+          for ( auto it = range.first; it != range.second; ++it )
+          {
+            if ( it->second == pi_r )
+            {
+              _id2item.erase( it );
+              break;
+            }
+          }
+        }
+
       private:
         /** Watch sat pools serial number. */
         SerialNumberWatcher                   _watcher;
@@ -469,11 +534,16 @@ namespace zypp
         SerialNumberWatcher                   _watcherIDs;
         mutable ContainerT                    _store;
         mutable DefaultIntegral<bool,true>    _storeDirty;
+	/** The \ref id2item key of each item in \ref _store (still known after the solvable is gone). */
+        mutable std::vector<sat::detail::IdType> _storeIdents;
 	mutable Id2ItemT		      _id2item;
         mutable DefaultIntegral<bool,true>    _id2itemDirty;
 
       private:
         mutable shared_ptr<ResPoolProxy>      _poolProxy;
+	/** The last proxy handed out, if the pool changed since. */
+        mutable shared_ptr<ResPoolProxy>      _prevPoolProxy;
+	mutable IdentSet		      _touchedIdents;
 	mutable shared_ptr<EstablishedStatesImpl> _establishedStates;
 
       private:
@@ -0,0 +1,120 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/pool/PoolMemoryStats.cc
+ *
+*/
+extern "C"
+{
+#include <solv/pool.h>
+#include <solv/repo.h>
+#include <solv/repodata.h>
+}
+#include <iostream>
+
+#include <zypp/base/String.h>
+#include <zypp/pool/PoolMemoryStats.h>
+#include <zypp/sat/Pool.h>
+#include <zypp/ResPool.h>
+
+using std::endl;
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace pool
+  { /////////////////////////////////////////////////////////////////
+
+    PoolMemoryStats::PoolMemoryStats( bool respool_r )
+    {
+      sat::Pool satpool( sat::Pool::instance() );
+      const ::Pool * pool = satpool.get();
+
+      _strings       = pool->ss.nstrings;
+      _stringSpace   = pool->ss.sstrings + pool->ss.nstrings * sizeof(Offset);
+      if ( pool->ss.stringhashtbl )
+        _stringHash  = ( pool->ss.stringhashmask + 1 ) * sizeof(Id);
+
+      _rels          = pool->nrels;
+      _relSpace      = pool->nrels * sizeof(Reldep);
+
+      _solvables     = pool->nsolvables;
+      _solvableSpace = pool->nsolvables * sizeof(::Solvable);
+
+      if ( pool->whatprovides )
+      {
+        _whatprovides = pool->ss.nstrings * sizeof(Offset)
+                      + ( pool->whatprovidesdataoff + pool->whatprovidesdataleft ) * sizeof(Id);
+        if ( pool->whatprovides_rel )
+          _whatprovides += pool->nrels * sizeof(Offset);
+      }
+
+      for ( const Repository & repo : satpool.repos() )
+      {
+        ::Repo * crepo = repo.get();
+        RepoStats stats;
+        stats._alias     = repo.alias();
+        stats._solvables = crepo->nsolvables;
+        stats._idarray   = crepo->idarraysize * sizeof(Id);
+        int rdid = 0;
+        ::Repodata * data = nullptr;
+        FOR_REPODATAS( crepo, rdid, data )
+        {
+          stats._repodata += ::repodata_memused( data );
+          ++stats._nrepodata;
+        }
+        _repos.push_back( std::move(stats) );
+      }
+
+      if ( respool_r )
+      {
+        // A PoolItem per solvable ID, the items data and ResObject.
+        ResPool respool( ResPool::instance() );	// syncs the store
+        _poolItems     = respool.size();
+        _poolItemStore = satpool.capacity() * sizeof(PoolItem)
+                       + _poolItems * ( PoolItem::implSize() + sizeof(ResObject) );
+      }
+    }
+
+    ByteCount PoolMemoryStats::total() const
+    {
+      ByteCount ret = _stringSpace + _stringHash + _relSpace + _solvableSpace + _whatprovides + _poolItemStore;
+      for ( const RepoStats & repo : _repos )
+        ret += repo.total();
+      return ret;
+    }
+
+    /******************************************************************
+    **
+    **	FUNCTION NAME : operator<<
+    **	FUNCTION TYPE : std::ostream &
+    */
+    std::ostream & operator<<( std::ostream & str, const PoolMemoryStats & obj )
+    {
+      str << "Strings:\t" << obj._strings << " (" << obj._stringSpace << ", hash " << obj._stringHash << ")" << endl;
+      str << "Relations:\t" << obj._rels << " (" << obj._relSpace << ")" << endl;
+      str << "Solvables:\t" << obj._solvables << " (" << obj._solvableSpace << ")" << endl;
+      str << "Whatprovides:\t" << obj._whatprovides << endl;
+      str << "Repos:\t\t" << obj._repos.size();
+      for ( const PoolMemoryStats::RepoStats & repo : obj._repos )
+      {
+        str << endl << "  " << repo._alias << ":\t" << repo._solvables << " solvables (" << repo._idarray
+            << ", repodata " << repo._repodata << " in " << repo._nrepodata << ")";
+      }
+      if ( obj._poolItems )
+        str << endl << "ResPool:\t" << obj._poolItems << " items (" << obj._poolItemStore << ")";
+      return str << endl << "Total:\t\t" << obj.total();
+    }
+
+    /////////////////////////////////////////////////////////////////
+  } // namespace pool
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
@@ -0,0 +1,101 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/pool/PoolMemoryStats.h
+ *
+*/
+#ifndef ZYPP_POOL_POOLMEMORYSTATS_H
+#define ZYPP_POOL_POOLMEMORYSTATS_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <zypp/ByteCount.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace pool
+  { /////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : PoolMemoryStats
+    //
+    /** Memory used by the sat pool and the \ref ResPool.
+     *
+     * Constructing it takes a snapshot of the current pool. The sizes
+     * are computed from the array sizes libsolv maintains and the sizes
+     * of the \ref ResPool items, so they are a close lower bound (allocator
+     * and shared pointer overhead is not included).
+     *
+     * \note The \ref ResPool store is included only on request, because
+     * asking for it syncs the store with the sat pool (the items are created
+     * then). Take it once after the pool is loaded, not after each loading
+     * step.
+     * \code
+     * Strings:       98432 (2.4 MiB, hash 512.0 KiB)
+     * Relations:     21804 (255.5 KiB)
+     * Solvables:     61247 (1.4 MiB)
+     * Whatprovides:  3.1 MiB
+     * Repos:         4
+     *   @System:     2342 solvables (226.5 KiB, repodata 4.6 MiB in 1)
+     * ResPool:       61247 items (5.4 MiB)
+     * Total:         17.9 MiB
+     * \endcode
+     * \see tools/zypp-poolstats
+    */
+    struct PoolMemoryStats
+    {
+      /** Memory used by a repository. */
+      struct RepoStats
+      {
+        std::string _alias;
+        unsigned    _solvables = 0;
+        ByteCount   _idarray;		///< dependency arrays of the solvables
+        ByteCount   _repodata;		///< attribute data in memory (incl. filelists)
+        unsigned    _nrepodata = 0;
+
+        ByteCount total() const
+        { return _idarray + _repodata; }
+      };
+
+    public:
+      /** Take a snapshot of the current pool, with the \ref ResPool store if \a respool_r. */
+      explicit PoolMemoryStats( bool respool_r = false );
+
+      /** Sum of all sizes. */
+      ByteCount total() const;
+
+    public:
+      unsigned  _strings = 0;		///< \ref IdString count
+      ByteCount _stringSpace;		///< string data and offsets
+      ByteCount _stringHash;
+      unsigned  _rels = 0;		///< relational dependencies
+      ByteCount _relSpace;
+      unsigned  _solvables = 0;
+      ByteCount _solvableSpace;
+      ByteCount _whatprovides;		///< whatprovides index (0 unless prepared)
+      std::vector<RepoStats> _repos;
+      unsigned  _poolItems = 0;		///< items in the \ref ResPool (0 unless requested)
+      ByteCount _poolItemStore;		///< its store, items and their \ref ResObject
+    };
+    ///////////////////////////////////////////////////////////////////
+
+    /** \relates PoolMemoryStats Stream output */
+    std::ostream & operator<<( std::ostream & str, const PoolMemoryStats & obj );
+
+    /////////////////////////////////////////////////////////////////
+  } // namespace pool
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_POOL_POOLMEMORYSTATS_H
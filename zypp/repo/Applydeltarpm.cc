@@ -9,7 +9,11 @@
 /** \file	zypp/source/Applydeltarpm.cc
  *
 */
+#include <sys/wait.h>
+#include <errno.h>
 #include <iostream>
+#include <chrono>
+#include <future>
 
 #include <zypp/base/Logger.h>
 #include <zypp/base/String.h>
@@ -32,18 +36,21 @@ namespace zypp
     namespace
     { /////////////////////////////////////////////////////////////////
 
-      const Pathname   applydeltarpm_prog( "/usr/bin/applydeltarpm" );
+      /** The testsuite may use a fake via \c $ZYPP_TESTSUITE_APPLYDELTARPM. */
+      const Pathname & applydeltarpm_prog()
+      {
+        static const Pathname _prog( getenv("ZYPP_TESTSUITE_APPLYDELTARPM") ? getenv("ZYPP_TESTSUITE_APPLYDELTARPM") : "/usr/bin/applydeltarpm" );
+        return _prog;
+      }
       const str::regex applydeltarpm_tick ( "([0-9]+) percent finished" );
 
       /******************************************************************
        **
-       **	FUNCTION NAME : applydeltarpm
+       **	FUNCTION NAME : collect
        **	FUNCTION TYPE : bool
       */
-      bool applydeltarpm( const char *const argv_r[],
-                          const Progress & report_r  = Progress() )
+      bool collect( ExternalProgram & prog, const Progress & report_r )
       {
-        ExternalProgram prog( argv_r, ExternalProgram::Stderr_To_Stdout );
         str::smatch what;
         for ( std::string line = prog.receiveLine(); ! line.empty(); line = prog.receiveLine() )
           {
@@ -57,6 +64,18 @@ namespace zypp
         return( prog.close() == 0 );
       }
 
+      /******************************************************************
+       **
+       **	FUNCTION NAME : applydeltarpm
+       **	FUNCTION TYPE : bool
+      */
+      bool applydeltarpm( const char *const argv_r[],
+                          const Progress & report_r  = Progress() )
+      {
+        ExternalProgram prog( argv_r, ExternalProgram::Stderr_To_Stdout );
+        return collect( prog, report_r );
+      }
+
       /////////////////////////////////////////////////////////////////
     } // namespace
     ///////////////////////////////////////////////////////////////////
@@ -70,7 +89,7 @@ namespace zypp
     {
       // To track changes in availability of applydeltarpm.
       static TriBool _last = indeterminate;
-      PathInfo prog( applydeltarpm_prog );
+      PathInfo prog( applydeltarpm_prog() );
       bool have = prog.isX();
       if ( _last == have )
         ; // TriBool! 'else' is not '_last != have'
@@ -96,7 +115,7 @@ namespace zypp
         return false;
 
       const char *const argv[] = {
-        "/usr/bin/applydeltarpm",
+        applydeltarpm_prog().c_str(),
         ( quick_r ? "-C" : "-c" ),
         "-s", sequenceinfo_r.c_str(),
         NULL
@@ -116,7 +135,7 @@ namespace zypp
         return false;
 
       const char *const argv[] = {
-        "/usr/bin/applydeltarpm",
+        applydeltarpm_prog().c_str(),
         ( quick_r ? "-C" : "-c" ),
         delta_r.asString().c_str(),
         NULL
@@ -133,25 +152,7 @@ namespace zypp
     bool provide( const Pathname & delta_r, const Pathname & new_r,
                   const Progress & report_r )
     {
-      // cleanup on error
-      AutoDispose<const Pathname> guard( new_r, filesystem::unlink );
-
-      if ( ! haveApplydeltarpm() )
-        return false;
-
-      const char *const argv[] = {
-        "/usr/bin/applydeltarpm",
-        "-p", "-p", // twice to get percent output one per line
-        delta_r.asString().c_str(),
-        new_r.asString().c_str(),
-        NULL
-      };
-
-      if ( ! applydeltarpm( argv, report_r ) )
-        return false;
-
-      guard.resetDispose(); // no cleanup on success
-      return true;
+      return Rebuild( delta_r, new_r ).wait( report_r );
     }
 
     /******************************************************************
@@ -170,7 +171,7 @@ namespace zypp
         return false;
 
       const char *const argv[] = {
-        "/usr/bin/applydeltarpm",
+        applydeltarpm_prog().c_str(),
         "-p", "-p", // twice to get percent output one per line
         "-r", old_r.asString().c_str(),
         delta_r.asString().c_str(),
@@ -185,6 +186,87 @@ namespace zypp
       return true;
     }
 
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	class Rebuild
+    //
+    ///////////////////////////////////////////////////////////////////
+
+    struct Rebuild::Impl
+    {
+      Impl( const Pathname & delta_r, const Pathname & new_r )
+      : _new( new_r )
+      , _guard( new_r, filesystem::unlink )	// cleanup on error
+      , _start( std::chrono::steady_clock::now() )
+      {
+        if ( ! haveApplydeltarpm() )
+          return;
+
+        const char *const argv[] = {
+          applydeltarpm_prog().c_str(),
+          "-p", "-p", // twice to get percent output one per line
+          delta_r.asString().c_str(),
+          new_r.asString().c_str(),
+          NULL
+        };
+        _prog.reset( new ExternalProgram( argv, ExternalProgram::Stderr_To_Stdout ) );
+
+        // Note when the process exits, even if nobody waits for it yet.
+        // WNOWAIT leaves reaping to ExternalProgram::close.
+        pid_t pid = _prog->getpid();
+        _finished = std::async( std::launch::async, [pid]() {
+          siginfo_t info;
+          while ( ::waitid( P_PID, pid, &info, WEXITED|WNOWAIT ) == -1 && errno == EINTR )
+            ;
+          return std::chrono::steady_clock::now();
+        } );
+      }
+
+      ~Impl()
+      {
+        if ( _prog )
+        {
+          _prog->kill();
+          _prog.reset();
+        }
+        // _finished is joined on destruction
+      }
+
+      Pathname _new;
+      AutoDispose<const Pathname> _guard;
+      std::chrono::steady_clock::time_point _start;
+      std::future<std::chrono::steady_clock::time_point> _finished;
+      scoped_ptr<ExternalProgram> _prog;
+      double _seconds = 0.0;
+    };
+
+    Rebuild::Rebuild( const Pathname & delta_r, const Pathname & new_r )
+    : _pimpl( new Impl( delta_r, new_r ) )
+    {}
+
+    Rebuild::~Rebuild()
+    {}
+
+    bool Rebuild::wait( const Progress & report_r )
+    {
+      if ( ! _pimpl->_prog )
+        return false;
+
+      bool ret = collect( *_pimpl->_prog, report_r );
+      _pimpl->_prog.reset();
+      std::chrono::steady_clock::time_point finished { _pimpl->_finished.get() };
+      if ( ! ret )
+        return false;
+
+      std::chrono::duration<double> elapsed { finished - _pimpl->_start };
+      _pimpl->_seconds = elapsed.count();
+      _pimpl->_guard.resetDispose(); // no cleanup on success
+      return true;
+    }
+
+    double Rebuild::seconds() const
+    { return _pimpl->_seconds; }
+
     /////////////////////////////////////////////////////////////////
   } // namespace applydeltarpm
   ///////////////////////////////////////////////////////////////////
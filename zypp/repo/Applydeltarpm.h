@@ -16,6 +16,8 @@
 #include <string>
 
 #include <zypp/base/Function.h>
+#include <zypp/base/PtrTypes.h>
+#include <zypp/base/NonCopyable.h>
 #include <zypp/Pathname.h>
 
 ///////////////////////////////////////////////////////////////////
@@ -72,6 +74,37 @@ namespace zypp
     bool provide( const Pathname & old_r, const Pathname & delta_r,
                   const Pathname & new_r,
                   const Progress & report_r = Progress() );
+
+    /** Apply a binary delta to on-disk data in a background process.
+     *
+     * The rebuild starts when constructed, so several of them may run
+     * concurrently while the caller proceeds. \ref wait collects the
+     * result. A rebuild not waited for is killed on destruction and the
+     * incomplete rpm is removed.
+     * \see <tt>applydeltarpm deltarpm newrpm</tt>
+    */
+    class Rebuild : private base::NonCopyable
+    {
+    public:
+      /** Start re-creating \a new_r from \a delta_r. */
+      Rebuild( const Pathname & delta_r, const Pathname & new_r );
+
+      ~Rebuild();
+
+      /** Wait for the rebuild to complete, reporting progress.
+       * \returns Whether the new rpm was created.
+      */
+      bool wait( const Progress & report_r = Progress() );
+
+      /** Seconds the successful rebuild took (until the process exited,
+       * even if that was before \ref wait was called).
+      */
+      double seconds() const;
+
+    private:
+      struct Impl;
+      RW_pointer<Impl> _pimpl;
+    };
     //@}
 
     /////////////////////////////////////////////////////////////////
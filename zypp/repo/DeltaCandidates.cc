@@ -12,6 +12,8 @@ extern "C"
 }
 
 #include <iostream>
+#include <unordered_map>
+#include <vector>
 #include <zypp/base/Logger.h>
 #include <zypp/Repository.h>
 #include <zypp/repo/DeltaCandidates.h>
@@ -31,6 +33,33 @@ namespace zypp
     /** DeltaCandidates implementation. */
     struct DeltaCandidates::Impl
     {
+      public:
+        /** Target package name and arch of a delta.
+         * The edition is not part of the key, but compared by \ref Edition::operator==
+         * (like \c 0:1.0-1 and \c 1.0-1, equal but not the same \ref IdString).
+         */
+        struct Key
+        {
+          IdString::IdType name;
+          IdString::IdType arch;
+
+          bool operator==( const Key & rhs ) const
+          { return name == rhs.name && arch == rhs.arch; }
+        };
+
+        struct KeyHash
+        {
+          size_t operator()( const Key & key_r ) const
+          { return size_t(key_r.name) * 31 + key_r.arch; }
+        };
+
+        /** All deltas of the repos, indexed by their target package name and arch. */
+        struct Index
+        {
+          std::vector<DeltaRpm> deltas;	///< in repo order
+          std::unordered_map<Key,std::vector<unsigned>,KeyHash> byTarget;
+        };
+
       public:
         Impl()
         {}
@@ -39,9 +68,38 @@ namespace zypp
         : repos(repos), pkgname(pkgname)
         {}
 
+        /** The index is built on demand, once for all copies. */
+        const Index & index() const
+        {
+          if ( ! _index )
+          {
+            _index.reset( new Index );
+            for_( rit, repos.begin(), repos.end() )
+            {
+              sat::LookupRepoAttr q( sat::SolvAttr::repositoryDeltaInfo, *rit );
+              for_( it, q.begin(), q.end() )
+              {
+                if ( pkgname.empty()
+                     || it.subFind( sat::SolvAttr(DELTA_PACKAGE_NAME) ).asString() == pkgname )
+                {
+                  DeltaRpm delta( it );
+                  Key key { IdString( delta.name() ).id(), delta.arch().id() };
+                  _index->byTarget[key].push_back( _index->deltas.size() );
+                  _index->deltas.push_back( std::move(delta) );
+                }
+              }
+            }
+            MIL << "Indexed " << _index->deltas.size() << " deltas for " << _index->byTarget.size() << " packages" << endl;
+          }
+          return *_index;
+        }
+
         std::list<Repository> repos;
         std::string pkgname;
 
+      private:
+        mutable shared_ptr<Index> _index;
+
       private:
         friend Impl * rwcowClone<Impl>( const Impl * rhs );
         /** clone for RWCOW_pointer */
@@ -80,25 +138,23 @@ namespace zypp
       std::list<DeltaRpm> candidates;
 
       DBG << "package: " << package << endl;
-      for_( rit, _pimpl->repos.begin(), _pimpl->repos.end() )
+      const Impl::Index & index( _pimpl->index() );
+      if ( ! package )
+      {
+        candidates.insert( candidates.end(), index.deltas.begin(), index.deltas.end() );
+        return candidates;
+      }
+
+      Impl::Key key { IdString( package->name() ).id(), package->arch().id() };
+      auto it = index.byTarget.find( key );
+      if ( it != index.byTarget.end() )
       {
-        sat::LookupRepoAttr q( sat::SolvAttr::repositoryDeltaInfo, *rit );
-        for_( it, q.begin(), q.end() )
+        for ( unsigned idx : it->second )
         {
-          if ( _pimpl->pkgname.empty()
-               || it.subFind( sat::SolvAttr(DELTA_PACKAGE_NAME) ).asString() == _pimpl->pkgname )
-          {
-            DeltaRpm delta( it );
-            //DBG << "checking delta: " << delta << endl;
-            if ( ! package
-                   || (    package->name()    == delta.name()
-                        && package->edition() == delta.edition()
-                        && package->arch()    == delta.arch() ) )
-            {
-              DBG << "got delta candidate: " << delta << endl;
-              candidates.push_back( delta );
-            }
-          }
+          if ( index.deltas[idx].edition() != package->edition() )
+            continue;
+          DBG << "got delta candidate: " << index.deltas[idx] << endl;
+          candidates.push_back( index.deltas[idx] );
         }
       }
       return candidates;
@@ -12,6 +12,7 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <chrono>
 #include <zypp/repo/PackageDelta.h>
 #include <zypp/base/Logger.h>
 #include <zypp/base/Gettext.h>
@@ -61,11 +62,69 @@ namespace zypp
       repo::DownloadResolvableReport::Action _action;
     };
 
+    ///////////////////////////////////////////////////////////////////
+    /// \class PackageProviderPolicy::Throughput
+    /// \brief Accumulated package downloads and deltarpm rebuilds.
+    ///
+    /// The PackageProviders of a commit share it via their policy. Downloads
+    /// and rebuilds are measured on the thread providing the packages.
+    ///////////////////////////////////////////////////////////////////
+    struct PackageProviderPolicy::Throughput
+    {
+      /** Download throughput (bytes per second), \c 0 until a download was measured. */
+      double download() const
+      { return( _downloadSeconds > 0.0 ? _downloadBytes / _downloadSeconds : 0.0 ); }
+
+      /** Rebuild throughput (bytes of new rpm per second), \c 0 until a rebuild was measured. */
+      double rebuild() const
+      { return( _rebuildSeconds > 0.0 ? _rebuildBytes / _rebuildSeconds : 0.0 ); }
+
+      void downloaded( const ByteCount & size_r, double seconds_r )
+      { _downloadBytes += size_r; _downloadSeconds += seconds_r; }
+
+      void rebuilt( const ByteCount & size_r, double seconds_r )
+      {
+	if ( seconds_r > 0.0 )	// else unknown
+	{ _rebuildBytes += size_r; _rebuildSeconds += seconds_r; }
+      }
+
+    private:
+      double _downloadBytes = 0.0;
+      double _downloadSeconds = 0.0;
+      double _rebuildBytes = 0.0;
+      double _rebuildSeconds = 0.0;
+    };
+
+    ///////////////////////////////////////////////////////////////////
+    namespace
+    {
+      /** Measure a download. */
+      struct DownloadTimer
+      {
+	DownloadTimer( PackageProviderPolicy::Throughput & throughput_r )
+	: _throughput( throughput_r )
+	{}
+
+	void done( const ByteCount & size_r )
+	{
+	  std::chrono::duration<double> elapsed { std::chrono::steady_clock::now() - _start };
+	  _throughput.downloaded( size_r, elapsed.count() );
+	}
+
+	PackageProviderPolicy::Throughput & _throughput;
+	std::chrono::steady_clock::time_point _start { std::chrono::steady_clock::now() };
+      };
+    } // namespace
+    ///////////////////////////////////////////////////////////////////
 
     ///////////////////////////////////////////////////////////////////
     //	class PackageProviderPolicy
     ///////////////////////////////////////////////////////////////////
 
+    PackageProviderPolicy::PackageProviderPolicy()
+    : _throughput( new Throughput )
+    {}
+
     bool PackageProviderPolicy::queryInstalled( const std::string & name_r,
                                                 const Edition &     ed_r,
                                                 const Arch &        arch_r ) const
@@ -95,6 +154,12 @@ namespace zypp
 
       /** Whether the package is cached. */
       virtual bool isCached() const = 0;
+
+      /** Provide the package, deferring checksum and signature check to \ref verifyPackage. */
+      virtual ManagedFile fetchPackage() const = 0;
+
+      /** Check a package provided by \ref fetchPackage. */
+      virtual ManagedFile verifyPackage( const ManagedFile & file_r, const std::string & digest_r ) const = 0;
     };
 
     ///////////////////////////////////////////////////////////////////
@@ -113,6 +178,8 @@ namespace zypp
       : _policy( policy_r )
       , _package( package_r )
       , _access( access_r )
+      , _deferChecks(false)
+      , _checksPending(false)
       , _retry(false)
       {}
 
@@ -138,6 +205,29 @@ namespace zypp
       virtual bool isCached() const
       { return ! doProvidePackageFromCache()->empty(); }
 
+      /** Provide the package, deferring checksum and signature check. */
+      virtual ManagedFile fetchPackage() const
+      {
+	_deferChecks = true;
+	ManagedFile ret;
+	try
+	{
+	  ret = providePackage();
+	}
+	catch ( ... )
+	{
+	  _deferChecks = false;
+	  throw;
+	}
+	_deferChecks = false;
+	return ret;
+      }
+
+      /** Check a package provided by \ref fetchPackage.
+       * A cached or locally built package is already checked.
+       */
+      virtual ManagedFile verifyPackage( const ManagedFile & file_r, const std::string & digest_r ) const;
+
     protected:
       typedef PackageProviderImpl<TPackage>	Base;
       typedef callback::SendReport<repo::DownloadResolvableReport>	Report;
@@ -173,8 +263,34 @@ namespace zypp
 
 	ProvideFilePolicy policy;
 	policy.progressCB( bind( &Base::progressPackageDownload, this, _1 ) );
-	policy.fileChecker( bind( &Base::rpmSigFileChecker, this, _1 ) );
-	return _access.provideFile( _package->repoInfo(), loc, policy );
+	if ( _deferChecks )
+	  loc.setChecksum( CheckSum() );	// checked by verifyPackage
+	else
+	  policy.fileChecker( bind( &Base::rpmSigFileChecker, this, _1 ) );
+	DownloadTimer timer( _policy.throughput() );
+	ret = _access.provideFile( _package->repoInfo(), loc, policy );
+	if ( _package->repoInfo().url().schemeIsDownloading() )
+	  timer.done( loc.downloadSize() );
+	_checksPending = _deferChecks;
+	return ret;
+      }
+
+      /** Check a package provided by \ref fetchPackage.
+       * Called by \ref verifyPackage, which handles the users decision if
+       * a \ref FileCheckException is thrown. An empty return value means
+       * the package must be provided again.
+       */
+      virtual ManagedFile doVerifyPackage( const ManagedFile & file_r, const std::string & digest_r ) const
+      {
+	// A digest computed in advance spares reading the file again.
+	const CheckSum & checksum( _package->location().checksum() );
+	if ( ! checksum.empty() && ( digest_r.empty() || digest_r != str::toLower( checksum.checksum() ) ) )
+	{
+	  ChecksumFileChecker checker( checksum );
+	  checker( file_r );
+	}
+	rpmSigFileChecker( file_r );
+	return file_r;
       }
 
     protected:
@@ -335,12 +451,50 @@ namespace zypp
       }
       //@}
 
+      /** Handle the users decision about a package failing the checks.
+       * \returns \c true if the package should be provided again.
+       * \throws SkipRequestException or AbortRequestException
+       */
+      bool retryOnCheckFailure( const FileCheckException & excpt_r ) const
+      {
+	repo::DownloadResolvableReport::Action action = repo::DownloadResolvableReport::ABORT;
+	if ( const RpmSigCheckException * sigexcpt = dynamic_cast<const RpmSigCheckException *>( &excpt_r ) )
+	{
+	  // Signature verification error was already reported by the
+	  // rpmSigFileChecker. Just handle the users action decision:
+	  action = sigexcpt->action();
+	}
+	else
+	{
+	  const std::string & package_str = _package->asUserString();
+	  // TranslatorExplanation %s = package being checked for integrity
+	  action = report()->problem( _package, repo::DownloadResolvableReport::INVALID, str::form(_("Package %s seems to be corrupted during transfer. Do you want to retry retrieval?"), package_str.c_str() ) );
+	}
+
+	switch ( action )
+	{
+	  case repo::DownloadResolvableReport::RETRY:
+	    return true;
+	    break;
+	  case repo::DownloadResolvableReport::IGNORE:
+	    ZYPP_THROW(SkipRequestException("User requested skip of corrupted file"));
+	    break;
+	  default:
+	  case repo::DownloadResolvableReport::ABORT:
+	    ZYPP_THROW(AbortRequestException("User requested to abort"));
+	    break;
+	}
+	return false;
+      }
+
     protected:
       PackageProviderPolicy	_policy;
       TPackagePtr		_package;
       RepoMediaAccess &		_access;
+      mutable bool		_deferChecks;	///< fetchPackage: leave the checks to verifyPackage
+      mutable bool		_checksPending;	///< the provided package is not yet checked
 
-    private:
+    protected:
       typedef shared_ptr<void>	ScopedGuard;
 
       ScopedGuard newReport() const
@@ -354,6 +508,7 @@ namespace zypp
 				       ref(_report) ) );
       }
 
+    private:
       mutable bool               _retry;
       mutable shared_ptr<Report> _report;
       mutable Target_Ptr         _target;
@@ -364,6 +519,7 @@ namespace zypp
     ManagedFile PackageProviderImpl<TPackage>::providePackage() const
     {
       ScopedGuard guardReport( newReport() );
+      _checksPending = false;
 
       // check for cache hit:
       ManagedFile ret( providePackageFromCache() );
@@ -386,7 +542,7 @@ namespace zypp
 	  if ( ! loc.checksum().empty() )	// no cache hit without checksum
 	  {
 	    PathInfo pi( topCache.repoPackagesCachePath / info.packagesPath().basename() / info.path() / loc.filename() );
-	    if ( pi.isExist() && loc.checksum() == CheckSum( loc.checksum().type(), std::ifstream( pi.c_str() ) ) )
+	    if ( pi.isExist() && filesystem::is_checksum( pi.path(), loc.checksum() ) )
 	    {
 	      report()->start( _package, pi.path().asFileUrl() );
 	      const Pathname & dest( info.packagesPath() / info.path() / loc.filename() );
@@ -430,49 +586,11 @@ namespace zypp
 	    if ( ! _retry )
 	      ZYPP_RETHROW( excpt );
           }
-	catch ( const RpmSigCheckException & excpt )
-	  {
-	    ERR << "Failed to provide Package " << _package << endl;
-	    if ( ! _retry )
-	    {
-	      // Signature verification error was already reported by the
-	      // rpmSigFileChecker. Just handle the users action decision:
-	      switch ( excpt.action() )
-	      {
-		case repo::DownloadResolvableReport::RETRY:
-		  _retry = true;
-		  break;
-		case repo::DownloadResolvableReport::IGNORE:
-		  ZYPP_THROW(SkipRequestException("User requested skip of corrupted file"));
-		  break;
-		default:
-		case repo::DownloadResolvableReport::ABORT:
-		  ZYPP_THROW(AbortRequestException("User requested to abort"));
-		  break;
-	      }
-	    }
-	  }
         catch ( const FileCheckException & excpt )
           {
 	    ERR << "Failed to provide Package " << _package << endl;
 	    if ( ! _retry )
-	    {
-	      const std::string & package_str = _package->asUserString();
-	      // TranslatorExplanation %s = package being checked for integrity
-	      switch ( report()->problem( _package, repo::DownloadResolvableReport::INVALID, str::form(_("Package %s seems to be corrupted during transfer. Do you want to retry retrieval?"), package_str.c_str() ) ) )
-	      {
-		case repo::DownloadResolvableReport::RETRY:
-		  _retry = true;
-		  break;
-		case repo::DownloadResolvableReport::IGNORE:
-		  ZYPP_THROW(SkipRequestException("User requested skip of corrupted file"));
-		  break;
-		default:
-		case repo::DownloadResolvableReport::ABORT:
-		  ZYPP_THROW(AbortRequestException("User requested to abort"));
-		  break;
-	      }
-	    }
+	      _retry = retryOnCheckFailure( excpt );
 	  }
         catch ( const Exception & excpt )
           {
@@ -514,6 +632,36 @@ namespace zypp
       return ret;
     }
 
+    template <class TPackage>
+    ManagedFile PackageProviderImpl<TPackage>::verifyPackage( const ManagedFile & file_r, const std::string & digest_r ) const
+    {
+      if ( ! _checksPending )
+	return file_r;
+      _checksPending = false;
+
+      bool retry = false;
+      ManagedFile ret;
+      {
+	ScopedGuard guardReport( newReport() );
+	try
+	{
+	  ret = doVerifyPackage( file_r, digest_r );
+	}
+	catch ( const FileCheckException & excpt )
+	{
+	  ERR << "Failed to verify Package " << _package << endl;
+	  // bsc#1045735: Be sure no invalid files stay in the cache!
+	  ManagedFile( file_r ).setDispose( filesystem::unlink );
+	  retry = retryOnCheckFailure( excpt );
+	}
+      }
+      if ( retry || ret->empty() )
+	return providePackage();
+
+      MIL << "verified Package " << _package << " at " << ret << endl;
+      return ret;
+    }
+
 
     ///////////////////////////////////////////////////////////////////
     /// \class RpmPackageProvider
@@ -533,11 +681,28 @@ namespace zypp
     protected:
       virtual ManagedFile doProvidePackage() const;
 
+      virtual ManagedFile doVerifyPackage( const ManagedFile & file_r, const std::string & digest_r ) const;
+
     private:
       typedef packagedelta::DeltaRpm	DeltaRpm;
 
+      /** A rebuild from deltarpm left to \ref doVerifyPackage. */
+      struct PendingRebuild
+      {
+	ManagedFile _delta;
+	Pathname _builddest;
+	Pathname _cachedest;
+	scoped_ptr<applydeltarpm::Rebuild> _rebuild;
+      };
+
+      /** Whether the time to download and rebuild is less than downloading the full package. */
+      bool deltaPaysOff( const DeltaRpm & delta_r ) const;
+
       ManagedFile tryDelta( const DeltaRpm & delta_r ) const;
 
+      /** Check the rebuilt rpm and move it into the cache. */
+      ManagedFile finishDelta( const Pathname & builddest_r, const Pathname & cachedest_r ) const;
+
       bool progressDeltaDownload( int value ) const
       { return report()->progressDeltaDownload( value ); }
 
@@ -549,6 +714,8 @@ namespace zypp
 
     private:
       DeltaCandidates		_deltas;
+      mutable shared_ptr<PendingRebuild> _pendingRebuild;
+      mutable bool		_noDeltas = false;	///< a deferred rebuild failed
     };
     ///////////////////////////////////////////////////////////////////
 
@@ -557,7 +724,8 @@ namespace zypp
       // check whether to process patch/delta rpms
       // FIXME we only check the first url for now.
       if ( ZConfig::instance().download_use_deltarpm()
-	&& ( _package->repoInfo().url().schemeIsDownloading() || ZConfig::instance().download_use_deltarpm_always() ) )
+	&& ( _package->repoInfo().url().schemeIsDownloading() || ZConfig::instance().download_use_deltarpm_always() )
+	&& ! _noDeltas )
       {
 	std::list<DeltaRpm> deltaRpms;
 	_deltas.deltaRpms( _package ).swap( deltaRpms );
@@ -566,6 +734,8 @@ namespace zypp
 	{
 	  for_( it, deltaRpms.begin(), deltaRpms.end())
 	  {
+	    if ( ! deltaPaysOff( *it ) )
+	      continue;
 	    DBG << "tryDelta " << *it << endl;
 	    ManagedFile ret( tryDelta( *it ) );
 	    if ( ! ret->empty() )
@@ -594,7 +764,10 @@ namespace zypp
         {
           ProvideFilePolicy policy;
           policy.progressCB( bind( &RpmPackageProvider::progressDeltaDownload, this, _1 ) );
+          DownloadTimer timer( _policy.throughput() );
           delta = _access.provideFile( delta_r.repository().info(), delta_r.location(), policy );
+          if ( delta_r.repository().info().url().schemeIsDownloading() )
+            timer.done( delta_r.location().downloadSize() );
         }
       catch ( const Exception & excpt )
         {
@@ -603,35 +776,88 @@ namespace zypp
         }
       report()->finishDeltaDownload();
 
-      report()->startDeltaApply( delta );
-      if ( ! applydeltarpm::check( delta_r.baseversion().sequenceinfo() ) )
-        {
-          report()->problemDeltaApply( _("applydeltarpm check failed.") );
-          return ManagedFile();
-        }
-
-      // Build the package
       Pathname cachedest( _package->repoInfo().packagesPath() / _package->repoInfo().path() / _package->location().filename() );
       Pathname builddest( cachedest.extend( ".drpm" ) );
 
-      if ( ! applydeltarpm::provide( delta, builddest,
-                                     bind( &RpmPackageProvider::progressDeltaApply, this, _1 ) ) )
+      if ( _deferChecks )
+      {
+	// Rebuild in the background; doVerifyPackage collects the result.
+	_pendingRebuild.reset( new PendingRebuild );
+	_pendingRebuild->_delta = delta;
+	_pendingRebuild->_builddest = builddest;
+	_pendingRebuild->_cachedest = cachedest;
+	_pendingRebuild->_rebuild.reset( new applydeltarpm::Rebuild( delta, builddest ) );
+	_checksPending = true;
+	return ManagedFile( cachedest );
+      }
+
+      // Build the package
+      // (applydeltarpm verifies the result, so no extra 'applydeltarpm -c' pass)
+      report()->startDeltaApply( delta );
+      applydeltarpm::Rebuild rebuild( delta, builddest );
+      if ( ! rebuild.wait( bind( &RpmPackageProvider::progressDeltaApply, this, _1 ) ) )
         {
           report()->problemDeltaApply( _("applydeltarpm failed.") );
           return ManagedFile();
         }
-      ManagedFile builddestCleanup( builddest, filesystem::unlink );
+      _policy.throughput().rebuilt( PathInfo( builddest ).size(), rebuild.seconds() );
       report()->finishDeltaApply();
 
+      return finishDelta( builddest, cachedest );
+    }
+
+    ManagedFile RpmPackageProvider::finishDelta( const Pathname & builddest_r, const Pathname & cachedest_r ) const
+    {
+      ManagedFile builddestCleanup( builddest_r, filesystem::unlink );
+
       // Check and move it into the cache
       // Here the rpm itself is ready. If the packages sigcheck fails, it
       // makes no sense to return a ManagedFile() and fallback to download the
       // full rpm. It won't be different. So let the exceptions escape...
-      rpmSigFileChecker( builddest );
-      if ( filesystem::hardlinkCopy( builddest, cachedest ) != 0 )
-	ZYPP_THROW( Exception( str::Str() << "Can't hardlink/copy " << builddest << " to " << cachedest ) );
+      rpmSigFileChecker( builddest_r );
+      if ( filesystem::hardlinkCopy( builddest_r, cachedest_r ) != 0 )
+	ZYPP_THROW( Exception( str::Str() << "Can't hardlink/copy " << builddest_r << " to " << cachedest_r ) );
+
+      return ManagedFile( cachedest_r, filesystem::unlink );
+    }
+
+    ManagedFile RpmPackageProvider::doVerifyPackage( const ManagedFile & file_r, const std::string & digest_r ) const
+    {
+      if ( ! _pendingRebuild )
+	return Base::doVerifyPackage( file_r, digest_r );
+
+      shared_ptr<PendingRebuild> pending;
+      pending.swap( _pendingRebuild );
+
+      report()->startDeltaApply( pending->_delta );
+      if ( ! pending->_rebuild->wait( bind( &RpmPackageProvider::progressDeltaApply, this, _1 ) ) )
+      {
+	report()->problemDeltaApply( _("applydeltarpm failed.") );
+	_noDeltas = true;	// fall back to the full package
+	return ManagedFile();
+      }
+      _policy.throughput().rebuilt( PathInfo( pending->_builddest ).size(), pending->_rebuild->seconds() );
+      report()->finishDeltaApply();
+
+      return finishDelta( pending->_builddest, pending->_cachedest );
+    }
 
-      return ManagedFile( cachedest, filesystem::unlink );
+    bool RpmPackageProvider::deltaPaysOff( const DeltaRpm & delta_r ) const
+    {
+      double download = _policy.throughput().download();
+      double rebuild = _policy.throughput().rebuild();
+      if ( download <= 0.0 || rebuild <= 0.0 )
+	return true;	// nothing measured yet
+
+      double size = _package->downloadSize();
+      double viaFull = size / download;
+      double viaDelta = delta_r.location().downloadSize() / download + size / rebuild;
+      if ( viaDelta < viaFull )
+	return true;
+
+      MIL << "Skip " << delta_r.location().filename() << ": rebuild (" << ByteCount( rebuild ) << "/s) is slower than download ("
+          << ByteCount( download ) << "/s)" << endl;
+      return false;
     }
 
     ///////////////////////////////////////////////////////////////////
@@ -701,6 +927,12 @@ namespace zypp
     bool PackageProvider::isCached() const
     { return _pimpl->isCached(); }
 
+    ManagedFile PackageProvider::fetchPackage() const
+    { return _pimpl->fetchPackage(); }
+
+    ManagedFile PackageProvider::verifyPackage( const ManagedFile & file_r, const std::string & digest_r ) const
+    { return _pimpl->verifyPackage( file_r, digest_r ); }
+
   } // namespace repo
   ///////////////////////////////////////////////////////////////////
 } // namespace zypp
@@ -34,6 +34,14 @@ namespace zypp
     class PackageProviderPolicy
     {
     public:
+      /** Download and deltarpm rebuild throughput measured by the \ref PackageProvider
+       * using this policy. Shared by all copies of the policy.
+       */
+      struct Throughput;
+
+    public:
+      PackageProviderPolicy();
+
       /** Get installed Editions callback signature. */
       typedef function<bool ( const std::string &, const Edition &, const Arch & )> QueryInstalledCB;
 
@@ -46,8 +54,13 @@ namespace zypp
                            const Edition &     ed_r,
                            const Arch &        arch_r ) const;
 
+      /** The measured throughput. */
+      Throughput & throughput() const
+      { return *_throughput; }
+
     private:
       QueryInstalledCB _queryInstalledCB;
+      shared_ptr<Throughput> _throughput;
     };
     ///////////////////////////////////////////////////////////////////
 
@@ -93,6 +106,26 @@ namespace zypp
       /** Whether the package is cached. */
       bool isCached() const;
 
+      /** Provide the package like \ref providePackage, but leave checksum
+       * and signature check to \ref verifyPackage.
+       *
+       * Intended for preloading packages, where a packages digest can be
+       * computed while the next one is downloading.
+       * \throws Exception.
+       */
+      ManagedFile fetchPackage() const;
+
+      /** Check the package provided by \ref fetchPackage.
+       *
+       * A \a digest_r of the file computed in advance is compared to the
+       * expected checksum instead of reading the file again. The file is
+       * removed if it fails the checks. If the user decides to retry, the
+       * package is provided again (checked as by \ref providePackage).
+       * \returns The checked package.
+       * \throws SkipRequestException or AbortRequestException.
+       */
+      ManagedFile verifyPackage( const ManagedFile & file_r, const std::string & digest_r = std::string() ) const;
+
     public:
       struct Impl;              ///< Implementation class.
     private:
@@ -0,0 +1,207 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/repo/PlaindirSolv.cc
+ *
+*/
+extern "C"
+{
+#include <solv/pool.h>
+#include <solv/repo.h>
+#include <solv/repo_solv.h>
+#include <solv/repo_write.h>
+#include <solv/repo_rpmdb.h>
+#include <solv/repo_autopattern.h>
+}
+#include <solv/solvversion.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <thread>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <unordered_set>
+
+#include <zypp/base/LogTools.h>
+#include <zypp/base/String.h>
+#include <zypp/base/Errno.h>
+#include <zypp/AutoDispose.h>
+#include <zypp/repo/PlaindirSolv_p.h>
+
+using std::endl;
+
+#undef  ZYPP_BASE_LOGGER_LOGGROUP
+#define ZYPP_BASE_LOGGER_LOGGROUP "zypp::plaindir"
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace repo
+  {
+    ///////////////////////////////////////////////////////////////////
+    namespace
+    {
+      /** Rpms are read like \c repo2solv does, skipping delta and patch rpms
+       * as well as hidden files and directories.
+       */
+      inline bool isRpm( const std::string & path_r )
+      {
+	if ( ! str::endsWith( path_r, ".rpm" ) || str::endsWith( path_r, ".delta.rpm" ) || str::endsWith( path_r, ".patch.rpm" ) )
+	  return false;
+	return path_r[0] != '.' && path_r.find( "/." ) == std::string::npos;
+      }
+
+      /** Read some rpms into a private pool and return the repo as solv file image.
+       * Each thread uses its own pool, so no locking is needed. The images are
+       * merged into the target repo afterwards.
+       */
+      std::string readRpms( const Pathname & dir_r, std::vector<std::string> files_r )
+      {
+	AutoDispose<::Pool *> pool( ::pool_create(), ::pool_free );
+	::Repo * repo = ::repo_create( pool, "" );
+	::Repodata * data = ::repo_add_repodata( repo, 0 );
+
+	for ( const std::string & file : files_r )
+	{
+	  Id p = ::repo_add_rpm( repo, ( dir_r / file ).c_str(), REPO_REUSE_REPODATA|REPO_NO_INTERNALIZE|REPO_NO_LOCATION );
+	  if ( p )
+	    ::repodata_set_location( data, p, 0, 0, file.c_str() );
+	  else
+	    WAR << "Can't read " << dir_r / file << ": " << ::pool_errstr( pool ) << endl;
+	}
+	::repo_internalize( repo );
+
+	char * buf = nullptr;
+	size_t size = 0;
+	FILE * fp = ::open_memstream( &buf, &size );
+	if ( ! fp )
+	  return std::string();
+	int ret = ::repo_write( repo, fp );
+	::fclose( fp );
+	std::string image;
+	if ( ret == 0 )
+	  image.assign( buf, size );
+	else
+	  ERR << "Can't write solv image: " << ::pool_errstr( pool ) << endl;
+	::free( buf );
+	return image;
+      }
+    } // namespace
+    ///////////////////////////////////////////////////////////////////
+
+    bool buildPlaindirSolv( const Pathname & dir_r,
+			    const Pathname & oldsolv_r, const RepoStatus & oldstatus_r,
+			    const RepoStatus & newstatus_r,
+			    const Pathname & solvfile_r )
+    {
+      AutoDispose<::Pool *> pool( ::pool_create(), ::pool_free );
+      ::Repo * repo = ::repo_create( pool, "" );
+
+      // Keep the solvables of unchanged files from the old solv file.
+      // Solvables of removed or changed files and those without location
+      // (created by the autopattern code) are dropped; autopatterns are
+      // recreated below.
+      std::unordered_set<std::string> kept;
+      if ( ! oldsolv_r.empty() && ! oldstatus_r.fileTable().empty() )
+      {
+	AutoFILE fp( ::fopen( oldsolv_r.c_str(), "re" ) );
+	if ( ! fp || ::repo_add_solv( repo, fp, 0 ) != 0 )
+	{
+	  WAR << "Can't read old solv file " << oldsolv_r << ": " << ::pool_errstr( pool ) << endl;
+	  return false;
+	}
+
+	RepoStatus::FileChanges changes { RepoStatus::fileChanges( oldstatus_r, newstatus_r ) };
+	std::unordered_set<std::string> unchanged;
+	for ( const RepoStatus::FileInfo & file : newstatus_r.fileTable() )
+	  unchanged.insert( file._path );
+	for ( const std::string & file : changes._added )
+	  unchanged.erase( file );
+	for ( const std::string & file : changes._changed )
+	  unchanged.erase( file );
+
+	std::vector<Id> drop;
+	Id p;
+	::Solvable * s;
+	FOR_REPO_SOLVABLES( repo, p, s )
+	{
+	  const char * location = ::solvable_get_location( s, nullptr );
+	  if ( ! location || ! isRpm( location ) || ! unchanged.count( location ) || ! kept.insert( location ).second )
+	    drop.push_back( p );
+	}
+	for ( Id id : drop )
+	  ::repo_free_solvable( repo, id, /*reuseids*/false );
+	MIL << "Update from " << oldsolv_r << ": keep " << kept.size() << ", drop " << drop.size() << endl;
+      }
+
+      // Read the rpms not taken from the old solv file.
+      std::vector<std::string> toread;
+      for ( const RepoStatus::FileInfo & file : newstatus_r.fileTable() )
+      {
+	if ( isRpm( file._path ) && ! kept.count( file._path ) )
+	  toread.push_back( file._path );
+      }
+      MIL << "Build " << solvfile_r << ": read " << toread.size() << " of " << newstatus_r.fileTable().size() << " files" << endl;
+
+      // Each job reads its share of the rpms into a solv file image...
+      if ( ! toread.empty() )
+      {
+	size_t jobs = std::min( std::max( std::thread::hardware_concurrency(), 1U ), 8U );
+	jobs = std::min( jobs, toread.size() );
+	std::vector<std::future<std::string>> images;
+	for ( size_t job = 0; job < jobs; ++job )
+	{
+	  std::vector<std::string> files;
+	  for ( size_t i = job; i < toread.size(); i += jobs )
+	    files.push_back( toread[i] );
+	  images.push_back( std::async( std::launch::async, &readRpms, dir_r, std::move(files) ) );
+	}
+
+	// ...and add them to the repo.
+	for ( std::future<std::string> & future : images )
+	{
+	  std::string image { future.get() };
+	  if ( image.empty() )
+	    return false;
+	  AutoFILE fp( ::fmemopen( &image[0], image.size(), "r" ) );
+	  if ( ! fp || ::repo_add_solv( repo, fp, 0 ) != 0 )
+	  {
+	    ERR << "Can't add solv image: " << ::pool_errstr( pool ) << endl;
+	    return false;
+	  }
+	}
+      }
+
+      ::repo_add_autopattern( repo, 0 );	// like repo2solv -X
+
+      // RepoManager::loadFromCache rebuilds solv files lacking the tool version.
+      ::Repodata * meta = ::repo_add_repodata( repo, 0 );
+      ::repodata_set_str( meta, SOLVID_META, REPOSITORY_TOOLVERSION, LIBSOLV_TOOLVERSION );
+      ::repo_internalize( repo );
+
+      AutoFILE fp( ::fopen( solvfile_r.c_str(), "we" ) );
+      if ( ! fp )
+      {
+	ERR << "Can't create " << solvfile_r << ": " << Errno() << endl;
+	return false;
+      }
+      if ( ::repo_write( repo, fp ) != 0 || ::fflush( fp ) != 0 )
+      {
+	ERR << "Can't write " << solvfile_r << ": " << ::pool_errstr( pool ) << endl;
+	return false;
+      }
+      return true;
+    }
+
+  } // namespace repo
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
@@ -0,0 +1,47 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/repo/PlaindirSolv_p.h
+ *
+*/
+#ifndef ZYPP_REPO_PLAINDIRSOLV_P_H
+#define ZYPP_REPO_PLAINDIRSOLV_P_H
+
+#include <zypp/APIConfig.h>
+#include <zypp/Pathname.h>
+#include <zypp/RepoStatus.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace repo
+  {
+    /** Build the solv file of a plaindir repo without running \c repo2solv.
+     *
+     * Solvables of rpms unchanged between \a oldstatus_r and \a newstatus_r
+     * (same inode, size, mtime and digest, see \ref RepoStatus::fileChanges)
+     * are taken from \a oldsolv_r. Only new or changed rpms are read, using
+     * several threads. Without \a oldsolv_r all rpms are read.
+     *
+     * The result is written to \a solvfile_r and should be equivalent to
+     * <tt>repo2solv -X -R dir_r</tt>.
+     *
+     * \returns \c false if the solv file could not be built. The caller should
+     * fall back to \c repo2solv then.
+     */
+    ZYPP_LOCAL bool buildPlaindirSolv( const Pathname & dir_r,
+				       const Pathname & oldsolv_r, const RepoStatus & oldstatus_r,
+				       const RepoStatus & newstatus_r,
+				       const Pathname & solvfile_r );
+
+  } // namespace repo
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_REPO_PLAINDIRSOLV_P_H
@@ -607,6 +607,30 @@ namespace zypp
       return 0;
     }
 
+    std::string_view LookupAttr::iterator::asStringView() const
+    {
+      if ( _dip )
+      {
+        switch ( solvAttrType() )
+        {
+          case REPOKEY_TYPE_ID:
+          case REPOKEY_TYPE_IDARRAY:
+          case REPOKEY_TYPE_CONSTANTID:
+            if ( ISRELDEP( ::repodata_globalize_id( _dip->data, _dip->kv.id, 0 ) ) )
+              break;	// a Capability
+            // fall through
+          case REPOKEY_TYPE_STR:
+          case REPOKEY_TYPE_DIRSTRARRAY:
+            {
+              const char * ret( c_str() );
+              return ret ? ret : "";
+            }
+            break;
+        }
+      }
+      return std::string_view();
+    }
+
     std::string LookupAttr::iterator::asString() const
     {
       if ( _dip )
@@ -790,7 +814,12 @@ namespace zypp
         str << obj.inRepo();
 
       str << '<' << obj.inSolvAttr() << (obj.solvAttrSubEntry() ? ">(*" : ">(")
-          <<  IdString(obj.solvAttrType()) << ") = " << obj.asString();
+          <<  IdString(obj.solvAttrType()) << ") = ";
+      std::string_view val { obj.asStringView() };
+      if ( val.data() )
+        str << val;
+      else
+        str << obj.asString();
       return str;
     }
 
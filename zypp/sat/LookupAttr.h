@@ -13,6 +13,7 @@
 #define ZYPP_SAT_LOOKUPATTR_H
 
 #include <iosfwd>
+#include <string_view>
 
 #include <zypp/base/PtrTypes.h>
 #include <zypp/base/DefaultIntegral.h>
@@ -500,6 +501,13 @@ namespace zypp
 
         /** Conversion to string types. */
         const char * c_str() const;
+        /** \overload Not copying the string.
+         * Like the \ref c_str the view is valid until the iterator is advanced.
+         * Types not stored as string (numbers, checksums, dependencies) need
+         * \ref asString to get stringified. For them a view with \c data()
+         * \c NULL is returned.
+         */
+        std::string_view asStringView() const;
         /** \overload
          * If used with non-string types, this method tries to create
          * some appropriate string representation.
@@ -31,6 +31,7 @@ extern "C"
 #include <zypp/AutoDispose.h>
 
 #include <zypp/sat/detail/PoolImpl.h>
+#include <zypp/sat/detail/SearchIndex.h>
 #include <zypp/sat/Pool.h>
 #include <zypp/sat/LookupAttr.h>
 
@@ -187,7 +188,10 @@ namespace zypp
       // Using a temporay repo! (The additional parenthesis are required.)
       AutoDispose<Repository> tmprepo( (Repository::EraseFromPool()) );
       *tmprepo = reposInsert( alias_r );
+      bool fresh = tmprepo->solvablesEmpty();
       tmprepo->addSolv( file_r );
+      if ( fresh )
+        myPool().setSearchIndex( tmprepo->get(), detail::SearchIndex( tmprepo->get(), file_r ) );
 
       // no exceptions so we keep it:
       tmprepo.resetDispose();
@@ -301,6 +301,13 @@ namespace zypp
     /** Create solv file content digest for zypper bash completion */
     void updateSolvFileIndex( const Pathname & solvfile_r );
 
+    /** Create the trigram index narrowing file list searches in solv file
+     * (\c solvfile_r.trigrams). It's used by \ref PoolQuery once the solv
+     * file is loaded via \ref Pool::addRepoSolv.
+     * \see \ref ZConfig::repo_searchindex
+     */
+    void updateSolvFileSearchIndex( const Pathname & solvfile_r );
+
     /////////////////////////////////////////////////////////////////
   } // namespace sat
   ///////////////////////////////////////////////////////////////////
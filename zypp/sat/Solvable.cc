@@ -127,15 +127,21 @@ namespace zypp
     }
 
     std::string Solvable::lookupStrAttribute( const SolvAttr & attr ) const
+    { return std::string( lookupStrAttributeView( attr ) ); }
+
+    std::string Solvable::lookupStrAttribute( const SolvAttr & attr, const Locale & lang_r ) const
+    { return std::string( lookupStrAttributeView( attr, lang_r ) ); }
+
+    std::string_view Solvable::lookupStrAttributeView( const SolvAttr & attr ) const
     {
-      NO_SOLVABLE_RETURN( std::string() );
+      NO_SOLVABLE_RETURN( std::string_view() );
       const char * s = ::solvable_lookup_str( _solvable, attr.id() );
-      return s ? s : std::string();
+      return s ? s : std::string_view();
     }
 
-    std::string Solvable::lookupStrAttribute( const SolvAttr & attr, const Locale & lang_r ) const
+    std::string_view Solvable::lookupStrAttributeView( const SolvAttr & attr, const Locale & lang_r ) const
     {
-      NO_SOLVABLE_RETURN( std::string() );
+      NO_SOLVABLE_RETURN( std::string_view() );
       const char * s = 0;
       if ( !lang_r )
       {
@@ -151,7 +157,7 @@ namespace zypp
 	// here: no matching locale, so use default
 	s = ::solvable_lookup_str_lang( _solvable, attr.id(), 0, 0 );
       }
-      return s ? s : std::string();
+      return s ? s : std::string_view();
    }
 
     unsigned long long Solvable::lookupNumAttribute( const SolvAttr & attr ) const
@@ -402,7 +408,7 @@ namespace zypp
       if ( isKind<Package>() )
 	return provides().contains( Capability( retractedToken.id() ) );
       if ( isKind<Patch>() )
-	return lookupStrAttribute( SolvAttr::updateStatus ) == "retracted";
+	return lookupStrAttributeView( SolvAttr::updateStatus ) == "retracted";
       return false;
     }
 
@@ -715,6 +721,24 @@ namespace zypp
       return lookupStrAttribute( SolvAttr::description, lang_r );
     }
 
+    std::string_view Solvable::distributionView() const
+    {
+      NO_SOLVABLE_RETURN( std::string_view() );
+      return lookupStrAttributeView( SolvAttr::distribution );
+    }
+
+    std::string_view Solvable::summaryView( const Locale & lang_r ) const
+    {
+      NO_SOLVABLE_RETURN( std::string_view() );
+      return lookupStrAttributeView( SolvAttr::summary, lang_r );
+    }
+
+    std::string_view Solvable::descriptionView( const Locale & lang_r ) const
+    {
+      NO_SOLVABLE_RETURN( std::string_view() );
+      return lookupStrAttributeView( SolvAttr::description, lang_r );
+    }
+
     std::string	Solvable::insnotify( const Locale & lang_r ) const
     {
       NO_SOLVABLE_RETURN( std::string() );
@@ -13,6 +13,7 @@
 #define ZYPP_SAT_SOLVABLE_H
 
 #include <iosfwd>
+#include <string_view>
 
 #include <zypp/sat/detail/PoolMember.h>
 #include <zypp/sat/SolvAttr.h>
@@ -296,6 +297,15 @@ namespace zypp
       /** Long (multiline) text describing the solvable (opt. translated). */
       std::string description( const Locale & lang_r = Locale() ) const;
 
+      /** \ref distribution without copying the string (\see \ref lookupStrAttributeView). */
+      std::string_view distributionView() const;
+
+      /** \ref summary without copying the string (\see \ref lookupStrAttributeView). */
+      std::string_view summaryView( const Locale & lang_r = Locale() ) const;
+
+      /** \ref description without copying the string (\see \ref lookupStrAttributeView). */
+      std::string_view descriptionView( const Locale & lang_r = Locale() ) const;
+
       /** UI hint text when selecting the solvable for install (opt. translated). */
       std::string insnotify( const Locale & lang_r = Locale() ) const;
       /** UI hint text when selecting the solvable for uninstall (opt. translated).*/
@@ -355,6 +365,17 @@ namespace zypp
        */
       std::string lookupStrAttribute( const SolvAttr & attr, const Locale & lang_r ) const;
 
+      /** \ref lookupStrAttribute without copying the string.
+       *
+       * The view refers to the string stored in the pool. Use it right
+       * away (print, compare, match): It is valid until the next attribute
+       * lookup or until the pool content changes. Long strings may be paged
+       * in from the solv file on demand and the page may be reused.
+       */
+      std::string_view lookupStrAttributeView( const SolvAttr & attr ) const;
+      /** \overload Trying to look up a translated string attribute (\see \ref lookupStrAttribute). */
+      std::string_view lookupStrAttributeView( const SolvAttr & attr, const Locale & lang_r ) const;
+
       /**
        * returns the numeric attribute value for \ref attr
        * or 0 if it does not exists.
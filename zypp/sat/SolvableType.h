@@ -127,6 +127,9 @@ namespace zypp
 
       std::string	summary( const Locale & lang_r = Locale() ) const	{ return satSolvable().summary( lang_r ); }
       std::string	description( const Locale & lang_r = Locale() ) const	{ return satSolvable().description( lang_r ); }
+      std::string_view	distributionView() const		{ return satSolvable().distributionView(); }
+      std::string_view	summaryView( const Locale & lang_r = Locale() ) const	{ return satSolvable().summaryView( lang_r ); }
+      std::string_view	descriptionView( const Locale & lang_r = Locale() ) const	{ return satSolvable().descriptionView( lang_r ); }
       std::string	insnotify( const Locale & lang_r = Locale() ) const	{ return satSolvable().insnotify( lang_r ); }
       std::string	delnotify( const Locale & lang_r = Locale() ) const	{ return satSolvable().delnotify( lang_r ); }
       std::string	licenseToConfirm( const Locale & lang_r = Locale() ) const	{ return satSolvable().licenseToConfirm( lang_r ); }
@@ -135,6 +138,8 @@ namespace zypp
     public:
       std::string	lookupStrAttribute( const SolvAttr & attr ) const	{ return satSolvable().lookupStrAttribute( attr ); }
       std::string	lookupStrAttribute( const SolvAttr & attr, const Locale & lang_r ) const	{ return satSolvable().lookupStrAttribute( attr, lang_r ); }
+      std::string_view	lookupStrAttributeView( const SolvAttr & attr ) const	{ return satSolvable().lookupStrAttributeView( attr ); }
+      std::string_view	lookupStrAttributeView( const SolvAttr & attr, const Locale & lang_r ) const	{ return satSolvable().lookupStrAttributeView( attr, lang_r ); }
       bool		lookupBoolAttribute( const SolvAttr & attr ) const	{ return satSolvable().lookupBoolAttribute( attr ); }
       detail::IdType	lookupIdAttribute( const SolvAttr & attr ) const	{ return satSolvable().lookupIdAttribute( attr ); }
       unsigned long long lookupNumAttribute( const SolvAttr & attr ) const	{ return satSolvable().lookupNumAttribute( attr ); }
@@ -25,6 +25,7 @@
 #include <zypp/ZConfig.h>
 
 #include <zypp/sat/detail/PoolImpl.h>
+#include <zypp/sat/detail/SearchIndex.h>
 #include <zypp/sat/SolvableSet.h>
 #include <zypp/sat/Pool.h>
 #include <zypp/Capability.h>
@@ -265,6 +266,7 @@ namespace zypp
           else if ( a2 ) MIL << a1 << " " << a2 << endl;
           else           MIL << a1 << endl;
         }
+        _serialDeps.setDirty();
         ::pool_freewhatprovides( _pool );
       }
 
@@ -314,6 +316,7 @@ namespace zypp
 	if ( isSystemRepo( repo_r ) )
 	  _autoinstalled.clear();
         eraseRepoInfo( repo_r );
+        eraseSearchIndex( repo_r );
         ::repo_free( repo_r, /*resusePoolIDs*/false );
 	// If the last repo is removed clear the pool to actually reuse all IDs.
 	// NOTE: the explicit ::repo_free above asserts all solvables are memset(0)!
@@ -26,6 +26,7 @@ extern "C"
 #include <zypp/base/SerialNumber.h>
 #include <zypp/base/SetTracker.h>
 #include <zypp/sat/detail/PoolMember.h>
+#include <zypp/sat/detail/SearchIndex.h>
 #include <zypp/sat/SolvableSpec.h>
 #include <zypp/sat/Queue.h>
 #include <zypp/RepoInfo.h>
@@ -71,6 +72,12 @@ namespace zypp
           const SerialNumber & serialIDs() const
           { return _serialIDs; }
 
+          /** Serial number changing whenever dependency related indices are invalidated
+           * (content, requested locales, namespaces). Whatprovides results may differ then.
+           */
+          const SerialNumber & serialDeps() const
+          { return _serialDeps; }
+
           /** Update housekeeping data (e.g. whatprovides).
            * \todo actually requires a watcher.
            */
@@ -211,6 +218,20 @@ namespace zypp
           void eraseRepoInfo( RepoIdType id_r )
           { _repoinfos.erase( id_r ); }
 
+          /** The file list \ref SearchIndex attached to repo \a id_r (empty if none). */
+          const SearchIndex & searchIndex( RepoIdType id_r ) const
+          {
+            static const SearchIndex _none;
+            auto it = _searchIndices.find( id_r );
+            return( it != _searchIndices.end() ? it->second : _none );
+          }
+          /** Remember the \ref SearchIndex for repo \a id_r (if there is one). */
+          void setSearchIndex( RepoIdType id_r, const SearchIndex & index_r )
+          { if ( index_r ) _searchIndices[id_r] = index_r; else _searchIndices.erase( id_r ); }
+          /** */
+          void eraseSearchIndex( RepoIdType id_r )
+          { _searchIndices.erase( id_r ); }
+
         public:
           /** Returns the id stored at \c offset_r in the internal
            * whatprovidesdata array.
@@ -335,10 +356,14 @@ namespace zypp
           SerialNumber _serial;
           /** Serial number of IDs - changes whenever resusePoolIDs==true - ResPool must also invalidate it's PoolItems! */
           SerialNumber _serialIDs;
+          /** Serial number of dependency related indices - changes with each \ref depSetDirty. */
+          SerialNumber _serialDeps;
           /** Watch serial number. */
           SerialNumberWatcher _watcher;
           /** Additional \ref RepoInfo. */
           std::map<RepoIdType,RepoInfo> _repoinfos;
+          /** File list \ref SearchIndex of the repos having one. */
+          std::map<RepoIdType,SearchIndex> _searchIndices;
 
           /**  */
 	  base::SetTracker<LocaleSet> _requestedLocalesTracker;
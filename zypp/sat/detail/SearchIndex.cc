@@ -0,0 +1,430 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/sat/detail/SearchIndex.cc
+ *
+*/
+extern "C"
+{
+#include <solv/pool.h>
+#include <solv/repo.h>
+#include <solv/repo_solv.h>
+}
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+#include <unordered_map>
+
+#include <zypp/base/LogTools.h>
+#include <zypp/base/PtrTypes.h>
+#include <zypp/AutoDispose.h>
+#include <zypp/PathInfo.h>
+
+#include <zypp/sat/detail/SearchIndex.h>
+#include <zypp/sat/detail/PoolImpl.h>
+#include <zypp/sat/Pool.h>
+
+#undef ZYPP_BASE_LOGGER_LOGGROUP
+#define ZYPP_BASE_LOGGER_LOGGROUP "solvidx"
+
+using std::endl;
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace sat
+  {
+    ///////////////////////////////////////////////////////////////////
+    namespace detail
+    {
+      ///////////////////////////////////////////////////////////////////
+      namespace
+      {
+	// File layout (host byte order, it's a local cache file):
+	//   Header
+	//   Entry[ntrigrams]	sorted by trigram
+	//   posting lists	varint encoded solvable offset deltas
+	constexpr char indexMagic[8] = { 'Z', 'Y', 'P', 'P', 'T', 'R', 'I', '1' };
+
+	/** Trigrams in more than 1/commonRatio of the solvables don't get a posting list. */
+	constexpr unsigned commonRatio = 4;
+
+	struct Header
+	{
+	  char          magic[8];
+	  std::uint64_t solvsize;	///< size of the solv file the index was built from
+	  std::int64_t  solvmtime;	///< mtime of the solv file the index was built from
+	  std::uint32_t nsolvables;	///< solvables in the solv file
+	  std::uint32_t ntrigrams;
+
+	  bool matches( const PathInfo & solv_r ) const
+	  { return ::memcmp( magic, indexMagic, sizeof(magic) ) == 0
+	      && solvsize == std::uint64_t(solv_r.size()) && solvmtime == std::int64_t(solv_r.mtime()); }
+	};
+
+	struct Entry
+	{
+	  std::uint32_t trigram;
+	  std::uint32_t count;		///< solvables containing the trigram
+	  std::uint32_t size;		///< bytes in the posting list; \c 0 if too common
+	};
+
+	inline unsigned char asciiLower( unsigned char ch_r )
+	{ return( ch_r >= 'A' && ch_r <= 'Z' ? ch_r + ( 'a' - 'A' ) : ch_r ); }
+
+	/** Append the trigrams of \a str_r to \a trigrams_r. */
+	void collectTrigrams( std::string_view str_r, std::vector<std::uint32_t> & trigrams_r )
+	{
+	  for ( std::string_view::size_type i = 2; i < str_r.size(); ++i )
+	    trigrams_r.push_back( std::uint32_t(asciiLower( str_r[i-2] )) << 16
+	                        | std::uint32_t(asciiLower( str_r[i-1] )) << 8
+	                        | std::uint32_t(asciiLower( str_r[i] )) );
+	}
+
+	void putVarint( std::string & str_r, std::uint32_t val_r )
+	{
+	  while ( val_r >= 0x80 )
+	  {
+	    str_r += char( val_r | 0x80 );
+	    val_r >>= 7;
+	  }
+	  str_r += char( val_r );
+	}
+
+	template <class Tp>
+	inline void putRaw( std::ostream & str_r, const Tp & val_r )
+	{ str_r.write( reinterpret_cast<const char *>( &val_r ), sizeof(Tp) ); }
+
+	template <class Tp>
+	inline bool getRaw( std::istream & str_r, Tp & val_r )
+	{ return bool(str_r.read( reinterpret_cast<char *>( &val_r ), sizeof(Tp) )); }
+
+	/** Posting list under construction. */
+	struct Posting
+	{
+	  std::uint32_t count = 0;
+	  std::uint32_t last = 0;
+	  std::string   data;
+
+	  void add( std::uint32_t offset_r )
+	  {
+	    putVarint( data, offset_r - last );
+	    last = offset_r;
+	    ++count;
+	  }
+	};
+
+	///////////////////////////////////////////////////////////////////
+	/// \class Index
+	/// \brief A loaded index file.
+	///////////////////////////////////////////////////////////////////
+	struct Index
+	{
+	  /** Read the index in \a file_r if it still matches the \a header_r read on attach. */
+	  static shared_ptr<const Index> load( const Pathname & file_r, const Header & header_r )
+	  {
+	    std::ifstream in( file_r.c_str(), std::ios::binary );
+	    Header header;
+	    if ( ! getRaw( in, header ) || ::memcmp( &header, &header_r, sizeof(Header) ) != 0 )
+	      return nullptr;
+
+	    shared_ptr<Index> ret( new Index );
+	    ret->_nsolvables = header.nsolvables;
+	    ret->_entries.resize( header.ntrigrams );
+	    ret->_offsets.resize( header.ntrigrams );
+	    std::uint32_t offset = 0;
+	    for ( std::uint32_t i = 0; i < header.ntrigrams; ++i )
+	    {
+	      if ( ! getRaw( in, ret->_entries[i] ) )
+		return nullptr;
+	      ret->_offsets[i] = offset;
+	      offset += ret->_entries[i].size;
+	    }
+	    ret->_postings.assign( std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>() );
+	    if ( ret->_postings.size() != offset )
+	      return nullptr;
+	    return ret;
+	  }
+
+	  /** The entry for \a trigram_r or \c nullptr if no solvable contains it. */
+	  const Entry * find( std::uint32_t trigram_r ) const
+	  {
+	    auto it { std::lower_bound( _entries.begin(), _entries.end(), trigram_r,
+					[]( const Entry & lhs, std::uint32_t rhs ) { return lhs.trigram < rhs; } ) };
+	    return( it != _entries.end() && it->trigram == trigram_r ? &*it : nullptr );
+	  }
+
+	  /** The solvable offsets listed for \a entry_r. */
+	  std::vector<std::uint32_t> postings( const Entry & entry_r ) const
+	  {
+	    std::vector<std::uint32_t> ret;
+	    ret.reserve( entry_r.count );
+	    const char * p = _postings.data() + _offsets[&entry_r - _entries.data()];
+	    const char * e = p + entry_r.size;
+	    std::uint32_t offset = 0;
+	    while ( p != e )
+	    {
+	      std::uint32_t delta = 0;
+	      for ( unsigned shift = 0; p != e; shift += 7 )
+	      {
+		unsigned char ch = *p++;
+		delta |= std::uint32_t( ch & 0x7f ) << shift;
+		if ( ! ( ch & 0x80 ) )
+		  break;
+	      }
+	      offset += delta;
+	      ret.push_back( offset );
+	    }
+	    return ret;
+	  }
+
+	  std::uint32_t              _nsolvables = 0;
+	  std::vector<Entry>         _entries;
+	  std::vector<std::uint32_t> _offsets;	///< start of each entries posting list
+	  std::string                _postings;
+	};
+
+      } // namespace
+      ///////////////////////////////////////////////////////////////////
+
+      /** An index attached to a repo. */
+      struct SearchIndex::Impl
+      {
+	CRepo *        _repo = nullptr;
+	Pathname       _file;
+	Header         _header;
+	SolvableIdType _start = 0;	///< id of the repos 1st solvable
+	mutable bool   _loaded = false;
+	mutable shared_ptr<const Index> _index;
+      };
+
+      SearchIndex::SearchIndex()
+      {}
+
+      SearchIndex::SearchIndex( CRepo * repo_r, const Pathname & solvfile_r )
+      {
+	Pathname idxfile( indexFile( solvfile_r ) );
+	std::ifstream in( idxfile.c_str(), std::ios::binary );
+	if ( ! in )
+	  return;	// no index built
+
+	std::unique_ptr<Impl> entry( new Impl );
+	if ( ! getRaw( in, entry->_header ) || ! entry->_header.matches( PathInfo( solvfile_r ) )
+	     || entry->_header.nsolvables != std::uint32_t( repo_r->end - repo_r->start ) )
+	{
+	  WAR << "Ignore outdated search index " << idxfile << endl;
+	  return;
+	}
+	entry->_repo = repo_r;
+	entry->_file = idxfile;
+	entry->_start = repo_r->start;
+	_pimpl.reset( entry.release() );
+      }
+
+      SearchIndex::operator bool() const
+      { return bool(_pimpl); }
+
+      Pathname SearchIndex::indexFile( const Pathname & solvfile_r )
+      { return solvfile_r.extend( ".trigrams" ); }
+
+      bool SearchIndex::build( const Pathname & solvfile_r )
+      {
+	PathInfo solvinfo( solvfile_r );
+	AutoDispose<FILE*> solv( ::fopen( solvfile_r.c_str(), "re" ), ::fclose );
+	if ( solv == NULL )
+	{
+	  solv.resetDispose();
+	  ERR << "Can't open solv-file: " << solvfile_r << endl;
+	  return false;
+	}
+
+	std::unordered_map<std::uint32_t,Posting> postings;
+	std::uint32_t nsolvables = 0;
+	bool ok = true;
+
+	CPool * _pool = ::pool_create();
+	CRepo * _repo = ::repo_create( _pool, "" );
+	if ( ::repo_add_solv( _repo, solv, 0 ) == 0 )
+	{
+	  nsolvables = _repo->end - _repo->start;
+
+	  std::vector<std::uint32_t> trigrams;
+	  IdType insolv = 0;
+	  auto flush = [&]() {
+	    std::sort( trigrams.begin(), trigrams.end() );
+	    trigrams.erase( std::unique( trigrams.begin(), trigrams.end() ), trigrams.end() );
+	    for ( std::uint32_t trigram : trigrams )
+	      postings[trigram].add( insolv - _repo->start );
+	    trigrams.clear();
+	  };
+
+	  ::Dataiterator di;
+	  ::dataiterator_init( &di, _pool, _repo, 0, SOLVABLE_FILELIST, 0, 0 );
+	  while ( ::dataiterator_step( &di ) )
+	  {
+	    if ( di.solvid != insolv )
+	    {
+	      flush();
+	      insolv = di.solvid;
+	    }
+	    collectTrigrams( ::repodata_dir2str( di.data, di.kv.id, di.kv.str ), trigrams );
+	  }
+	  flush();
+	  ::dataiterator_free( &di );
+	}
+	else
+	{
+	  ERR << "Can't read solv-file: " << ::pool_errstr( _pool ) << endl;
+	  ok = false;
+	}
+	::repo_free( _repo, 0 );
+	::pool_free( _pool );
+	if ( ! ok )
+	  return false;
+
+	std::vector<std::uint32_t> keys;
+	keys.reserve( postings.size() );
+	for ( const auto & el : postings )
+	  keys.push_back( el.first );
+	std::sort( keys.begin(), keys.end() );
+
+	Pathname idxfile( indexFile( solvfile_r ) );
+	Pathname tmpfile( idxfile.extend( ".new" ) );
+	{
+	  std::ofstream out( tmpfile.c_str(), std::ios::binary|std::ios::trunc );
+	  Header header;
+	  ::memcpy( header.magic, indexMagic, sizeof(indexMagic) );
+	  header.solvsize   = solvinfo.size();
+	  header.solvmtime  = solvinfo.mtime();
+	  header.nsolvables = nsolvables;
+	  header.ntrigrams  = keys.size();
+	  putRaw( out, header );
+
+	  std::uint64_t common = 0;
+	  std::uint64_t space = 0;
+	  for ( std::uint32_t key : keys )
+	  {
+	    Posting & posting( postings[key] );
+	    if ( posting.count * commonRatio > nsolvables )
+	    {
+	      posting.data.clear();
+	      ++common;
+	    }
+	    putRaw( out, Entry{ key, posting.count, std::uint32_t(posting.data.size()) } );
+	    space += posting.data.size();
+	  }
+	  for ( std::uint32_t key : keys )
+	  {
+	    const std::string & data( postings[key].data );
+	    out.write( data.data(), data.size() );
+	  }
+
+	  if ( ! out.flush() )
+	  {
+	    ERR << "Can't write search index: " << tmpfile << endl;
+	    filesystem::unlink( tmpfile );
+	    return false;
+	  }
+	  MIL << idxfile << ": " << nsolvables << " solvables, " << keys.size() << " trigrams ("
+	      << common << " common), " << ByteCount( space ) << " postings" << endl;
+	}
+	return filesystem::rename( tmpfile, idxfile ) == 0;
+      }
+
+      bool SearchIndex::candidates( CRepo * repo_r, const std::vector<std::string> & literals_r, std::vector<SolvableIdType> & result_r )
+      { return PoolMember::myPool().searchIndex( repo_r ).candidates( literals_r, result_r ); }
+
+      bool SearchIndex::candidates( const std::vector<std::string> & literals_r, std::vector<SolvableIdType> & result_r ) const
+      {
+	if ( ! _pimpl )
+	  return false;
+
+	const Impl & entry( *_pimpl );
+	CRepo * repo_r = entry._repo;
+	if ( ! entry._loaded )
+	{
+	  entry._loaded = true;
+	  entry._index = Index::load( entry._file, entry._header );
+	  if ( ! entry._index )
+	    WAR << "Can't read search index " << entry._file << endl;
+	}
+	if ( ! entry._index )
+	  return false;
+	const Index & index( *entry._index );
+
+	std::vector<std::uint32_t> trigrams;
+	for ( const std::string & literal : literals_r )
+	  collectTrigrams( literal, trigrams );
+	std::sort( trigrams.begin(), trigrams.end() );
+	trigrams.erase( std::unique( trigrams.begin(), trigrams.end() ), trigrams.end() );
+
+	// Intersect the posting lists, shortest first.
+	std::vector<const Entry *> entries;
+	bool nomatch = false;
+	for ( std::uint32_t trigram : trigrams )
+	{
+	  const Entry * e = index.find( trigram );
+	  if ( ! e )
+	  {
+	    nomatch = true;	// no file list contains it
+	    break;
+	  }
+	  if ( e->size )
+	    entries.push_back( e );
+	}
+	if ( ! nomatch && entries.empty() )
+	  return false;		// nothing to narrow the search
+
+	std::vector<std::uint32_t> hits;
+	if ( ! nomatch )
+	{
+	  std::sort( entries.begin(), entries.end(), []( const Entry * lhs, const Entry * rhs ) { return lhs->count < rhs->count; } );
+	  hits = index.postings( *entries.front() );
+	  for ( auto eit = std::next( entries.begin() ); eit != entries.end() && ! hits.empty(); ++eit )
+	  {
+	    std::vector<std::uint32_t> postings( index.postings( **eit ) );
+	    std::vector<std::uint32_t> common;
+	    std::set_intersection( hits.begin(), hits.end(), postings.begin(), postings.end(), std::back_inserter( common ) );
+	    hits.swap( common );
+	  }
+	}
+
+	result_r.clear();
+	for ( std::uint32_t offset : hits )
+	{
+	  SolvableIdType id = entry._start + offset;
+	  if ( id < SolvableIdType(repo_r->end) && repo_r->pool->solvables[id].repo == repo_r )
+	    result_r.push_back( id );
+	}
+	// Solvables added to the repo after loading the solv file are not indexed.
+	for ( SolvableIdType id = entry._start + index._nsolvables; id < SolvableIdType(repo_r->end); ++id )
+	{
+	  if ( repo_r->pool->solvables[id].repo == repo_r )
+	    result_r.push_back( id );
+	}
+	DBG << repo_r->name << ": " << result_r.size() << " of " << repo_r->nsolvables << " solvables may match" << endl;
+	return true;
+      }
+
+    } // namespace detail
+    ///////////////////////////////////////////////////////////////////
+
+    void updateSolvFileSearchIndex( const Pathname & solvfile_r )
+    {
+      filesystem::unlink( detail::SearchIndex::indexFile( solvfile_r ) );
+      detail::SearchIndex::build( solvfile_r );
+    }
+
+  } // namespace sat
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
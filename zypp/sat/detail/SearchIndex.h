@@ -0,0 +1,88 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/sat/detail/SearchIndex.h
+ *
+*/
+#ifndef ZYPP_SAT_DETAIL_SEARCHINDEX_H
+#define ZYPP_SAT_DETAIL_SEARCHINDEX_H
+
+#include <string>
+#include <vector>
+
+#include <zypp/base/PtrTypes.h>
+#include <zypp/Pathname.h>
+#include <zypp/sat/detail/PoolMember.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace sat
+  {
+    ///////////////////////////////////////////////////////////////////
+    namespace detail
+    {
+      ///////////////////////////////////////////////////////////////////
+      /// \class SearchIndex
+      /// \brief Trigram index narrowing a file list search to the solvables which may match.
+      ///
+      /// The index is built from a repos solv file by \ref sat::updateSolvFileSearchIndex
+      /// and stored next to it (<tt>solv.trigrams</tt>). For each trigram (3 consecutive
+      /// bytes, ASCII lowercased) occurring in the file list of a solvable it lists
+      /// the solvables containing it. A file list can only match a literal string if
+      /// it contains all trigrams of the string. So the candidates are found by
+      /// intersecting the lists. The exact matching is still up to the caller.
+      ///
+      /// \ref Pool::addRepoSolv attaches the index to the loaded repo if it was built
+      /// for the very same solv file. The \ref PoolImpl keeps it along with the repo
+      /// (\ref PoolImpl::searchIndex). The index is read on first use.
+      ///////////////////////////////////////////////////////////////////
+      class SearchIndex
+      {
+      public:
+	/** No index. */
+	SearchIndex();
+
+	/** The index for \a repo_r if \a solvfile_r (just loaded into the empty repo) has an up to date one. */
+	SearchIndex( CRepo * repo_r, const Pathname & solvfile_r );
+
+	/** Whether there is an index. */
+	explicit operator bool() const;
+
+	/** Collect the solvables in the repo whose file list may contain all \a literals_r (sorted).
+	 * \returns \c false if there is no usable index or the \a literals_r are too
+	 * short or too common to narrow the search. The whole repo must be searched then.
+	 */
+	bool candidates( const std::vector<std::string> & literals_r, std::vector<SolvableIdType> & result_r ) const;
+
+      public:
+	/** Name of the index file built for \a solvfile_r. */
+	static Pathname indexFile( const Pathname & solvfile_r );
+
+	/** Build the index for \a solvfile_r.
+	 * \returns whether the index file was written.
+	 */
+	static bool build( const Pathname & solvfile_r );
+
+	/** \ref candidates of the index attached to \a repo_r. */
+	static bool candidates( CRepo * repo_r, const std::vector<std::string> & literals_r, std::vector<SolvableIdType> & result_r );
+
+      public:
+	struct Impl;
+      private:
+	RW_pointer<Impl> _pimpl;
+      };
+
+    } // namespace detail
+    ///////////////////////////////////////////////////////////////////
+  } // namespace sat
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_SAT_DETAIL_SEARCHINDEX_H
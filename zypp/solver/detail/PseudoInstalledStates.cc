@@ -0,0 +1,325 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/solver/detail/PseudoInstalledStates.cc
+ *
+*/
+extern "C"
+{
+#include <solv/pool.h>
+#include <solv/solvable.h>
+#include <solv/bitmap.h>
+}
+#include <algorithm>
+#include <iterator>
+
+#define ZYPP_USE_RESOLVER_INTERNALS
+
+#include <zypp/base/LogTools.h>
+#include <zypp/sat/Pool.h>
+#include <zypp/sat/Map.h>
+#include <zypp/sat/WhatProvides.h>
+#include <zypp/ResTraits.h>
+
+#include <zypp/solver/detail/PseudoInstalledStates.h>
+
+#undef ZYPP_BASE_LOGGER_LOGGROUP
+#define ZYPP_BASE_LOGGER_LOGGROUP "zypp::solver"
+
+using std::endl;
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace solver
+  {
+    ///////////////////////////////////////////////////////////////////
+    namespace detail
+    {
+      ///////////////////////////////////////////////////////////////////
+      namespace
+      {
+	constexpr signed char UNKNOWN = 2;
+
+	/** Collect the names \a id_r refers to.
+	 * \returns \c false if a change can't be tracked by name (namespaces, file dependencies).
+	 */
+	bool collectNames( sat::detail::CPool * pool_r, sat::detail::IdType id_r, std::vector<sat::detail::IdType> & names_r )
+	{
+	  while ( ISRELDEP(id_r) )
+	  {
+	    const ::Reldep * rd = GETRELDEP( pool_r, id_r );
+	    if ( rd->flags == REL_NAMESPACE )
+	      return false;
+	    // beyond REL_LT|REL_EQ|REL_GT the evr may be a dependency on its own (rich deps)
+	    if ( rd->flags > 7 && ! collectNames( pool_r, rd->evr, names_r ) )
+	      return false;
+	    id_r = rd->name;
+	  }
+	  if ( *::pool_id2str( pool_r, id_r ) == '/' )
+	    return false;
+	  names_r.push_back( id_r );
+	  return true;
+	}
+
+	/** Collect the names used in the \a deps_r. */
+	bool collectNames( sat::detail::CPool * pool_r, const Capabilities & deps_r, std::vector<sat::detail::IdType> & names_r )
+	{
+	  bool ret = true;
+	  for ( const Capability & cap : deps_r )
+	  {
+	    if ( ! collectNames( pool_r, cap.id(), names_r ) )
+	      ret = false;
+	  }
+	  return ret;
+	}
+
+	/** Whether \a id_r is in the sorted vector \a vec_r. */
+	inline bool contains( const std::vector<sat::detail::SolvableIdType> & vec_r, sat::detail::SolvableIdType id_r )
+	{ return std::binary_search( vec_r.begin(), vec_r.end(), id_r ); }
+
+      } // namespace
+      ///////////////////////////////////////////////////////////////////
+
+      void PseudoInstalledStates::clear()
+      {
+	_multiversion.clear();
+	_decided.clear();
+	_flags.clear();
+	_items.clear();
+	_byName.clear();
+	_volatile.clear();
+      }
+
+      void PseudoInstalledStates::indexItem( sat::detail::SolvableIdType item_r )
+      {
+	sat::detail::CPool * pool { sat::Pool::instance().get() };
+	sat::Solvable solv { item_r };
+
+	// The items state depends on the installed providers of its requires,
+	// conflicts and obsoletes, and on installed solvables conflicting with it.
+	std::vector<sat::detail::IdType> names;
+	bool trackable = collectNames( pool, solv.requires(), names );
+	trackable = collectNames( pool, solv.conflicts(), names ) && trackable;
+	trackable = collectNames( pool, solv.obsoletes(), names ) && trackable;
+	collectNames( pool, solv.provides(), names );
+	if ( ! trackable )
+	  _volatile.push_back( item_r );
+
+	std::sort( names.begin(), names.end() );
+	names.erase( std::unique( names.begin(), names.end() ), names.end() );
+	for ( sat::detail::IdType name : names )
+	  _byName[name].push_back( item_r );
+      }
+
+      void PseudoInstalledStates::buildIndex( const sat::Queue & pseudoItems_r )
+      {
+	_byName.clear();
+	_volatile.clear();
+	for ( sat::detail::IdType id : pseudoItems_r )
+	  indexItem( id );
+      }
+
+      void PseudoInstalledStates::update( const sat::Queue & pseudoItems_r, const sat::Queue & decisions_r, sat::Queue & pseudoFlags_r )
+      {
+	sat::Pool satpool { sat::Pool::instance() };
+	sat::detail::CPool * pool { satpool.get() };
+
+	if ( _serialIDs.remember( satpool.serialIDs() ) )
+	  clear();	// all solvable IDs are void
+
+	std::vector<sat::detail::SolvableIdType> multiversion;
+	for ( const sat::Solvable & solv : satpool.multiversion() )
+	  multiversion.push_back( solv.id() );
+	std::sort( multiversion.begin(), multiversion.end() );
+	if ( multiversion != _multiversion )
+	{
+	  clear();
+	  _multiversion.swap( multiversion );
+	}
+
+	std::vector<sat::detail::SolvableIdType> items( pseudoItems_r.begin(), pseudoItems_r.end() );
+	std::sort( items.begin(), items.end() );
+
+	// Solvables gone from the pool can't tell which items referred to them
+	// (the IDs are not reused, so _serialIDs did not change). Re-evaluate all then.
+	bool reevaluateAll = false;
+	for ( sat::detail::SolvableIdType id : _items )
+	{
+	  if ( ! contains( items, id ) )
+	  {
+	    reevaluateAll = true;
+	    break;
+	  }
+	}
+
+	_flags.resize( satpool.capacity(), UNKNOWN );
+	std::vector<sat::detail::SolvableIdType> added;	// new items may provide what others require
+	if ( reevaluateAll )
+	  buildIndex( pseudoItems_r );
+	else
+	{
+	  for ( sat::detail::SolvableIdType id : items )
+	  {
+	    if ( ! contains( _items, id ) )
+	    {
+	      indexItem( id );
+	      added.push_back( id );
+	      _flags[id] = UNKNOWN;
+	    }
+	  }
+	}
+	_items.swap( items );
+
+	// Items referring to a solvable whose decision changed need to be re-evaluated.
+	std::vector<sat::detail::SolvableIdType> decided;
+	for ( sat::detail::IdType id : decisions_r )
+	{
+	  if ( id > 0 )
+	    decided.push_back( id );
+	}
+	std::sort( decided.begin(), decided.end() );
+
+	std::vector<sat::detail::SolvableIdType> changed;
+	std::set_symmetric_difference( _decided.begin(), _decided.end(), decided.begin(), decided.end(), std::back_inserter( changed ) );
+	_decided.swap( decided );
+
+	if ( ! reevaluateAll && ! ( changed.empty() && added.empty() ) )
+	{
+	  std::vector<sat::detail::IdType> names;
+	  for ( sat::detail::SolvableIdType id : changed )
+	  {
+	    sat::Solvable solv { id };
+	    if ( ! solv )
+	    {
+	      reevaluateAll = true;	// gone from the pool
+	      break;
+	    }
+	    collectNames( pool, solv.provides(), names );
+	    collectNames( pool, solv.conflicts(), names );
+	    collectNames( pool, solv.obsoletes(), names );
+	  }
+	  for ( sat::detail::SolvableIdType id : added )
+	    collectNames( pool, sat::Solvable(id).provides(), names );
+
+	  if ( ! reevaluateAll )
+	  {
+	    // The state of an item may change the state of items requiring what it
+	    // provides. So whatever refers to the provides of an invalidated item is
+	    // invalidated as well.
+	    std::vector<sat::detail::SolvableIdType> invalid;
+	    auto invalidate = [&]( sat::detail::SolvableIdType id_r ) {
+	      if ( _flags[id_r] != UNKNOWN )
+	      {
+		_flags[id_r] = UNKNOWN;
+		invalid.push_back( id_r );
+	      }
+	    };
+	    for ( sat::detail::SolvableIdType id : added )
+	      invalid.push_back( id );
+	    for ( sat::detail::SolvableIdType id : _volatile )
+	      invalidate( id );
+	    do
+	    {
+	      for ( sat::detail::IdType name : names )
+	      {
+		auto it { _byName.find( name ) };
+		if ( it != _byName.end() )
+		{
+		  for ( sat::detail::SolvableIdType id : it->second )
+		    invalidate( id );
+		}
+	      }
+	      names.clear();
+	      for ( sat::detail::SolvableIdType id : invalid )
+		collectNames( pool, sat::Solvable(id).provides(), names );
+	      invalid.clear();
+	    } while ( ! names.empty() );
+	  }
+	}
+	if ( reevaluateAll )
+	{
+	  for ( sat::detail::SolvableIdType id : _items )
+	    _flags[id] = UNKNOWN;
+	}
+
+	// Evaluate what is unknown...
+	sat::Queue todo;
+	for ( sat::detail::IdType id : pseudoItems_r )
+	{
+	  if ( _flags[id] == UNKNOWN )
+	    todo.push( id );
+	}
+
+	if ( ! todo.empty() )
+	{
+	  // ...the way solver_trivial_installable does it. The result for an item
+	  // depends on the results for the items its dependencies match, if they are
+	  // evaluated along with it. So all items reachable that way are added to the
+	  // query (with their cached states still being valid).
+	  sat::Queue query;
+	  for ( sat::detail::IdType id : todo )
+	    query.push( id );
+	  if ( todo.size() < pseudoItems_r.size() )
+	  {
+	    std::vector<sat::detail::SolvableIdType> related;
+	    for ( sat::Queue::size_type i = 0; i < query.size(); ++i )
+	    {
+	      sat::Solvable solv { query[i] };
+	      for ( const Capabilities & deps : { solv.requires(), solv.conflicts(), solv.obsoletes() } )
+	      {
+		for ( const Capability & cap : deps )
+		{
+		  for ( const sat::Solvable & prv : sat::WhatProvides( cap ) )
+		  {
+		    sat::detail::SolvableIdType id { prv.id() };
+		    if ( _flags[id] != UNKNOWN && contains( _items, id ) && ! contains( related, id ) )
+		    {
+		      related.insert( std::upper_bound( related.begin(), related.end(), id ), id );
+		      query.push( id );
+		    }
+		  }
+		}
+	      }
+	    }
+	  }
+
+	  sat::Map installedmap( sat::Map::poolSize );
+	  for ( sat::detail::SolvableIdType id : _decided )
+	    installedmap.set( id );
+	  sat::Map multiversionmap( sat::Map::poolSize );
+	  for ( sat::detail::SolvableIdType id : _multiversion )
+	    multiversionmap.set( id );
+
+	  sat::Queue res;
+	  ::pool_trivial_installable_multiversionmap( pool, installedmap, query, res, _multiversion.empty() ? nullptr : (sat::detail::CMap*)multiversionmap );
+
+	  for ( sat::Queue::size_type i = 0; i < todo.size(); ++i )
+	  {
+	    signed char flag = res[i];
+	    if ( flag != -1 && sat::Solvable(todo[i]).isKind( ResKind::patch )
+	         && ::solvable_is_irrelevant_patch( pool->solvables + todo[i], installedmap ) )
+	      flag = -1;
+	    _flags[todo[i]] = flag;
+	  }
+	}
+	DBG << "Pseudo installed items evaluated: " << todo.size() << " of " << pseudoItems_r.size()
+	    << " (" << changed.size() << " decisions changed)" << endl;
+
+	pseudoFlags_r.clear();
+	for ( sat::detail::IdType id : pseudoItems_r )
+	  pseudoFlags_r.push( _flags[id] );
+      }
+
+    } // namespace detail
+    ///////////////////////////////////////////////////////////////////
+  } // namespace solver
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
@@ -0,0 +1,89 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/solver/detail/PseudoInstalledStates.h
+ *
+*/
+#ifndef ZYPP_SOLVER_DETAIL_PSEUDOINSTALLEDSTATES_H
+#define ZYPP_SOLVER_DETAIL_PSEUDOINSTALLEDSTATES_H
+#ifndef ZYPP_USE_RESOLVER_INTERNALS
+#error Do not directly include this file!
+#else
+
+#include <unordered_map>
+#include <vector>
+
+#include <zypp/base/NonCopyable.h>
+#include <zypp/base/SerialNumber.h>
+#include <zypp/sat/Queue.h>
+#include <zypp/sat/detail/PoolMember.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace solver
+  {
+    ///////////////////////////////////////////////////////////////////
+    namespace detail
+    {
+      ///////////////////////////////////////////////////////////////////
+      /// \class PseudoInstalledStates
+      /// \brief Cached established state of pseudo installed items (patches, patterns, products).
+      ///
+      /// Computing the state of all pseudo installed items via
+      /// \c solver_trivial_installable is expensive on pools with many patches.
+      /// The state of an item only depends on the set of solvables the solver
+      /// decided to keep or install. So the flags computed for each item are
+      /// remembered together with the names its dependencies refer to. After
+      /// the next solver run just the items referring to a solvable whose
+      /// decision changed (and the items new in the pool) are re-evaluated,
+      /// together with the items referring to what those provide. The items
+      /// their dependencies match are passed along to the evaluation, so the
+      /// result is the same as if all items were evaluated.
+      ///
+      /// All items are re-evaluated if a decided solvable or an item left the
+      /// pool. The cache is dropped if the pool reused solvable IDs or the
+      /// multiversion list changed.
+      ///////////////////////////////////////////////////////////////////
+      class PseudoInstalledStates : private base::NonCopyable
+      {
+      public:
+	/** Compute the flags for \a pseudoItems_r given the \a decisions_r of a solver run.
+	 * The flags in \a pseudoFlags_r are those \c solver_trivial_installable would
+	 * return: \c 1 satisfied, \c 0 broken, \c -1 not relevant.
+	 */
+	void update( const sat::Queue & pseudoItems_r, const sat::Queue & decisions_r, sat::Queue & pseudoFlags_r );
+
+	/** Forget all cached states. */
+	void clear();
+
+      private:
+	/** (Re)build \ref _byName for \a pseudoItems_r. */
+	void buildIndex( const sat::Queue & pseudoItems_r );
+	/** Remember the names used in the dependencies of \a item_r. */
+	void indexItem( sat::detail::SolvableIdType item_r );
+
+      private:
+	SerialNumberWatcher _serialIDs;		///< solvable IDs are valid as long as they are not reused
+	std::vector<sat::detail::SolvableIdType> _multiversion;	///< multiversion solvables the states were computed with (sorted)
+	std::vector<sat::detail::SolvableIdType> _decided;	///< solvables decided to be installed in the last run (sorted)
+	std::vector<signed char> _flags;	///< per solvable id, \c 2 if not (yet) computed
+	std::vector<sat::detail::SolvableIdType> _items;	///< the pseudo installed items of the last run
+	std::unordered_map<sat::detail::IdType,std::vector<sat::detail::SolvableIdType>> _byName;	///< name -> items referring to it
+	std::vector<sat::detail::SolvableIdType> _volatile;	///< items with deps not trackable by name (namespaces, files)
+      };
+
+    } // namespace detail
+    ///////////////////////////////////////////////////////////////////
+  } // namespace solver
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_USE_RESOLVER_INTERNALS
+#endif // ZYPP_SOLVER_DETAIL_PSEUDOINSTALLEDSTATES_H
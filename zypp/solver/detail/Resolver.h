@@ -223,6 +223,9 @@ class Resolver : private base::NonCopyable
 public:
     /** Expert backdoor. */
     sat::detail::CSolver * get() const;
+
+    /** Expert backdoor: the SATResolver (e.g. for its \ref SATResolver::phaseTimes). */
+    const SATResolver & satResolver() const { return *_satResolver; }
 };
 
 ///////////////////////////////////////////////////////////////////
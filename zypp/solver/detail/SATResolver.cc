@@ -73,6 +73,28 @@ namespace zypp
       ///////////////////////////////////////////////////////////////////////
       namespace
       {
+	/** Add the time until \ref stop (or destruction) to a \ref SATResolver::PhaseTimes entry. */
+	struct PhaseTimer
+	{
+	  PhaseTimer( SATResolver::PhaseTimes::Duration & duration_r )
+	  : _duration( &duration_r )
+	  , _start( std::chrono::steady_clock::now() )
+	  {}
+	  ~PhaseTimer()
+	  { stop(); }
+	  void stop()
+	  {
+	    if ( _duration )
+	    {
+	      *_duration += std::chrono::steady_clock::now() - _start;
+	      _duration = nullptr;
+	    }
+	  }
+	private:
+	  SATResolver::PhaseTimes::Duration * _duration;
+	  std::chrono::steady_clock::time_point _start;
+	};
+
 	inline void solverSetFocus( sat::detail::CSolver & satSolver_r, const ResolverFocus & focus_r )
 	{
 	  switch ( focus_r )
@@ -138,26 +160,35 @@ namespace zypp
 	  }
 	}
 
-	/** Copy back new \ref ValidateValue to \ref PoolItem after solving. */
-	inline void solverCopyBackValidate( sat::detail::CSolver & satSolver_r, const ResPool & pool_r )
+	/** Copy back \a pseudoFlags_r as \ref ValidateValue to the \a pseudoItems_r. */
+	inline void setValidate( const sat::Queue & pseudoItems_r, const sat::Queue & pseudoFlags_r )
+	{
+	  for ( sat::Queue::size_type i = 0; i < pseudoItems_r.size(); ++i )
+	  {
+	    PoolItem pi { sat::Solvable(pseudoItems_r[i]) };
+	    switch ( pseudoFlags_r[i] )
+	    {
+	      case 0:  pi.status().setBroken(); break;
+	      case 1:  pi.status().setSatisfied(); break;
+	      case -1: pi.status().setNonRelevant(); break;
+	      default: pi.status().setUndetermined(); break;
+	    }
+	  }
+	}
+
+	/** Copy back new \ref ValidateValue to \ref PoolItem after solving.
+	 * Only items affected by the solvers decisions are re-evaluated (\see PseudoInstalledStates).
+	 */
+	inline void solverCopyBackValidate( sat::detail::CSolver & satSolver_r, const ResPool & pool_r, PseudoInstalledStates & states_r )
 	{
 	  sat::Queue pseudoItems { collectPseudoInstalled( pool_r ) };
 	  if ( ! pseudoItems.empty() )
 	  {
+	    sat::Queue decisionq;
+	    ::solver_get_decisionqueue( &satSolver_r, decisionq );
 	    sat::Queue pseudoFlags;
-	    ::solver_trivial_installable( &satSolver_r, pseudoItems, pseudoFlags );
-
-	    for ( sat::Queue::size_type i = 0; i < pseudoItems.size(); ++i )
-	    {
-	      PoolItem pi { sat::Solvable(pseudoItems[i]) };
-	      switch ( pseudoFlags[i] )
-	      {
-		case 0:  pi.status().setBroken(); break;
-		case 1:  pi.status().setSatisfied(); break;
-		case -1: pi.status().setNonRelevant(); break;
-		default: pi.status().setUndetermined(); break;
-	      }
-	    }
+	    states_r.update( pseudoItems, decisionq, pseudoFlags );
+	    setValidate( pseudoItems, pseudoFlags );
 	  }
 	}
 
@@ -206,19 +237,13 @@ void establish( sat::Queue & pseudoItems_r, sat::Queue & pseudoFlags_r )
     if ( ::solver_solve( cSolver, jobQueue ) != 0 )
       INT << "How can establish fail?" << endl;
 
-    ::solver_trivial_installable( cSolver, pseudoItems_r, pseudoFlags_r );
-
-    for ( sat::Queue::size_type i = 0; i < pseudoItems_r.size(); ++i )
-    {
-      PoolItem pi { sat::Solvable(pseudoItems_r[i]) };
-      switch ( pseudoFlags_r[i] )
-      {
-	case 0:  pi.status().setBroken(); break;
-	case 1:  pi.status().setSatisfied(); break;
-	case -1: pi.status().setNonRelevant(); break;
-	default: pi.status().setUndetermined(); break;
-      }
-    }
+    // The states are kept across calls, so after a pool change just the
+    // items affected by the change need to be re-evaluated.
+    static PseudoInstalledStates establishedStates;
+    sat::Queue decisionq;
+    ::solver_get_decisionqueue( cSolver, decisionq );
+    establishedStates.update( pseudoItems_r, decisionq, pseudoFlags_r );
+    setValidate( pseudoItems_r, pseudoFlags_r );
     MIL << "Establish DONE" << endl;
   }
   else
@@ -362,70 +387,82 @@ SATSolutionToPool (PoolItem item, const ResStatus & status, const ResStatus::Tra
 // resolvePool
 //----------------------------------------------------------------------------
 //----------------------------------------------------------------------------
+void SATResolver::CollectedItems::clear()
+{
+  _kind.clear();
+  for ( auto & items : _items )
+    items.clear();
+}
+
 /////////////////////////////////////////////////////////////////////////
-/// \class SATCollectTransact
-/// \brief Commit helper functor distributing PoolItem by status into lists
+/// Distribute PoolItem by status into the _items_to_* lists.
 ///
 /// On the fly it clears all PoolItem bySolver/ByApplLow status.
-/// The lists are cleared in the Ctor, populated by \ref operator().
+///
+/// The lists of the last run are remembered in \ref _collected, so
+/// only items whose status changed since then are moved between the
+/// lists. This is just a compare per item, no list is rebuilt and
+/// no memory is allocated unless the user actually changed something.
 /////////////////////////////////////////////////////////////////////////
-struct SATCollectTransact : public resfilter::PoolItemFilterFunctor
+void SATResolver::collectPoolItems()
 {
-  SATCollectTransact( PoolItemList & items_to_install_r,
-		      PoolItemList & items_to_remove_r,
-		      PoolItemList & items_to_lock_r,
-		      PoolItemList & items_to_keep_r,
-		      bool solveSrcPackages_r )
-  : _items_to_install( items_to_install_r )
-  , _items_to_remove( items_to_remove_r )
-  , _items_to_lock( items_to_lock_r )
-  , _items_to_keep( items_to_keep_r )
-  , _solveSrcPackages( solveSrcPackages_r )
+  if ( _collected._solveSrcPackages != _solveSrcPackages )
   {
-    _items_to_install.clear();
-    _items_to_remove.clear();
-    _items_to_lock.clear();
-    _items_to_keep.clear();
+    _collected.clear();
+    _collected._solveSrcPackages = _solveSrcPackages;
   }
 
-  bool operator()( const PoolItem & item_r )
+  unsigned changes = 0;
+  for ( const PoolItem & item_r : _pool )
   {
-
     ResStatus & itemStatus( item_r.status() );
-    bool by_solver = ( itemStatus.isBySolver() || itemStatus.isByApplLow() );
+    CollectedItems::Kind kind = CollectedItems::NONE;
 
-    if ( by_solver )
+    if ( itemStatus.isBySolver() || itemStatus.isByApplLow() )
     {
       // Clear former solver/establish resultd
       itemStatus.resetTransact( ResStatus::APPL_LOW );
-      return true;	// -> back out here, don't re-queue former results
+      // -> don't re-queue former results
     }
-
-    if ( !_solveSrcPackages && item_r.isKind<SrcPackage>() )
+    else if ( _solveSrcPackages || ! item_r.isKind<SrcPackage>() )
     {
       // Later we may continue on a per source package base.
-      return true; // dont process this source package.
+      switch ( itemStatus.getTransactValue() )
+      {
+	case ResStatus::TRANSACT:
+	  kind = itemStatus.isUninstalled() ? CollectedItems::INSTALL : CollectedItems::REMOVE;	break;
+	case ResStatus::LOCKED:		kind = CollectedItems::LOCK;	break;
+	case ResStatus::KEEP_STATE:	kind = CollectedItems::KEEP;	break;
+      }
     }
 
-    switch ( itemStatus.getTransactValue() )
+    sat::detail::IdType id = item_r.id();
+    if ( (size_t)id >= _collected._kind.size() )
+      _collected._kind.resize( id+1, CollectedItems::NONE );
+
+    unsigned char & oldKind( _collected._kind[id] );
+    if ( oldKind != kind )
     {
-      case ResStatus::TRANSACT:
-	itemStatus.isUninstalled() ?	_items_to_install.push_back( item_r )
-	                           :	_items_to_remove.push_back( item_r );	break;
-      case ResStatus::LOCKED:		_items_to_lock.push_back( item_r );	break;
-      case ResStatus::KEEP_STATE:	_items_to_keep.push_back( item_r );	break;
+      if ( oldKind != CollectedItems::NONE )
+	_collected._items[oldKind].erase( id );
+      if ( kind != CollectedItems::NONE )
+	_collected._items[kind].emplace( id, item_r );
+      oldKind = kind;
+      ++changes;
     }
-    return true;
   }
-
-private:
-  PoolItemList & _items_to_install;
-  PoolItemList & _items_to_remove;
-  PoolItemList & _items_to_lock;
-  PoolItemList & _items_to_keep;
-  bool _solveSrcPackages;
-
-};
+  MIL << "Collected " << changes << " item status changes since the last run." << endl;
+
+  auto assign = []( PoolItemList & list_r, const std::map<sat::detail::IdType,PoolItem> & items_r ) {
+    list_r.clear();
+    for ( const auto & el : items_r )
+      list_r.push_back( el.second );
+  };
+  assign( _items_to_install, _collected._items[CollectedItems::INSTALL] );
+  assign( _items_to_remove,  _collected._items[CollectedItems::REMOVE] );
+  assign( _items_to_lock,    _collected._items[CollectedItems::LOCK] );
+  assign( _items_to_keep,    _collected._items[CollectedItems::KEEP] );
+}
 /////////////////////////////////////////////////////////////////////////
 
 
@@ -468,7 +505,6 @@ bool
 SATResolver::solving(const CapabilitySet & requires_caps,
 		     const CapabilitySet & conflict_caps)
 {
-    _satSolver = solver_create( _satPool );
     ::pool_set_custom_vendorcheck( _satPool, &vendorCheck );
     if (_fixsystem) {
 	queue_push( &(_jobQueue), SOLVER_VERIFY|SOLVER_SOLVABLE_ALL);
@@ -502,11 +538,15 @@ SATResolver::solving(const CapabilitySet & requires_caps,
     solver_set_flag(_satSolver, SOLVER_FLAG_DUP_ALLOW_ARCHCHANGE,	_dup_allowarchchange );
     solver_set_flag(_satSolver, SOLVER_FLAG_DUP_ALLOW_VENDORCHANGE,	_dup_allowvendorchange );
 
-    sat::Pool::instance().prepare();
+    {
+      PhaseTimer timer( _phaseTimes._prepare );
+      sat::Pool::instance().prepare();
+    }
 
     // Solve !
     MIL << "Starting solving...." << endl;
     MIL << *this;
+    PhaseTimer solveTimer( _phaseTimes._solve );
     if ( solver_solve( _satSolver, &(_jobQueue) ) == 0 )
     {
       // bsc#1155819: Weakremovers of future product not evaluated.
@@ -555,10 +595,12 @@ SATResolver::solving(const CapabilitySet & requires_caps,
 	}
       }
     }
+    solveTimer.stop();
     MIL << "....Solver end" << endl;
 
     // copying solution back to zypp pool
     //-----------------------------------------
+    PhaseTimer toPoolTimer( _phaseTimes._toPool );
     _result_items_to_install.clear();
     _result_items_to_remove.clear();
 
@@ -625,7 +667,7 @@ SATResolver::solving(const CapabilitySet & requires_caps,
     // copy back computed status values to pool
     // (on the fly cache orphaned items for the UI)
     solverCopyBackWeak( *_satSolver, _problem_items );
-    solverCopyBackValidate( *_satSolver, _pool );
+    solverCopyBackValidate( *_satSolver, _pool, _pseudoInstalledStates );
 
     // Solvables which were selected due requirements which have been made by the user will
     // be selected by APPL_LOW. We can't use any higher level, because this setting must
@@ -667,15 +709,30 @@ SATResolver::solverInit(const PoolItemList & weakItems)
 
     MIL << "SATResolver::solverInit()" << endl;
 
-    // remove old stuff
-    solverEnd();
-    queue_init( &_jobQueue );
+    // The solver and the collected items are reused unless the pool content
+    // changed (both serials must be remembered, so don't shortcut here).
+    bool poolChanged = _solverSerial.remember( sat::Pool::instance().serial() );
+    if ( _solverSerialIDs.remember( sat::Pool::instance().serialIDs() ) )
+      poolChanged = true;
 
-    // clear and rebuild: _items_to_install, _items_to_remove, _items_to_lock, _items_to_keep
+    _problemsValid.reset();	// problems refer to the former run
+    if ( poolChanged || ! _satSolver )
     {
-      SATCollectTransact collector( _items_to_install, _items_to_remove, _items_to_lock, _items_to_keep, solveSrcPackages() );
-      invokeOnEach ( _pool.begin(), _pool.end(), functor::functorRef<bool,PoolItem>( collector ) );
+      MIL << "Pool content changed: creating a new solver" << endl;
+      // remove old stuff
+      solverEnd();
+      queue_init( &_jobQueue );
+      _satSolver = solver_create( _satPool );
+      _collected.clear();
     }
+    else
+    {
+      MIL << "Reusing the solver" << endl;
+      queue_empty( &_jobQueue );
+    }
+
+    // update: _items_to_install, _items_to_remove, _items_to_lock, _items_to_keep
+    collectPoolItems();
 
     for (PoolItemList::const_iterator iter = weakItems.begin(); iter != weakItems.end(); iter++) {
 	Id id = (*iter)->satSolvable().id();
@@ -726,6 +783,7 @@ SATResolver::solverInit(const PoolItemList & weakItems)
 void
 SATResolver::solverEnd()
 {
+  _problemsValid.reset();	// problems refer to the solver
   // cleanup
   if ( _satSolver )
   {
@@ -743,6 +801,8 @@ SATResolver::resolvePool(const CapabilitySet & requires_caps,
                          const std::set<Repository> & upgradeRepos)
 {
     MIL << "SATResolver::resolvePool()" << endl;
+    _phaseTimes = PhaseTimes();
+    PhaseTimer initTimer( _phaseTimes._solverInit );
 
     // initialize
     solverInit(weakItems);
@@ -793,6 +853,7 @@ SATResolver::resolvePool(const CapabilitySet & requires_caps,
 
     // set locks for the solver
     setLocks();
+    initTimer.stop();
 
     // solving
     bool ret = solving(requires_caps, conflict_caps);
@@ -807,6 +868,8 @@ SATResolver::resolveQueue(const SolverQueueItemList &requestQueue,
 			  const PoolItemList & weakItems)
 {
     MIL << "SATResolver::resolvQueue()" << endl;
+    _phaseTimes = PhaseTimes();
+    PhaseTimer initTimer( _phaseTimes._solverInit );
 
     // initialize
     solverInit(weakItems);
@@ -839,6 +902,7 @@ SATResolver::resolveQueue(const SolverQueueItemList &requestQueue,
 
     // set locks for the solver
     setLocks();
+    initTimer.stop();
 
     // solving
     bool ret = solving();
@@ -851,6 +915,8 @@ SATResolver::resolveQueue(const SolverQueueItemList &requestQueue,
 void SATResolver::doUpdate()
 {
     MIL << "SATResolver::doUpdate()" << endl;
+    _phaseTimes = PhaseTimes();
+    PhaseTimer initTimer( _phaseTimes._solverInit );
 
     // initialize
     solverInit(PoolItemList());
@@ -861,7 +927,6 @@ void SATResolver::doUpdate()
     // set locks for the solver
     setLocks();
 
-    _satSolver = solver_create( _satPool );
     ::pool_set_custom_vendorcheck( _satPool, &vendorCheck );
     if (_fixsystem) {
 	queue_push( &(_jobQueue), SOLVER_VERIFY|SOLVER_SOLVABLE_ALL);
@@ -890,17 +955,30 @@ void SATResolver::doUpdate()
     solver_set_flag(_satSolver, SOLVER_FLAG_SPLITPROVIDES,		_dosplitprovides);
     solver_set_flag(_satSolver, SOLVER_FLAG_IGNORE_RECOMMENDED, 	false);		// resolve recommended namespaces
     solver_set_flag(_satSolver, SOLVER_FLAG_ONLY_NAMESPACE_RECOMMENDED,	_onlyRequires);	//
+    // the solver may be reused from a former run, so explicitly use the defaults of a fresh one here
+    solver_set_flag(_satSolver, SOLVER_FLAG_DUP_ALLOW_DOWNGRADE,	true );
+    solver_set_flag(_satSolver, SOLVER_FLAG_DUP_ALLOW_NAMECHANGE,	true );
+    solver_set_flag(_satSolver, SOLVER_FLAG_DUP_ALLOW_ARCHCHANGE,	true );
+    solver_set_flag(_satSolver, SOLVER_FLAG_DUP_ALLOW_VENDORCHANGE,	true );
+    initTimer.stop();
 
-    sat::Pool::instance().prepare();
+    {
+      PhaseTimer timer( _phaseTimes._prepare );
+      sat::Pool::instance().prepare();
+    }
 
     // Solve !
     MIL << "Starting solving for update...." << endl;
     MIL << *this;
-    solver_solve( _satSolver, &(_jobQueue) );
+    {
+      PhaseTimer timer( _phaseTimes._solve );
+      solver_solve( _satSolver, &(_jobQueue) );
+    }
     MIL << "....Solver end" << endl;
 
     // copying solution back to zypp pool
     //-----------------------------------------
+    PhaseTimer toPoolTimer( _phaseTimes._toPool );
 
     /*  solvables to be installed */
     Queue decisionq;
@@ -948,7 +1026,7 @@ void SATResolver::doUpdate()
     // copy back computed status values to pool
     // (on the fly cache orphaned items for the UI)
     solverCopyBackWeak( *_satSolver, _problem_items );
-    solverCopyBackValidate( *_satSolver, _pool );
+    solverCopyBackValidate( *_satSolver, _pool, _pseudoInstalledStates );
 
     MIL << "SATResolver::doUpdate() done" << endl;
 }
@@ -1181,312 +1259,330 @@ std::string SATResolver::SATproblemRuleInfoString (Id probr, std::string &detail
   return ret;
 }
 
-ResolverProblemList
-SATResolver::problems ()
+void SATResolver::SATfillProblem( ResolverProblem & resolverProblem, Id problem, unsigned pcnt )
 {
-    ResolverProblemList resolverProblems;
-    if (_satSolver && solver_problem_count(_satSolver)) {
 	sat::detail::CPool *pool = _satSolver->pool;
-	int pcnt;
 	Id p, rp, what;
-	Id problem, solution, element;
+	Id solution, element;
 	sat::Solvable s, sd;
 
 	CapabilitySet system_requires = SystemCheck::instance().requiredSystemCap();
 	CapabilitySet system_conflicts = SystemCheck::instance().conflictSystemCap();
 
-	MIL << "Encountered problems! Here are the solutions:\n" << endl;
-	pcnt = 1;
-	problem = 0;
-	while ((problem = solver_next_problem(_satSolver, problem)) != 0) {
-	    MIL << "Problem " <<  pcnt++ << ":" << endl;
-	    MIL << "====================================" << endl;
-	    std::string detail;
-	    Id ignoreId;
-	    std::string whatString = SATprobleminfoString (problem,detail,ignoreId);
-	    MIL << whatString << endl;
-	    MIL << "------------------------------------" << endl;
-            ResolverProblem_Ptr resolverProblem = new ResolverProblem (whatString, detail, SATgetCompleteProblemInfoStrings( problem ));
-
-	    solution = 0;
-	    while ((solution = solver_next_solution(_satSolver, problem, solution)) != 0) {
-		element = 0;
-		ProblemSolutionCombi *problemSolution = new ProblemSolutionCombi;
-		while ((element = solver_next_solutionelement(_satSolver, problem, solution, element, &p, &rp)) != 0) {
-		    if (p == SOLVER_SOLUTION_JOB) {
-			/* job, rp is index into job queue */
-			what = _jobQueue.elements[rp];
-			switch (_jobQueue.elements[rp-1]&(SOLVER_SELECTMASK|SOLVER_JOBMASK))
-			{
-			    case SOLVER_INSTALL | SOLVER_SOLVABLE: {
-				s = mapSolvable (what);
-				PoolItem poolItem = _pool.find (s);
-				if (poolItem) {
-				    if (pool->installed && s.get()->repo == pool->installed) {
-					problemSolution->addSingleAction (poolItem, REMOVE);
-					std::string description = str::form (_("remove lock to allow removal of %s"),  s.asString().c_str() );
-					MIL << description << endl;
-					problemSolution->addDescription (description);
-				    } else {
-					problemSolution->addSingleAction (poolItem, KEEP);
-					std::string description = str::form (_("do not install %s"), s.asString().c_str());
-					MIL << description << endl;
-					problemSolution->addDescription (description);
-				    }
+	MIL << "Problem " <<  pcnt << ":" << endl;
+	MIL << "====================================" << endl;
+	std::string detail;
+	Id ignoreId;
+	std::string whatString = SATprobleminfoString (problem,detail,ignoreId);
+	MIL << whatString << endl;
+	MIL << "------------------------------------" << endl;
+	resolverProblem.setDescription( whatString );
+	resolverProblem.setDetails( detail );
+	resolverProblem.setCompleteProblemInfo( SATgetCompleteProblemInfoStrings( problem ) );
+
+	solution = 0;
+	while ((solution = solver_next_solution(_satSolver, problem, solution)) != 0) {
+	    element = 0;
+	    ProblemSolutionCombi *problemSolution = new ProblemSolutionCombi;
+	    while ((element = solver_next_solutionelement(_satSolver, problem, solution, element, &p, &rp)) != 0) {
+		if (p == SOLVER_SOLUTION_JOB) {
+		    /* job, rp is index into job queue */
+		    what = _jobQueue.elements[rp];
+		    switch (_jobQueue.elements[rp-1]&(SOLVER_SELECTMASK|SOLVER_JOBMASK))
+		    {
+			case SOLVER_INSTALL | SOLVER_SOLVABLE: {
+			    s = mapSolvable (what);
+			    PoolItem poolItem = _pool.find (s);
+			    if (poolItem) {
+				if (pool->installed && s.get()->repo == pool->installed) {
+				    problemSolution->addSingleAction (poolItem, REMOVE);
+				    std::string description = str::form (_("remove lock to allow removal of %s"),  s.asString().c_str() );
+				    MIL << description << endl;
+				    problemSolution->addDescription (description);
 				} else {
-				    ERR << "SOLVER_INSTALL_SOLVABLE: No item found for " << s.asString() << endl;
+				    problemSolution->addSingleAction (poolItem, KEEP);
+				    std::string description = str::form (_("do not install %s"), s.asString().c_str());
+				    MIL << description << endl;
+				    problemSolution->addDescription (description);
 				}
+			    } else {
+				ERR << "SOLVER_INSTALL_SOLVABLE: No item found for " << s.asString() << endl;
 			    }
-				break;
-			    case SOLVER_ERASE | SOLVER_SOLVABLE: {
-				s = mapSolvable (what);
-				PoolItem poolItem = _pool.find (s);
-				if (poolItem) {
-				    if (pool->installed && s.get()->repo == pool->installed) {
-					problemSolution->addSingleAction (poolItem, KEEP);
-					std::string description = str::form (_("keep %s"), s.asString().c_str());
-					MIL << description << endl;
-					problemSolution->addDescription (description);
-				    } else {
-					problemSolution->addSingleAction (poolItem, UNLOCK);
-					std::string description = str::form (_("remove lock to allow installation of %s"), itemToString( poolItem ).c_str());
-					MIL << description << endl;
-					problemSolution->addDescription (description);
-				    }
+			}
+			    break;
+			case SOLVER_ERASE | SOLVER_SOLVABLE: {
+			    s = mapSolvable (what);
+			    PoolItem poolItem = _pool.find (s);
+			    if (poolItem) {
+				if (pool->installed && s.get()->repo == pool->installed) {
+				    problemSolution->addSingleAction (poolItem, KEEP);
+				    std::string description = str::form (_("keep %s"), s.asString().c_str());
+				    MIL << description << endl;
+				    problemSolution->addDescription (description);
 				} else {
-				    ERR << "SOLVER_ERASE_SOLVABLE: No item found for " << s.asString() << endl;
+				    problemSolution->addSingleAction (poolItem, UNLOCK);
+				    std::string description = str::form (_("remove lock to allow installation of %s"), itemToString( poolItem ).c_str());
+				    MIL << description << endl;
+				    problemSolution->addDescription (description);
 				}
+			    } else {
+				ERR << "SOLVER_ERASE_SOLVABLE: No item found for " << s.asString() << endl;
 			    }
-				break;
-			    case SOLVER_INSTALL | SOLVER_SOLVABLE_NAME:
-				{
-				IdString ident( what );
-				SolverQueueItemInstall_Ptr install =
-				    new SolverQueueItemInstall(_pool, ident.asString(), false );
-				problemSolution->addSingleAction (install, REMOVE_SOLVE_QUEUE_ITEM);
-
-				std::string description = str::form (_("do not install %s"), ident.c_str() );
-				MIL << description << endl;
-				problemSolution->addDescription (description);
-				}
-				break;
-			    case SOLVER_ERASE | SOLVER_SOLVABLE_NAME:
-				{
-				// As we do not know, if this request has come from resolvePool or
-				// resolveQueue we will have to take care for both cases.
-                                IdString ident( what );
-				FindPackage info (problemSolution, KEEP);
-				invokeOnEach( _pool.byIdentBegin( ident ),
-					      _pool.byIdentEnd( ident ),
-					      functor::chain (resfilter::ByInstalled (),			// ByInstalled
-							      resfilter::ByTransact ()),			// will be deinstalled
-					      functor::functorRef<bool,PoolItem> (info) );
-
-				SolverQueueItemDelete_Ptr del =
-				    new SolverQueueItemDelete(_pool, ident.asString(), false );
-				problemSolution->addSingleAction (del, REMOVE_SOLVE_QUEUE_ITEM);
-
-				std::string description = str::form (_("keep %s"), ident.c_str());
-				MIL << description << endl;
-				problemSolution->addDescription (description);
-				}
-				break;
-			    case SOLVER_INSTALL | SOLVER_SOLVABLE_PROVIDES:
-				{
-				problemSolution->addSingleAction (Capability(what), REMOVE_EXTRA_REQUIRE);
-				std::string description = "";
-
-				// Checking if this problem solution would break your system
-				if (system_requires.find(Capability(what)) != system_requires.end()) {
-				    // Show a better warning
-				    resolverProblem->setDetails( resolverProblem->description() + "\n" + resolverProblem->details() );
-				    resolverProblem->setDescription(_("This request will break your system!"));
-				    description = _("ignore the warning of a broken system");
-				    description += std::string(" (requires:")+pool_dep2str(pool, what)+")";
-                                    MIL << description << endl;
-                                    problemSolution->addFrontDescription (description);
-				} else {
-				    description = str::form (_("do not ask to install a solvable providing %s"), pool_dep2str(pool, what));
-                                    MIL << description << endl;
-                                    problemSolution->addDescription (description);
-				}
-				}
-				break;
-			    case SOLVER_ERASE | SOLVER_SOLVABLE_PROVIDES:
-				{
-				problemSolution->addSingleAction (Capability(what), REMOVE_EXTRA_CONFLICT);
-				std::string description = "";
-
-				// Checking if this problem solution would break your system
-				if (system_conflicts.find(Capability(what)) != system_conflicts.end()) {
-				    // Show a better warning
-				    resolverProblem->setDetails( resolverProblem->description() + "\n" + resolverProblem->details() );
-				    resolverProblem->setDescription(_("This request will break your system!"));
-				    description = _("ignore the warning of a broken system");
-				    description += std::string(" (conflicts:")+pool_dep2str(pool, what)+")";
-                                    MIL << description << endl;
-                                    problemSolution->addFrontDescription (description);
-
-				} else {
-				    description = str::form (_("do not ask to delete all solvables providing %s"), pool_dep2str(pool, what));
-                                    MIL << description << endl;
-                                    problemSolution->addDescription (description);
-				}
-				}
-				break;
-			    case SOLVER_UPDATE | SOLVER_SOLVABLE:
-				{
-				s = mapSolvable (what);
-				PoolItem poolItem = _pool.find (s);
-				if (poolItem) {
-				    if (pool->installed && s.get()->repo == pool->installed) {
-					problemSolution->addSingleAction (poolItem, KEEP);
-					std::string description = str::form (_("do not install most recent version of %s"), s.asString().c_str());
-					MIL << description << endl;
-					problemSolution->addDescription (description);
-				    } else {
-					ERR << "SOLVER_INSTALL_SOLVABLE_UPDATE " << poolItem << " is not selected for installation" << endl;
-				    }
-				} else {
-				    ERR << "SOLVER_INSTALL_SOLVABLE_UPDATE: No item found for " << s.asString() << endl;
-				}
-				}
-				break;
-			    default:
-				MIL << "- do something different" << endl;
-				ERR << "No valid solution available" << endl;
-				break;
 			}
-		    } else if (p == SOLVER_SOLUTION_INFARCH) {
-			s = mapSolvable (rp);
-			PoolItem poolItem = _pool.find (s);
-			if (pool->installed && s.get()->repo == pool->installed) {
-			    problemSolution->addSingleAction (poolItem, LOCK);
-			    std::string description = str::form (_("keep %s despite the inferior architecture"), s.asString().c_str());
-			    MIL << description << endl;
-			    problemSolution->addDescription (description);
-			} else {
-			    problemSolution->addSingleAction (poolItem, INSTALL);
-			    std::string description = str::form (_("install %s despite the inferior architecture"), s.asString().c_str());
+			    break;
+			case SOLVER_INSTALL | SOLVER_SOLVABLE_NAME:
+			    {
+			    IdString ident( what );
+			    SolverQueueItemInstall_Ptr install =
+				new SolverQueueItemInstall(_pool, ident.asString(), false );
+			    problemSolution->addSingleAction (install, REMOVE_SOLVE_QUEUE_ITEM);
+
+			    std::string description = str::form (_("do not install %s"), ident.c_str() );
 			    MIL << description << endl;
 			    problemSolution->addDescription (description);
-			}
-		    } else if (p == SOLVER_SOLUTION_DISTUPGRADE) {
-			s = mapSolvable (rp);
-			PoolItem poolItem = _pool.find (s);
-			if (pool->installed && s.get()->repo == pool->installed) {
-			    problemSolution->addSingleAction (poolItem, LOCK);
-			    std::string description = str::form (_("keep obsolete %s"), s.asString().c_str());
-			    MIL << description << endl;
-			    problemSolution->addDescription (description);
-			} else {
-			    problemSolution->addSingleAction (poolItem, INSTALL);
-			    std::string description = str::form (_("install %s from excluded repository"), s.asString().c_str());
+			    }
+			    break;
+			case SOLVER_ERASE | SOLVER_SOLVABLE_NAME:
+			    {
+			    // As we do not know, if this request has come from resolvePool or
+			    // resolveQueue we will have to take care for both cases.
+			    IdString ident( what );
+			    FindPackage info (problemSolution, KEEP);
+			    invokeOnEach( _pool.byIdentBegin( ident ),
+					  _pool.byIdentEnd( ident ),
+					  functor::chain (resfilter::ByInstalled (),			// ByInstalled
+							  resfilter::ByTransact ()),			// will be deinstalled
+					  functor::functorRef<bool,PoolItem> (info) );
+
+			    SolverQueueItemDelete_Ptr del =
+				new SolverQueueItemDelete(_pool, ident.asString(), false );
+			    problemSolution->addSingleAction (del, REMOVE_SOLVE_QUEUE_ITEM);
+
+			    std::string description = str::form (_("keep %s"), ident.c_str());
 			    MIL << description << endl;
 			    problemSolution->addDescription (description);
-			}
-		    } else if ( p == SOLVER_SOLUTION_BLACK ) {
-			// Allow to install a blacklisted package (PTF, retracted,...).
-			// For not-installed items only
-			s = mapSolvable (rp);
-			PoolItem poolItem = _pool.find (s);
+			    }
+			    break;
+			case SOLVER_INSTALL | SOLVER_SOLVABLE_PROVIDES:
+			    {
+			    problemSolution->addSingleAction (Capability(what), REMOVE_EXTRA_REQUIRE);
+			    std::string description = "";
+
+			    // Checking if this problem solution would break your system
+			    if (system_requires.find(Capability(what)) != system_requires.end()) {
+				// Show a better warning
+				resolverProblem.setDetails( resolverProblem.description() + "\n" + resolverProblem.details() );
+				resolverProblem.setDescription(_("This request will break your system!"));
+				description = _("ignore the warning of a broken system");
+				description += std::string(" (requires:")+pool_dep2str(pool, what)+")";
+				MIL << description << endl;
+				problemSolution->addFrontDescription (description);
+			    } else {
+				description = str::form (_("do not ask to install a solvable providing %s"), pool_dep2str(pool, what));
+				MIL << description << endl;
+				problemSolution->addDescription (description);
+			    }
+			    }
+			    break;
+			case SOLVER_ERASE | SOLVER_SOLVABLE_PROVIDES:
+			    {
+			    problemSolution->addSingleAction (Capability(what), REMOVE_EXTRA_CONFLICT);
+			    std::string description = "";
+
+			    // Checking if this problem solution would break your system
+			    if (system_conflicts.find(Capability(what)) != system_conflicts.end()) {
+				// Show a better warning
+				resolverProblem.setDetails( resolverProblem.description() + "\n" + resolverProblem.details() );
+				resolverProblem.setDescription(_("This request will break your system!"));
+				description = _("ignore the warning of a broken system");
+				description += std::string(" (conflicts:")+pool_dep2str(pool, what)+")";
+				MIL << description << endl;
+				problemSolution->addFrontDescription (description);
 
-			problemSolution->addSingleAction (poolItem, INSTALL);
-			std::string description;
-			if ( s.isRetracted() ) {
-			  // translator: %1% is a package name
-			  description = str::Format(_("install %1% although it has been retracted")) % s.asString();
-			} else if ( s.isPtf() ) {
-			  // translator: %1% is a package name
-			  description = str::Format(_("allow to install the PTF %1%")) % s.asString();
-			} else {
-			  // translator: %1% is a package name
-			  description = str::Format(_("install %1% although it is blacklisted")) % s.asString();
-			}
-			MIL << description << endl;
-			problemSolution->addDescription( description );
-		    } else if ( p > 0 ) {
-			/* policy, replace p with rp */
-			s = mapSolvable (p);
-			PoolItem itemFrom = _pool.find (s);
-			if (rp)
-			{
-			    int gotone = 0;
-
-			    sd = mapSolvable (rp);
-			    PoolItem itemTo = _pool.find (sd);
-			    if (itemFrom && itemTo) {
-				problemSolution->addSingleAction (itemTo, INSTALL);
-				int illegal = policy_is_illegal(_satSolver, s.get(), sd.get(), 0);
-
-				if ((illegal & POLICY_ILLEGAL_DOWNGRADE) != 0)
-				{
-				    std::string description = str::form (_("downgrade of %s to %s"), s.asString().c_str(), sd.asString().c_str());
-				    MIL << description << endl;
-				    problemSolution->addDescription (description);
-				    gotone = 1;
-				}
-				if ((illegal & POLICY_ILLEGAL_ARCHCHANGE) != 0)
-				{
-				    std::string description = str::form (_("architecture change of %s to %s"), s.asString().c_str(), sd.asString().c_str());
-				    MIL << description << endl;
-				    problemSolution->addDescription (description);
-				    gotone = 1;
-				}
-				if ((illegal & POLICY_ILLEGAL_VENDORCHANGE) != 0)
-				{
-                                    IdString s_vendor( s.vendor() );
-                                    IdString sd_vendor( sd.vendor() );
-				    std::string description = str::form (_("install %s (with vendor change)\n  %s  -->  %s") ,
-								    sd.asString().c_str(),
-                                                                    ( s_vendor ? s_vendor.c_str() : " (no vendor) " ),
-                                                                    ( sd_vendor ? sd_vendor.c_str() : " (no vendor) " ) );
-				    MIL << description << endl;
-				    problemSolution->addDescription (description);
-				    gotone = 1;
-				}
-				if (!gotone) {
-				    std::string description = str::form (_("replacement of %s with %s"), s.asString().c_str(), sd.asString().c_str());
+			    } else {
+				description = str::form (_("do not ask to delete all solvables providing %s"), pool_dep2str(pool, what));
+				MIL << description << endl;
+				problemSolution->addDescription (description);
+			    }
+			    }
+			    break;
+			case SOLVER_UPDATE | SOLVER_SOLVABLE:
+			    {
+			    s = mapSolvable (what);
+			    PoolItem poolItem = _pool.find (s);
+			    if (poolItem) {
+				if (pool->installed && s.get()->repo == pool->installed) {
+				    problemSolution->addSingleAction (poolItem, KEEP);
+				    std::string description = str::form (_("do not install most recent version of %s"), s.asString().c_str());
 				    MIL << description << endl;
 				    problemSolution->addDescription (description);
+				} else {
+				    ERR << "SOLVER_INSTALL_SOLVABLE_UPDATE " << poolItem << " is not selected for installation" << endl;
 				}
 			    } else {
-				ERR << s.asString() << " or "  << sd.asString() << " not found" << endl;
+				ERR << "SOLVER_INSTALL_SOLVABLE_UPDATE: No item found for " << s.asString() << endl;
 			    }
-			}
-			else
-			{
-			    if (itemFrom) {
-				std::string description = str::form (_("deinstallation of %s"), s.asString().c_str());
+			    }
+			    break;
+			default:
+			    MIL << "- do something different" << endl;
+			    ERR << "No valid solution available" << endl;
+			    break;
+		    }
+		} else if (p == SOLVER_SOLUTION_INFARCH) {
+		    s = mapSolvable (rp);
+		    PoolItem poolItem = _pool.find (s);
+		    if (pool->installed && s.get()->repo == pool->installed) {
+			problemSolution->addSingleAction (poolItem, LOCK);
+			std::string description = str::form (_("keep %s despite the inferior architecture"), s.asString().c_str());
+			MIL << description << endl;
+			problemSolution->addDescription (description);
+		    } else {
+			problemSolution->addSingleAction (poolItem, INSTALL);
+			std::string description = str::form (_("install %s despite the inferior architecture"), s.asString().c_str());
+			MIL << description << endl;
+			problemSolution->addDescription (description);
+		    }
+		} else if (p == SOLVER_SOLUTION_DISTUPGRADE) {
+		    s = mapSolvable (rp);
+		    PoolItem poolItem = _pool.find (s);
+		    if (pool->installed && s.get()->repo == pool->installed) {
+			problemSolution->addSingleAction (poolItem, LOCK);
+			std::string description = str::form (_("keep obsolete %s"), s.asString().c_str());
+			MIL << description << endl;
+			problemSolution->addDescription (description);
+		    } else {
+			problemSolution->addSingleAction (poolItem, INSTALL);
+			std::string description = str::form (_("install %s from excluded repository"), s.asString().c_str());
+			MIL << description << endl;
+			problemSolution->addDescription (description);
+		    }
+		} else if ( p == SOLVER_SOLUTION_BLACK ) {
+		    // Allow to install a blacklisted package (PTF, retracted,...).
+		    // For not-installed items only
+		    s = mapSolvable (rp);
+		    PoolItem poolItem = _pool.find (s);
+
+		    problemSolution->addSingleAction (poolItem, INSTALL);
+		    std::string description;
+		    if ( s.isRetracted() ) {
+		      // translator: %1% is a package name
+		      description = str::Format(_("install %1% although it has been retracted")) % s.asString();
+		    } else if ( s.isPtf() ) {
+		      // translator: %1% is a package name
+		      description = str::Format(_("allow to install the PTF %1%")) % s.asString();
+		    } else {
+		      // translator: %1% is a package name
+		      description = str::Format(_("install %1% although it is blacklisted")) % s.asString();
+		    }
+		    MIL << description << endl;
+		    problemSolution->addDescription( description );
+		} else if ( p > 0 ) {
+		    /* policy, replace p with rp */
+		    s = mapSolvable (p);
+		    PoolItem itemFrom = _pool.find (s);
+		    if (rp)
+		    {
+			int gotone = 0;
+
+			sd = mapSolvable (rp);
+			PoolItem itemTo = _pool.find (sd);
+			if (itemFrom && itemTo) {
+			    problemSolution->addSingleAction (itemTo, INSTALL);
+			    int illegal = policy_is_illegal(_satSolver, s.get(), sd.get(), 0);
+
+			    if ((illegal & POLICY_ILLEGAL_DOWNGRADE) != 0)
+			    {
+				std::string description = str::form (_("downgrade of %s to %s"), s.asString().c_str(), sd.asString().c_str());
 				MIL << description << endl;
 				problemSolution->addDescription (description);
-				problemSolution->addSingleAction (itemFrom, REMOVE);
+				gotone = 1;
 			    }
+			    if ((illegal & POLICY_ILLEGAL_ARCHCHANGE) != 0)
+			    {
+				std::string description = str::form (_("architecture change of %s to %s"), s.asString().c_str(), sd.asString().c_str());
+				MIL << description << endl;
+				problemSolution->addDescription (description);
+				gotone = 1;
+			    }
+			    if ((illegal & POLICY_ILLEGAL_VENDORCHANGE) != 0)
+			    {
+				IdString s_vendor( s.vendor() );
+				IdString sd_vendor( sd.vendor() );
+				std::string description = str::form (_("install %s (with vendor change)\n  %s  -->  %s") ,
+								sd.asString().c_str(),
+								( s_vendor ? s_vendor.c_str() : " (no vendor) " ),
+								( sd_vendor ? sd_vendor.c_str() : " (no vendor) " ) );
+				MIL << description << endl;
+				problemSolution->addDescription (description);
+				gotone = 1;
+			    }
+			    if (!gotone) {
+				std::string description = str::form (_("replacement of %s with %s"), s.asString().c_str(), sd.asString().c_str());
+				MIL << description << endl;
+				problemSolution->addDescription (description);
+			    }
+			} else {
+			    ERR << s.asString() << " or "  << sd.asString() << " not found" << endl;
 			}
 		    }
 		    else
 		    {
-		      INT << "Unknown solution " << p << endl;
+			if (itemFrom) {
+			    std::string description = str::form (_("deinstallation of %s"), s.asString().c_str());
+			    MIL << description << endl;
+			    problemSolution->addDescription (description);
+			    problemSolution->addSingleAction (itemFrom, REMOVE);
+			}
 		    }
-
 		}
-		resolverProblem->addSolution (problemSolution,
-					      problemSolution->actionCount() > 1 ? true : false); // Solutions with more than 1 action will be shown first.
-		MIL << "------------------------------------" << endl;
-	    }
+		else
+		{
+		  INT << "Unknown solution " << p << endl;
+		}
 
-	    if (ignoreId > 0) {
-		// There is a possibility to ignore this error by setting weak dependencies
-		PoolItem item = _pool.find (sat::Solvable(ignoreId));
-		ProblemSolutionIgnore *problemSolution = new ProblemSolutionIgnore(item);
-		resolverProblem->addSolution (problemSolution,
-					      false); // Solutions will be shown at the end
-		MIL << "ignore some dependencies of " << item << endl;
-		MIL << "------------------------------------" << endl;
 	    }
+	    resolverProblem.addSolution (problemSolution,
+					  problemSolution->actionCount() > 1 ? true : false); // Solutions with more than 1 action will be shown first.
+	    MIL << "------------------------------------" << endl;
+	}
+
+	if (ignoreId > 0) {
+	    // There is a possibility to ignore this error by setting weak dependencies
+	    PoolItem item = _pool.find (sat::Solvable(ignoreId));
+	    ProblemSolutionIgnore *problemSolution = new ProblemSolutionIgnore(item);
+	    resolverProblem.addSolution (problemSolution,
+					  false); // Solutions will be shown at the end
+	    MIL << "ignore some dependencies of " << item << endl;
+	    MIL << "------------------------------------" << endl;
+	}
+}
 
-	    // save problem
-	    resolverProblems.push_back (resolverProblem);
+ResolverProblemList
+SATResolver::problems ()
+{
+    ResolverProblemList resolverProblems;
+    if (_satSolver && solver_problem_count(_satSolver)) {
+	// Computing the solutions is expensive (libsolv refines each problem by solving
+	// again), so a problem is filled in when it is first looked at. The problems refer
+	// to the current solver state and are void once the solver is initialized again.
+	if ( ! _problemsValid )
+	    _problemsValid = std::make_shared<bool>( true );
+	std::weak_ptr<void> valid( _problemsValid );
+
+	MIL << "Encountered " << solver_problem_count(_satSolver) << " problems! Solutions are computed on demand." << endl;
+	unsigned pcnt = 1;
+	Id problem = 0;
+	while ((problem = solver_next_problem(_satSolver, problem)) != 0) {
+	    resolverProblems.push_back( new ResolverProblem( [this,valid,problem,pcnt]( ResolverProblem & resolverProblem_r ) {
+		if ( valid.expired() ) {
+		    WAR << "Problem " << pcnt << " refers to an outdated solver run" << endl;
+		    resolverProblem_r.setDescription( _("The solver was run again, problem information is no longer available.") );
+		    return;
+		}
+		SATfillProblem( resolverProblem_r, problem, pcnt );
+	    } ) );
+	    ++pcnt;
 	}
     }
     return resolverProblems;
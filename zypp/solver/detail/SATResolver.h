@@ -31,11 +31,17 @@ extern "C"
 }
 
 #include <iosfwd>
+#include <chrono>
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
+
+#include <zypp/base/SerialNumber.h>
 
 #include <zypp/solver/Types.h>
+#include <zypp/solver/detail/PseudoInstalledStates.h>
 
 /////////////////////////////////////////////////////////////////////////
 namespace zypp
@@ -80,6 +86,26 @@ class SATResolver : public base::ReferenceCounted, private base::NonCopyable, pr
     PoolItemList _items_to_lock;
     PoolItemList _items_to_keep;
 
+    // The libsolv solver and the items collected from the pool are kept across
+    // resolves as long as the pool content does not change (\see solverInit).
+    struct CollectedItems
+    {
+      enum Kind { NONE = 0, INSTALL, REMOVE, LOCK, KEEP, KINDS };
+      std::vector<unsigned char> _kind;				// per solvable id: the list an item was collected into
+      std::map<sat::detail::IdType,PoolItem> _items[KINDS];	// ordered by id, so lists are in pool order
+      bool _solveSrcPackages = false;
+      void clear();
+    };
+    CollectedItems _collected;
+    SerialNumberWatcher _solverSerial;
+    SerialNumberWatcher _solverSerialIDs;
+
+    // Lazily computed problems check this is still alive (\see problems)
+    std::shared_ptr<void> _problemsValid;
+
+    // States of patches etc. are re-evaluated only if affected by the solver decisions
+    PseudoInstalledStates _pseudoInstalledStates;
+
     // solve results
     PoolItemList _result_items_to_install;
     PoolItemList _result_items_to_remove;
@@ -111,10 +137,13 @@ class SATResolver : public base::ReferenceCounted, private base::NonCopyable, pr
     std::string SATprobleminfoString (Id problem, std::string &detail, Id &ignoreId);
     std::string SATproblemRuleInfoString (Id rule, std::string &detail, Id &ignoreId);
     std::vector<std::string> SATgetCompleteProblemInfoStrings ( Id problem );
+    void SATfillProblem ( ResolverProblem & resolverProblem, Id problem, unsigned pcnt );
     void resetItemTransaction (PoolItem item);
 
     // Create a SAT solver and reset solver selection in the pool (Collecting
     void solverInit(const PoolItemList & weakItems);
+    // Update _items_to_* from the ResStatus changes since the last run
+    void collectPoolItems();
     // common solver run with the _jobQueue; Save results back to pool
     bool solving(const CapabilitySet & requires_caps = CapabilitySet(),
 		 const CapabilitySet & conflict_caps = CapabilitySet());
@@ -134,6 +163,20 @@ class SATResolver : public base::ReferenceCounted, private base::NonCopyable, pr
     sat::Solvable mapSolvable (const Id &id);
     PoolItem mapItem (const PoolItem &item);
 
+  public:
+    /** Wall clock time spent in the phases of the last solver run (e.g. for benchmarking). */
+    struct PhaseTimes
+    {
+      typedef std::chrono::steady_clock::duration Duration;
+      Duration _solverInit = Duration::zero();	///< setting up the solver and the job queue
+      Duration _prepare = Duration::zero();	///< sat::Pool::prepare (whatprovides)
+      Duration _solve = Duration::zero();	///< solver_solve
+      Duration _toPool = Duration::zero();	///< copying the solution back to the pool
+    };
+
+  private:
+    PhaseTimes _phaseTimes;
+
   public:
 
     SATResolver (const ResPool & pool, sat::detail::CPool *satPool);
@@ -215,6 +258,8 @@ class SATResolver : public base::ReferenceCounted, private base::NonCopyable, pr
     sat::StringQueue autoInstalled() const;
     sat::StringQueue userInstalled() const;
 
+    const PhaseTimes & phaseTimes() const { return _phaseTimes; }
+
 public:
   /** Expert backdoor. */
   sat::detail::CSolver * get() const { return _satSolver; }
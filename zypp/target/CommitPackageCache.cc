@@ -10,6 +10,10 @@
  *
 */
 #include <iostream>
+#include <fstream>
+#include <deque>
+#include <future>
+#include <thread>
 #include <zypp/base/Logger.h>
 #include <zypp/base/Exception.h>
 
@@ -23,6 +27,8 @@ using std::endl;
 #include <zypp/repo/PackageProvider.h>
 #include <zypp/repo/DeltaCandidates.h>
 #include <zypp/ResPool.h>
+#include <zypp/PathInfo.h>
+#include <zypp/Digest.h>
 
 ///////////////////////////////////////////////////////////////////
 namespace zypp
@@ -66,6 +72,7 @@ namespace zypp
     {
       repo::RepoMediaAccess _access;
       std::list<Repository> _repos;
+      repo::DeltaCandidates _deltas;	///< indexed once, shared by all packages
       repo::PackageProviderPolicy _packageProviderPolicy;
     };
 
@@ -74,6 +81,7 @@ namespace zypp
     {
        const ResPool & pool( ResPool::instance() );
       _impl->_repos.insert( _impl->_repos.begin(), pool.knownRepositoriesBegin(), pool.knownRepositoriesEnd() );
+      _impl->_deltas = repo::DeltaCandidates( _impl->_repos );
       _impl->_packageProviderPolicy.queryInstalledCB( QueryInstalledEditionHelper() );
     }
 
@@ -90,8 +98,7 @@ namespace zypp
       }
       else if ( pi_r.isKind<Package>() )	// may make use of deltas
       {
-	repo::DeltaCandidates deltas( _impl->_repos, pi_r.name() );
-	repo::PackageProvider pkgProvider( _impl->_access, pi_r, deltas, _impl->_packageProviderPolicy );
+	repo::PackageProvider pkgProvider( _impl->_access, pi_r, _impl->_deltas, _impl->_packageProviderPolicy );
 	return pkgProvider.providePackage();
       }
       else	// SrcPackage or throws
@@ -102,6 +109,103 @@ namespace zypp
       return ret;
     }
 
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	class RepoPreloadPackages
+    //
+    ///////////////////////////////////////////////////////////////////
+
+    struct RepoPreloadPackages::Impl
+    {
+      /** A fetched package waiting for verification. */
+      struct Pending
+      {
+	PoolItem _pi;
+	std::unique_ptr<repo::PackageProvider> _provider;
+	ManagedFile _file;
+	std::future<std::string> _digest;	///< computed by a worker thread
+	bool _wasCached = false;		///< in cache before, so it's not unchecked
+      };
+
+      Impl( const RepoProvidePackage & provider_r )
+      : _window( std::min( std::max( std::thread::hardware_concurrency(), 1U ), 4U ) )
+      , _provider( provider_r )
+      {}
+
+      ~Impl()
+      {
+	for ( Pending & pending : _pending )
+	{
+	  if ( pending._digest.valid() )
+	    pending._digest.wait();
+	  if ( pending._wasCached )
+	    pending._file.resetDispose();
+	  else
+	    pending._file.setDispose( filesystem::unlink );	// never leave unchecked files in the cache
+	}
+      }
+
+      /** Digest of a file not yet verified.
+       * Not via \ref filesystem::checksum, which would remember it for the file.
+       */
+      static std::string digest( const Pathname & file_r, const std::string & type_r )
+      {
+	std::ifstream file( file_r.c_str() );
+	return file ? Digest::digest( type_r, file, 1024*1024 ) : std::string();
+      }
+
+      unsigned _window;
+      RepoProvidePackage _provider;	///< shares the media access with the CommitPackageCache
+      std::deque<Pending> _pending;
+    };
+
+    RepoPreloadPackages::RepoPreloadPackages( const RepoProvidePackage & provider_r )
+      : _impl( new Impl( provider_r ) )
+    {}
+
+    RepoPreloadPackages::~RepoPreloadPackages()
+    {}
+
+    unsigned RepoPreloadPackages::window() const
+    { return _impl->_window; }
+
+    unsigned RepoPreloadPackages::pending() const
+    { return _impl->_pending.size(); }
+
+    void RepoPreloadPackages::fetch( const PoolItem & pi_r )
+    {
+      RepoProvidePackage::Impl & provider { *_impl->_provider._impl };
+      Impl::Pending pending;
+      pending._pi = pi_r;
+      if ( pi_r.isKind<Package>() )	// may make use of deltas
+	pending._provider.reset( new repo::PackageProvider( provider._access, pi_r, provider._deltas, provider._packageProviderPolicy ) );
+      else	// SrcPackage or throws
+	pending._provider.reset( new repo::PackageProvider( provider._access, pi_r, provider._packageProviderPolicy ) );
+
+      pending._wasCached = pending._provider->isCached();
+      pending._file = pending._provider->fetchPackage();
+
+      const std::string & type { pi_r.lookupLocation().checksum().type() };
+      if ( ! pending._wasCached && ! type.empty() )
+	pending._digest = std::async( std::launch::async, &Impl::digest, Pathname( pending._file ), type );
+      _impl->_pending.push_back( std::move(pending) );
+    }
+
+    ManagedFile RepoPreloadPackages::verifyNext()
+    {
+      if ( _impl->_pending.empty() )
+	ZYPP_THROW( Exception( "No package pending for verification." ) );
+
+      Impl::Pending pending { std::move(_impl->_pending.front()) };
+      _impl->_pending.pop_front();
+
+      std::string digest;
+      if ( pending._digest.valid() )
+	digest = pending._digest.get();
+      DBG << "verify " << pending._pi << " (" << _impl->_pending.size() << " pending)" << endl;
+      return pending._provider->verifyPackage( pending._file, digest );
+    }
+
     ///////////////////////////////////////////////////////////////////
     //
     //	CLASS NAME : CommitPackageCache
@@ -142,6 +246,9 @@ namespace zypp
     ManagedFile CommitPackageCache::get( const PoolItem & citem_r )
     { return _pimpl->get( citem_r ); }
 
+    bool CommitPackageCache::preloadable( const PoolItem & citem_r ) const
+    { return _pimpl->preloadable( citem_r ); }
+
     bool CommitPackageCache::preloaded() const
     { return _pimpl->preloaded(); }
 
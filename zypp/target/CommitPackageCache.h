@@ -37,6 +37,7 @@ namespace zypp
     ///////////////////////////////////////////////////////////////////
     class RepoProvidePackage
     {
+      friend class RepoPreloadPackages;
     public:
       RepoProvidePackage();
       ~RepoProvidePackage();
@@ -49,6 +50,56 @@ namespace zypp
       RW_pointer<Impl> _impl;
     };
 
+    ///////////////////////////////////////////////////////////////////
+    /// \class RepoPreloadPackages
+    /// \short Preload packages into the cache, checking them while the next ones download.
+    ///
+    /// \ref fetch downloads a package and starts computing its digest in a
+    /// worker thread. \ref verifyNext checks the oldest fetched package
+    /// using that digest. The packages are verified (and reported) in the
+    /// order they were fetched. At most \ref window packages should be
+    /// pending, bounding the number of worker threads. Packages built from
+    /// a deltarpm are rebuilt by background processes the same way.
+    ///
+    /// \note The rpm signature check stays on the calling thread, as rpm's
+    /// logging and locale handling is process global.
+    ///
+    /// Pending packages not verified when the preloader is destroyed are
+    /// removed from the cache.
+    ///
+    /// Packages are provided using the media access of the \ref RepoProvidePackage
+    /// passed to the ctor, which should be the one used by the \ref CommitPackageCache.
+    /// Packages not \ref CommitPackageCache::preloadable must be provided via
+    /// \ref CommitPackageCache::get.
+    ///////////////////////////////////////////////////////////////////
+    class RepoPreloadPackages
+    {
+    public:
+      explicit RepoPreloadPackages( const RepoProvidePackage & provider_r );
+      ~RepoPreloadPackages();
+
+      /** Max. number of packages which should be pending. */
+      unsigned window() const;
+
+      /** Number of fetched packages not yet verified. */
+      unsigned pending() const;
+
+      /** Download a package.
+       * \throws Exception like \ref repo::PackageProvider::providePackage.
+       */
+      void fetch( const PoolItem & pi_r );
+
+      /** Verify the oldest pending package.
+       * The package is no longer pending, even if an exception is thrown.
+       * \throws Exception like \ref repo::PackageProvider::providePackage.
+       */
+      ManagedFile verifyNext();
+
+    private:
+      struct Impl;
+      RW_pointer<Impl> _impl;
+    };
+
     ///////////////////////////////////////////////////////////////////
     //
     //	CLASS NAME : CommitPackageCache
@@ -88,6 +139,12 @@ namespace zypp
       ManagedFile get( sat::Solvable citem_r )
       { return get( PoolItem(citem_r) ); }
 
+      /** Whether \a citem_r may be preloaded by a \ref RepoPreloadPackages.
+       * Otherwise it must be provided via \ref get, which e.g. handles the
+       * changes of interactive media (CD/DVD).
+       */
+      bool preloadable( const PoolItem & citem_r ) const;
+
       /** Whether preloaded hint is set.
        * If preloaded the cache tries to avoid trigering the infoInCache CB,
        * based on the assumption this was already done when preloading the cache.
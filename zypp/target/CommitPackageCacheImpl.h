@@ -58,6 +58,12 @@ namespace zypp
         return sourceProvidePackage( citem_r );
       }
 
+      /** Whether the package may be preloaded bypassing \ref get.
+       * Derived classes overload this.
+      */
+      virtual bool preloadable( const PoolItem & citem_r ) const
+      { return true; }
+
       void setCommitList( std::vector<sat::Solvable> commitList_r )
       { _commitList = commitList_r; }
 
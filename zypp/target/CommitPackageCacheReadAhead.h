@@ -89,6 +89,10 @@ namespace zypp
       /** Provide the package. Either from Source or from cache. */
       virtual ManagedFile get( const PoolItem & citem_r );
 
+      /** Packages on CD/DVD must be provided via \ref get. */
+      virtual bool preloadable( const PoolItem & citem_r ) const
+      { return ! onInteractiveMedia( citem_r ); }
+
     private:
       /** Return whether \a pi is located on a CD/DVD */
       bool onInteractiveMedia( const PoolItem & pi ) const;
@@ -15,6 +15,7 @@
 #include <string>
 #include <list>
 #include <set>
+#include <deque>
 
 #include <sys/types.h>
 #include <dirent.h>
@@ -1328,7 +1329,8 @@ namespace zypp
       if ( ! policy_r.dryRun() || policy_r.downloadMode() == DownloadOnly )
       {
 	// Prepare the package cache. Pass all items requiring download.
-        CommitPackageCache packageCache;
+        RepoProvidePackage repoProvidePackage;
+        CommitPackageCache packageCache( repoProvidePackage );
 	packageCache.setCommitList( steps.begin(), steps.end() );
 
         bool miss = false;
@@ -1337,6 +1339,57 @@ namespace zypp
           // Preload the cache. Until now this means pre-loading all packages.
           // Once DownloadInHeaps is fully implemented, this will change and
           // we may actually have more than one heap.
+          //
+          // While a package downloads, the ones before are checked in the
+          // background. They are verified in commit order, so the reports
+          // stay in sequence.
+          RepoPreloadPackages preloader( repoProvidePackage );
+          std::deque<sat::Transaction::Step *> pending;	// fetched but not yet verified
+
+          auto preloadStep = [&miss]( sat::Transaction::Step & step_r, const std::function<void()> & action_r )->bool
+          {
+            PoolItem pi( step_r );
+            try
+            {
+              action_r();
+              return true;
+            }
+            catch ( const AbortRequestException & exp )
+            {
+              step_r.stepStage( sat::Transaction::STEP_ERROR );
+              miss = true;
+              WAR << "commit cache preload aborted by the user" << endl;
+              ZYPP_THROW( TargetAbortedException( ) );
+            }
+            catch ( const SkipRequestException & exp )
+            {
+              ZYPP_CAUGHT( exp );
+              step_r.stepStage( sat::Transaction::STEP_ERROR );
+              miss = true;
+              WAR << "Skipping cache preload package " << pi->asKind<Package>() << " in commit" << endl;
+            }
+            catch ( const Exception & exp )
+            {
+              // bnc #395704: missing catch causes abort.
+              // TODO see if packageCache fails to handle errors correctly.
+              ZYPP_CAUGHT( exp );
+              step_r.stepStage( sat::Transaction::STEP_ERROR );
+              miss = true;
+              INT << "Unexpected Error: Skipping cache preload package " << pi->asKind<Package>() << " in commit" << endl;
+            }
+            return false;
+          };
+
+          auto verifyNext = [&]()
+          {
+            sat::Transaction::Step & step( *pending.front() );
+            pending.pop_front();
+            preloadStep( step, [&]() {
+              ManagedFile localfile( preloader.verifyNext() );
+              localfile.resetDispose(); // keep the package file in the cache
+            } );
+          };
+
           for_( it, steps.begin(), steps.end() )
           {
 	    switch ( it->stepType() )
@@ -1355,40 +1408,26 @@ namespace zypp
 	    PoolItem pi( *it );
             if ( pi->isKind<Package>() || pi->isKind<SrcPackage>() )
             {
-              ManagedFile localfile;
-              try
+              if ( packageCache.preloadable( pi ) )
               {
-		localfile = packageCache.get( pi );
-                localfile.resetDispose(); // keep the package file in the cache
+                if ( preloader.pending() >= preloader.window() )
+                  verifyNext();
+                if ( preloadStep( *it, [&]() { preloader.fetch( pi ); } ) )
+                  pending.push_back( &*it );
               }
-              catch ( const AbortRequestException & exp )
-              {
-		it->stepStage( sat::Transaction::STEP_ERROR );
-                miss = true;
-                WAR << "commit cache preload aborted by the user" << endl;
-                ZYPP_THROW( TargetAbortedException( ) );
-                break;
-              }
-              catch ( const SkipRequestException & exp )
-              {
-                ZYPP_CAUGHT( exp );
-		it->stepStage( sat::Transaction::STEP_ERROR );
-                miss = true;
-                WAR << "Skipping cache preload package " << pi->asKind<Package>() << " in commit" << endl;
-                continue;
-              }
-              catch ( const Exception & exp )
+              else
               {
-                // bnc #395704: missing catch causes abort.
-                // TODO see if packageCache fails to handle errors correctly.
-                ZYPP_CAUGHT( exp );
-		it->stepStage( sat::Transaction::STEP_ERROR );
-                miss = true;
-                INT << "Unexpected Error: Skipping cache preload package " << pi->asKind<Package>() << " in commit" << endl;
-                continue;
+                while ( ! pending.empty() )
+                  verifyNext();
+                preloadStep( *it, [&]() {
+                  ManagedFile localfile( packageCache.get( pi ) );
+                  localfile.resetDispose(); // keep the package file in the cache
+                } );
               }
             }
           }
+          while ( ! pending.empty() )
+            verifyNext();
           packageCache.preloaded( true ); // try to avoid duplicate infoInCache CBs in commit
         }
 
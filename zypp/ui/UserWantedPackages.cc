@@ -146,7 +146,7 @@ namespace zypp
                 if ( patch && (*patch_it)->toModify() )
 		{
 		    DBG << "Patch will be transacted: \"" << patch->name()
-			<< "\" - \"" << patch->summary() << "\"" << endl;
+			<< "\" - \"" << patch->summaryView() << "\"" << endl;
 
                     Patch::Contents contents( patch->contents() );
                     for_( it, contents.begin(), contents.end() )
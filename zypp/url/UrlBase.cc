@@ -16,6 +16,9 @@
 
 #include <stdexcept>
 #include <climits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <errno.h>
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -141,6 +144,225 @@ namespace zypp
     namespace // anonymous
     {
 
+      // -------------------------------------------------------------
+      /*
+      ** Hand written scanners for the fixed RX_VALID_* expressions.
+      ** They are used for every component set, so we avoid compiling
+      ** a regex each time. Non-ASCII hostnames are still passed to
+      ** RX_VALID_HOSTNAME, as [:alnum:] depends on the locale.
+      */
+      inline bool isAsciiAlpha(char c)
+      { return ( c >= 'a' && c <= 'z' ) || ( c >= 'A' && c <= 'Z' ); }
+
+      inline bool isAsciiDigit(char c)
+      { return c >= '0' && c <= '9'; }
+
+      inline bool isAsciiHex(char c)
+      { return isAsciiDigit(c) || ( c >= 'a' && c <= 'f' ) || ( c >= 'A' && c <= 'F' ); }
+
+      inline bool isHostnameChar(char c)
+      { return isAsciiAlpha(c) || isAsciiDigit(c) || c == '$' || c == '{' || c == '_' || c == '}'; }
+
+      // RX_VALID_SCHEME (a literal '\\' is part of the POSIX bracket)
+      bool scanScheme(const std::string &s)
+      {
+        if( s.empty() || !isAsciiAlpha(s[0]))
+          return false;
+        for( std::string::size_type i = 1; i < s.size(); ++i)
+        {
+          char c = s[i];
+          if( !( isAsciiAlpha(c) || isAsciiDigit(c) ||
+                 c == '\\' || c == '.' || c == '+' || c == '-'))
+            return false;
+        }
+        return true;
+      }
+
+      // RX_VALID_PORT
+      bool scanPort(const std::string &s)
+      {
+        if( s.empty() || s.size() > 5)
+          return false;
+        for( char c : s)
+        {
+          if( !isAsciiDigit(c))
+            return false;
+        }
+        return true;
+      }
+
+      // RX_VALID_HOSTNAME for ASCII input ('\\' is a separator, like in the regex)
+      bool scanHostname(const std::string &s)
+      {
+        bool label = false;	// inside a label
+        for( char c : s)
+        {
+          if( isHostnameChar(c))
+            label = true;
+          else if( label && ( c == '.' || c == '-' || c == '\\'))
+            label = false;
+          else
+            return false;
+        }
+        return label;
+      }
+
+      // a [0-9]{1,3}(\\.[0-9]{1,3}){3} IPv4 suffix of RX_VALID_HOSTIPV6
+      bool scanIPv4Suffix(const std::string &s, std::string::size_type pos)
+      {
+        for( unsigned part = 0; part < 4; ++part)
+        {
+          if( part && ( pos >= s.size() || s[pos++] != '.'))
+            return false;
+          unsigned digits = 0;
+          while( pos < s.size() && isAsciiDigit(s[pos]))
+          {
+            ++pos;
+            ++digits;
+          }
+          if( digits < 1 || digits > 3)
+            return false;
+        }
+        return pos == s.size();
+      }
+
+      // RX_VALID_HOSTIPV6
+      bool scanIPv6(const std::string &s)
+      {
+        if( s.size() < 3 || s[0] != '[' || s[s.size()-1] != ']')
+          return false;
+
+        std::string addr( s.substr(1, s.size()-2));
+        std::string::size_type end = addr.size();
+        if( addr.find('.') != std::string::npos)
+        {
+          end = addr.rfind(':');
+          if( end == std::string::npos || end == 0 || !scanIPv4Suffix(addr, end+1))
+            return false;
+        }
+        for( std::string::size_type i = 0; i < end; ++i)
+        {
+          if( addr[i] != ':' && !isAsciiHex(addr[i]))
+            return false;
+        }
+        return true;
+      }
+
+      // -------------------------------------------------------------
+      /**
+       * \brief Validator for the rx_* configuration expressions.
+       *
+       * The expressions are configured per scheme, so there are only a
+       * few distinct ones. A compiled validator is cached per expression.
+       * The common <tt>^([CHARSET]|%[a-fA-F0-9]{2})+$</tt> form is turned
+       * into a character table, anything else is matched by a regex
+       * which is compiled only once.
+       */
+      class ComponentValidator
+      {
+      public:
+        explicit ComponentValidator(const std::string &regx)
+        {
+          if( !parseCharset(regx))
+          {
+            try
+            {
+              _regex.reset( new str::regex(regx));
+            }
+            catch( ... )
+            {}
+          }
+        }
+
+        bool matches(const std::string &data) const
+        {
+          if( _regex)
+            return str::regex_match(data, *_regex);
+          if( !_table)
+            return false;	// invalid expression
+
+          if( data.empty())
+            return false;
+          for( std::string::size_type i = 0; i < data.size(); ++i)
+          {
+            if( data[i] == '%')
+            {
+              if( i+2 < data.size() && isAsciiHex(data[i+1]) && isAsciiHex(data[i+2]))
+              {
+                i += 2;
+                continue;
+              }
+              return false;
+            }
+            if( !_chars[(unsigned char)data[i]])
+              return false;
+          }
+          return true;
+        }
+
+        static std::shared_ptr<const ComponentValidator> get(const std::string &regx)
+        {
+          static std::mutex mutex;
+          static std::map<std::string, std::shared_ptr<const ComponentValidator>> cache;
+
+          std::lock_guard<std::mutex> guard( mutex);
+          auto & validator( cache[regx]);
+          if( !validator)
+            validator.reset( new ComponentValidator(regx));
+          return validator;
+        }
+
+      private:
+        /** Parse <tt>^([CHARSET]|%[a-fA-F0-9]{2})+$</tt> into \ref _chars. */
+        bool parseCharset(const std::string &regx)
+        {
+          static const std::string prefix( "^([");
+          static const std::string suffix( "]|%[a-fA-F0-9]{2})+$");
+
+          if( regx.size() <= prefix.size() + suffix.size() ||
+              regx.compare(0, prefix.size(), prefix) != 0 ||
+              regx.compare(regx.size()-suffix.size(), suffix.size(), suffix) != 0)
+            return false;
+
+          std::string set( regx.substr(prefix.size(), regx.size()-prefix.size()-suffix.size()));
+          // leave negation, classes, equivalence classes and collating
+          // elements (and sets containing ']') to the regex engine.
+          if( set[0] == '^' || set.find('[') != std::string::npos || set.find(']') != std::string::npos)
+            return false;
+
+          for( std::string::size_type i = 0; i < set.size(); ++i)
+          {
+            char c = set[i];
+            if( i+2 < set.size() && set[i+1] == '-')
+            {
+              char e = set[i+2];
+              // ranges are locale dependent, accept only the obvious ones
+              bool plain = ( isAsciiDigit(c) && isAsciiDigit(e)) ||
+                           ( c >= 'a' && c <= 'z' && e >= 'a' && e <= 'z') ||
+                           ( c >= 'A' && c <= 'Z' && e >= 'A' && e <= 'Z');
+              if( !plain || c > e)
+                return false;
+              for( char r = c; r <= e; ++r)
+                _chars[(unsigned char)r] = true;
+              i += 2;
+            }
+            else if( (unsigned char)c < 0x80)
+              _chars[(unsigned char)c] = true;
+            else
+              return false;
+          }
+          // '%' must not be ambiguous with the escape alternative
+          if( _chars[(unsigned char)'%'])
+            return false;
+          _table = true;
+          return true;
+        }
+
+        bool _table = false;
+        bool _chars[256] = { false };
+        std::shared_ptr<str::regex> _regex;
+      };
+
 			// -------------------------------------------------------------
       inline void
       checkUrlData(const std::string &data,
@@ -159,8 +381,7 @@ namespace zypp
           bool valid = false;
           try
           {
-            str::regex rex(regx);
-            valid = str::regex_match(data, rex);
+            valid = ComponentValidator::get(regx)->matches(data);
           }
           catch( ... )
           {}
@@ -373,16 +594,7 @@ namespace zypp
     bool
     UrlBase::isValidScheme(const std::string &scheme) const
     {
-      bool valid = false;
-      try
-      {
-        str::regex rex(RX_VALID_SCHEME);
-        valid = str::regex_match(scheme, rex);
-      }
-      catch( ... )
-      {}
-
-      if(valid)
+      if( scanScheme(scheme))
       {
         std::string    lscheme( str::toLower(scheme));
         UrlSchemes     schemes( getKnownSchemes());
@@ -1326,8 +1538,7 @@ namespace zypp
     {
       try
       {
-        str::regex regx(RX_VALID_HOSTIPV6);
-        if( str::regex_match(host, regx))
+        if( scanIPv6(host))
         {
           struct in6_addr ip;
           std::string temp( host.substr(1, host.size()-2));
@@ -1338,8 +1549,15 @@ namespace zypp
         {
           // matches also IPv4 dotted-decimal adresses...
           std::string temp( zypp::url::decode(host));
-          str::regex  regx(RX_VALID_HOSTNAME);
-          return str::regex_match(temp, regx);
+          for( char c : temp)
+          {
+            if( (unsigned char)c >= 0x80)
+            {
+              str::regex  regx(RX_VALID_HOSTNAME);
+              return str::regex_match(temp, regx);
+            }
+          }
+          return scanHostname(temp);
         }
       }
       catch( ... )
@@ -1353,17 +1571,11 @@ namespace zypp
     bool
     UrlBase::isValidPort(const std::string &port) const
     {
-      try
+      if( scanPort(port))
       {
-        str::regex regx(RX_VALID_PORT);
-        if( str::regex_match(port, regx))
-        {
-          long pnum = str::strtonum<long>(port);
-          return ( pnum >= 1 && pnum <= USHRT_MAX);
-        }
+        long pnum = str::strtonum<long>(port);
+        return ( pnum >= 1 && pnum <= USHRT_MAX);
       }
-      catch( ... )
-      {}
       return false;
     }
 
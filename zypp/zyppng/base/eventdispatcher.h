@@ -45,6 +45,11 @@ class EventDispatcherPrivate;
  * uses the glib eventloop, just like Qt and GTK, so integrating libzypp here is just a matter of passing the default main context
  * to the constructor of \a EventDispatcher.
  *
+ * Applications that do not need to integrate with a GLib based main loop can use the native
+ * epoll/timerfd backend instead, which avoids rebuilding GLib's poll array on every iteration.
+ * The backend is selected when the dispatcher is created, either explicitely by passing a \a Backend
+ * or by setting the \c ZYPP_EVENTDISPATCHER environment variable to \c epoll or \c glib.
+ *
  */
 class LIBZYPP_NG_EXPORT EventDispatcher : public Base
 {
@@ -58,6 +63,15 @@ public:
   using WeakPtr = std::shared_ptr<EventDispatcher>;
   using IdleFunction = std::function<bool ()>;
 
+  /*!
+   * The available event loop implementations
+   */
+  enum Backend {
+    DefaultBackend, //< Use the backend requested in \c ZYPP_EVENTDISPATCHER, \a GLibBackend if unset
+    GLibBackend,    //< GMainContext based, integrates with Qt or GTK applications
+    EpollBackend    //< Native epoll/timerfd implementation
+  };
+
   /*!
    * Creates a new EventDispatcher, use this function to create a Dispatcher
    * running on the default thread
@@ -77,6 +91,22 @@ public:
    */
   static std::shared_ptr<EventDispatcher> createForThread ( );
 
+  /*!
+   * \overload Creates a new EventDispatcher for the main thread using the given \a backend
+   * \note the \a EpollBackend does not attach to a running GLib main loop
+   */
+  static std::shared_ptr<EventDispatcher> createMain ( Backend backend );
+
+  /*!
+   * \overload Creates a new EventDispatcher for the current thread using the given \a backend
+   */
+  static std::shared_ptr<EventDispatcher> createForThread ( Backend backend );
+
+  /*!
+   * Returns the backend actually used by this EventDispatcher, never \a DefaultBackend
+   */
+  Backend backend () const;
+
   virtual ~EventDispatcher();
 
   /*!
@@ -139,6 +169,12 @@ protected:
    */
   EventDispatcher( void *ctx = nullptr );
 
+  /*!
+   * Create a new instance of the EventDispatcher using the given \a backend,
+   * \a ctx is only used by the \a GLibBackend
+   */
+  EventDispatcher( Backend backend, void *ctx );
+
   /*!
    * \see unrefLater
    */
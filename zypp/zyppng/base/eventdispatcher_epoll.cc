@@ -0,0 +1,286 @@
+#include "eventdispatcher.h"
+#include "timer.h"
+#include "private/eventdispatcher_glib_p.h"
+#include "private/eventdispatcher_epoll_p.h"
+
+#include <zypp/base/Exception.h>
+#include <zypp/base/Logger.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+namespace zyppng {
+
+static uint32_t inline epollMask ( int mode ) {
+  uint32_t ev = 0;
+  if ( mode & AbstractEventSource::Read )
+    ev |= EPOLLIN;
+  if ( mode & AbstractEventSource::Write )
+    ev |= EPOLLOUT;
+  if ( mode & AbstractEventSource::Exception )
+    ev |= EPOLLPRI;
+  return ev;
+}
+
+EpollEventDispatcher::EpollEventDispatcher( EventDispatcherPrivate &d )
+  : _d( d )
+{
+  _epollFd  = ::epoll_create1( EPOLL_CLOEXEC );
+  _timerFd  = ::timerfd_create( CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC );
+  _wakeupFd = ::eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+
+  if ( !isValid() ) {
+    ERR << "Unable to initialize the epoll event dispatcher: " << strerror( errno ) << std::endl;
+    return;
+  }
+
+  for ( int fd : { _timerFd, _wakeupFd } ) {
+    epoll_event ev {};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    if ( ::epoll_ctl( _epollFd, EPOLL_CTL_ADD, fd, &ev ) != 0 ) {
+      ERR << "Unable to watch internal fd " << fd << ": " << strerror( errno ) << std::endl;
+      ::close( _epollFd );
+      _epollFd = -1;
+      return;
+    }
+  }
+}
+
+EpollEventDispatcher::~EpollEventDispatcher()
+{
+  for ( int fd : { _epollFd, _timerFd, _wakeupFd } ) {
+    if ( fd >= 0 )
+      ::close( fd );
+  }
+}
+
+bool EpollEventDispatcher::isValid() const
+{
+  return ( _epollFd >= 0 && _timerFd >= 0 && _wakeupFd >= 0 );
+}
+
+void EpollEventDispatcher::updateEventSource( AbstractEventSource *notifier, int fd, int mode )
+{
+  FdEntry &entry = _fds[fd];
+  auto it = std::find_if( entry.watches.begin(), entry.watches.end(), [ notifier ]( const Watch &w ){ return w.src == notifier; } );
+  if ( it != entry.watches.end() )
+    it->mode = mode;
+  else
+    entry.watches.push_back( Watch{ notifier, mode } );
+
+  syncFd( fd, entry );
+}
+
+void EpollEventDispatcher::removeEventSource( AbstractEventSource *notifier, int fd )
+{
+  for ( auto it = _fds.begin(); it != _fds.end(); ) {
+    if ( fd != -1 && it->first != fd ) {
+      ++it;
+      continue;
+    }
+
+    auto &watches = it->second.watches;
+    watches.erase( std::remove_if( watches.begin(), watches.end(), [ notifier ]( const Watch &w ){ return w.src == notifier; } ), watches.end() );
+
+    if ( watches.empty() ) {
+      // the fd might be closed already, the kernel cleaned up for us in that case
+      ::epoll_ctl( _epollFd, EPOLL_CTL_DEL, it->first, nullptr );
+      it = _fds.erase( it );
+    } else {
+      syncFd( it->first, it->second );
+      ++it;
+    }
+  }
+}
+
+/*!
+ * Registers the union of all watch modes for \a fd in the epoll set
+ */
+void EpollEventDispatcher::syncFd( int fd, FdEntry &entry )
+{
+  uint32_t events = 0;
+  for ( const Watch &w : entry.watches )
+    events |= epollMask( w.mode );
+
+  epoll_event ev {};
+  ev.events = events;
+  ev.data.fd = fd;
+
+  // a fd number might have been reused after it was closed without removing the watch,
+  // so do not trust our bookkeeping and let the kernel tell us what it knows about the fd
+  int op = entry.events ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+  int res = ::epoll_ctl( _epollFd, op, fd, &ev );
+  if ( res != 0 && errno == ENOENT )
+    res = ::epoll_ctl( _epollFd, EPOLL_CTL_ADD, fd, &ev );
+  else if ( res != 0 && errno == EEXIST )
+    res = ::epoll_ctl( _epollFd, EPOLL_CTL_MOD, fd, &ev );
+
+  if ( res != 0 ) {
+    ERR << "Unable to update the watch for fd " << fd << ": " << strerror( errno ) << std::endl;
+    entry.events = 0;
+    return;
+  }
+  // never store 0 for a registered fd, otherwise the next update would try EPOLL_CTL_ADD again
+  entry.events = events | EPOLLERR;
+}
+
+void EpollEventDispatcher::registerTimer( Timer *timer )
+{
+  //make sure timer is not double registered
+  if ( std::find( _timers.begin(), _timers.end(), timer ) != _timers.end() )
+    return;
+  _timers.push_back( timer );
+}
+
+void EpollEventDispatcher::removeTimer( Timer *timer )
+{
+  auto it = std::find( _timers.begin(), _timers.end(), timer );
+  if ( it != _timers.end() )
+    _timers.erase( it );
+}
+
+ulong EpollEventDispatcher::runningTimers() const
+{
+  return _timers.size();
+}
+
+/*!
+ * Arms the timerfd to fire when the earliest registered Timer expires,
+ * Timer::now() and the timerfd both use CLOCK_MONOTONIC.
+ */
+void EpollEventDispatcher::armTimerFd()
+{
+  itimerspec spec {};
+  if ( !_timers.empty() ) {
+    uint64_t next = std::numeric_limits<uint64_t>::max();
+    for ( const Timer *t : _timers )
+      next = std::min( next, t->expires() );
+
+    // a all zero it_value would disarm the timer
+    next = std::max<uint64_t>( next, 1 );
+    spec.it_value.tv_sec  = static_cast<time_t>( next / 1000 );
+    spec.it_value.tv_nsec = static_cast<long>( ( next % 1000 ) * 1000000 );
+  }
+
+  if ( ::timerfd_settime( _timerFd, TFD_TIMER_ABSTIME, &spec, nullptr ) != 0 )
+    ERR << "Unable to arm the timerfd: " << strerror( errno ) << std::endl;
+}
+
+bool EpollEventDispatcher::dispatchTimers()
+{
+  bool dispatched = false;
+  // timers might be stopped or started from within the expired signal
+  const auto timers = _timers;
+  for ( Timer *t : timers ) {
+    if ( std::find( _timers.begin(), _timers.end(), t ) == _timers.end() )
+      continue;
+    if ( t->remaining() == 0 ) {
+      t->expire();
+      dispatched = true;
+    }
+  }
+  return dispatched;
+}
+
+void EpollEventDispatcher::dispatchFd( int fd, uint32_t events )
+{
+  auto entryIt = _fds.find( fd );
+  if ( entryIt == _fds.end() )
+    return;
+
+  // copy, the callbacks might add or remove watches
+  const auto watches = entryIt->second.watches;
+  for ( const Watch &w : watches ) {
+
+    //do not trigger watches that were removed in the meantime
+    entryIt = _fds.find( fd );
+    if ( entryIt == _fds.end() )
+      return;
+    const auto &curr = entryIt->second.watches;
+    auto currIt = std::find_if( curr.begin(), curr.end(), [ &w ]( const Watch &c ){ return c.src == w.src; } );
+    if ( currIt == curr.end() )
+      continue;
+
+    const int mode = currIt->mode;
+    int ev = 0;
+    if ( ( events & ( EPOLLIN | EPOLLHUP ) ) && ( mode & AbstractEventSource::Read ) )
+      ev = AbstractEventSource::Read;
+    if ( ( events & EPOLLOUT ) && ( mode & AbstractEventSource::Write ) )
+      ev = ev | AbstractEventSource::Write;
+    if ( ( events & EPOLLPRI ) && ( mode & AbstractEventSource::Exception ) )
+      ev = ev | AbstractEventSource::Exception;
+    if ( ( events & EPOLLERR ) && mode )
+      ev = ev | AbstractEventSource::Error;
+
+    if ( ev )
+      w.src->onFdReady( fd, ev );
+  }
+}
+
+bool EpollEventDispatcher::iterate( bool mayBlock )
+{
+  if ( !isValid() )
+    return false;
+
+  const bool haveIdleWork = ( _d._idleFuncs.size() || _d._unrefLater.size() );
+
+  armTimerFd();
+
+  epoll_event events[64];
+  int nfds = ::epoll_wait( _epollFd, events, sizeof(events) / sizeof(epoll_event), ( mayBlock && !haveIdleWork ) ? -1 : 0 );
+  if ( nfds < 0 ) {
+    if ( errno != EINTR )
+      ERR << "epoll_wait failed: " << strerror( errno ) << std::endl;
+    nfds = 0;
+  }
+
+  bool dispatched = false;
+  for ( int i = 0; i < nfds; ++i ) {
+    const int fd = events[i].data.fd;
+    if ( fd == _timerFd ) {
+      uint64_t expirations = 0;
+      while ( ::read( _timerFd, &expirations, sizeof( expirations ) ) > 0 )
+        ;
+    } else if ( fd == _wakeupFd ) {
+      eventfd_t dummy;
+      ::eventfd_read( _wakeupFd, &dummy );
+    } else {
+      dispatchFd( fd, events[i].events );
+      dispatched = true;
+    }
+  }
+
+  if ( dispatchTimers() )
+    dispatched = true;
+
+  if ( _d._idleFuncs.size() || _d._unrefLater.size() ) {
+    _d.runIdleTasks();
+    dispatched = true;
+  }
+
+  return dispatched;
+}
+
+void EpollEventDispatcher::run()
+{
+  _quit = false;
+  while ( !_quit && isValid() )
+    iterate( true );
+}
+
+void EpollEventDispatcher::quit()
+{
+  _quit = true;
+  // quit might be called from a different thread, make sure the loop wakes up
+  if ( _wakeupFd >= 0 )
+    ::eventfd_write( _wakeupFd, 1 );
+}
+
+}
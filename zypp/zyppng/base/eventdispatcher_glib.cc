@@ -4,6 +4,10 @@
 
 #include <zypp/base/Exception.h>
 #include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+
+#include <cstdlib>
+
 namespace zyppng {
 
 static int inline readMask () {
@@ -225,9 +229,40 @@ static gboolean  eventLoopIdleFunc ( gpointer user_data )
 }
 
 
-EventDispatcherPrivate::EventDispatcherPrivate ( GMainContext *ctx )
+/*!
+ * \brief Maps \a DefaultBackend to the backend requested in \c ZYPP_EVENTDISPATCHER
+ */
+static EventDispatcher::Backend resolveBackend ( EventDispatcher::Backend backend )
+{
+  if ( backend != EventDispatcher::DefaultBackend )
+    return backend;
+
+  const char *env = ::getenv( "ZYPP_EVENTDISPATCHER" );
+  if ( env ) {
+    std::string req( zypp::str::toLower( env ) );
+    if ( req == "epoll" )
+      return EventDispatcher::EpollBackend;
+    if ( req != "glib" )
+      WAR << "Unknown ZYPP_EVENTDISPATCHER value '" << env << "', using glib" << std::endl;
+  }
+  return EventDispatcher::GLibBackend;
+}
+
+EventDispatcherPrivate::EventDispatcherPrivate ( GMainContext *ctx, EventDispatcher::Backend backend )
 {
   _myThreadId = std::this_thread::get_id();
+  _backend = backend;
+
+  if ( _backend == EventDispatcher::EpollBackend ) {
+    _epoll.reset( new EpollEventDispatcher( *this ) );
+    if ( _epoll->isValid() ) {
+      MIL << "Using the epoll event dispatcher" << std::endl;
+      return;
+    }
+    WAR << "Falling back to the glib event dispatcher" << std::endl;
+    _epoll.reset();
+    _backend = EventDispatcher::GLibBackend;
+  }
 
   //if we get a context specified ( usually when created for main thread ) we use it
   //otherwise we create our own
@@ -252,6 +287,11 @@ EventDispatcherPrivate::EventDispatcherPrivate ( GMainContext *ctx )
 
 EventDispatcherPrivate::~EventDispatcherPrivate()
 {
+  if ( _epoll ) {
+    _epoll.reset();
+    return;
+  }
+
   std::for_each ( _runningTimers.begin(), _runningTimers.end(), []( GLibTimerSource *src ){
     GLibTimerSource::destruct( src );
   });
@@ -292,25 +332,47 @@ bool EventDispatcherPrivate::runIdleTasks()
 
 void EventDispatcherPrivate::enableIdleSource()
 {
+  //the native backend checks for idle work in each iteration
+  if ( _epoll )
+    return;
   if ( !_idleSource->context )
     g_source_attach ( _idleSource, _ctx );
 }
 
 
 EventDispatcher::EventDispatcher(void *ctx)
-  : Base ( * new EventDispatcherPrivate( reinterpret_cast<GMainContext*>(ctx) ) )
+  : EventDispatcher( DefaultBackend, ctx )
+{ }
+
+EventDispatcher::EventDispatcher( Backend backend, void *ctx )
+  : Base ( * new EventDispatcherPrivate( reinterpret_cast<GMainContext*>(ctx), resolveBackend( backend ) ) )
 {
   threadLocalDispatcher( this );
 }
 
 std::shared_ptr<EventDispatcher> EventDispatcher::createMain()
 {
-  return std::shared_ptr<EventDispatcher>( new EventDispatcher(g_main_context_default()) );
+  return createMain( DefaultBackend );
 }
 
 std::shared_ptr<EventDispatcher> EventDispatcher::createForThread()
 {
-  return std::shared_ptr<EventDispatcher>( new EventDispatcher() );
+  return createForThread( DefaultBackend );
+}
+
+std::shared_ptr<EventDispatcher> EventDispatcher::createMain( Backend backend )
+{
+  return std::shared_ptr<EventDispatcher>( new EventDispatcher( backend, g_main_context_default() ) );
+}
+
+std::shared_ptr<EventDispatcher> EventDispatcher::createForThread( Backend backend )
+{
+  return std::shared_ptr<EventDispatcher>( new EventDispatcher( backend, nullptr ) );
+}
+
+EventDispatcher::Backend EventDispatcher::backend() const
+{
+  return d_func()->_backend;
 }
 
 EventDispatcher::~EventDispatcher()
@@ -324,6 +386,11 @@ void EventDispatcher::updateEventSource( AbstractEventSource *notifier, int fd,
   if ( notifier->eventDispatcher().lock().get() != this )
     ZYPP_THROW( zypp::Exception("Invalid event dispatcher used to update event source") );
 
+  if ( d->_epoll ) {
+    d->_epoll->updateEventSource( notifier, fd, mode );
+    return;
+  }
+
   GAbstractEventSource *evSrc = nullptr;
   auto &evSrcList = d->_eventSources;
   auto itToEvSrc = std::find_if( evSrcList.begin(), evSrcList.end(), [ notifier ]( const auto elem ){ return elem->eventSource == notifier; } );
@@ -375,6 +442,11 @@ void EventDispatcher::removeEventSource( AbstractEventSource *notifier, int fd )
   if ( notifier->eventDispatcher().lock().get() != this )
     ZYPP_THROW( zypp::Exception("Invalid event dispatcher used to remove event source") );
 
+  if ( d->_epoll ) {
+    d->_epoll->removeEventSource( notifier, fd );
+    return;
+  }
+
   auto &evList = d->_eventSources;
   auto it = std::find_if( evList.begin(), evList.end(), [ notifier ]( const auto elem ){ return elem->eventSource == notifier; } );
 
@@ -408,6 +480,11 @@ void EventDispatcher::removeEventSource( AbstractEventSource *notifier, int fd )
 void EventDispatcher::registerTimer( Timer *timer )
 {
   Z_D();
+  if ( d->_epoll ) {
+    d->_epoll->registerTimer( timer );
+    return;
+  }
+
   //make sure timer is not double registered
   for ( const GLibTimerSource *t : d->_runningTimers ) {
     if ( t->_t == timer )
@@ -424,6 +501,11 @@ void EventDispatcher::registerTimer( Timer *timer )
 void EventDispatcher::removeTimer( Timer *timer )
 {
   Z_D();
+  if ( d->_epoll ) {
+    d->_epoll->removeTimer( timer );
+    return;
+  }
+
   auto it = std::find_if( d->_runningTimers.begin(), d->_runningTimers.end(), [ timer ]( const GLibTimerSource *src ){
     return src->_t == timer;
   });
@@ -437,17 +519,26 @@ void EventDispatcher::removeTimer( Timer *timer )
 
 bool EventDispatcher::run_once()
 {
-  return g_main_context_iteration( d_func()->_ctx, false );
+  Z_D();
+  if ( d->_epoll )
+    return d->_epoll->iterate( false );
+  return g_main_context_iteration( d->_ctx, false );
 }
 
 void EventDispatcher::run()
 {
-  g_main_loop_run( d_func()->_loop );
+  Z_D();
+  if ( d->_epoll )
+    return d->_epoll->run();
+  g_main_loop_run( d->_loop );
 }
 
 void EventDispatcher::quit()
 {
-  g_main_loop_quit( d_func()->_loop );
+  Z_D();
+  if ( d->_epoll )
+    return d->_epoll->quit();
+  g_main_loop_quit( d->_loop );
 }
 
 void EventDispatcher::invokeOnIdleImpl(EventDispatcher::IdleFunction &&callback)
@@ -466,7 +557,10 @@ void EventDispatcher::unrefLaterImpl(std::shared_ptr<void> &&ptr )
 
 ulong EventDispatcher::runningTimers() const
 {
-  return d_func()->_runningTimers.size();
+  Z_D();
+  if ( d->_epoll )
+    return d->_epoll->runningTimers();
+  return d->_runningTimers.size();
 }
 
 std::shared_ptr<EventDispatcher> EventDispatcher::instance()
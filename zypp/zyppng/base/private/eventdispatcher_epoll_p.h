@@ -0,0 +1,94 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+----------------------------------------------------------------------/
+*
+* This file contains private API, this might break at any time between releases.
+* You have been warned!
+*
+*/
+#ifndef ZYPP_BASE_EVENTDISPATCHER_EPOLL_P_DEFINED
+#define ZYPP_BASE_EVENTDISPATCHER_EPOLL_P_DEFINED
+
+#include <zypp/zyppng/base/eventdispatcher.h>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+namespace zyppng {
+
+class EventDispatcherPrivate;
+
+/*!
+ * \internal Native event loop backend based on epoll(7) and timerfd(2)
+ *
+ * All file descriptors live in one epoll set, the kernel keeps track of them so
+ * a iteration does not need to rebuild a poll array. Timers share a single timerfd
+ * that is armed to the next expiring \sa Timer before the loop goes to sleep.
+ *
+ * Idle functions and delayed unrefs are still kept in \sa EventDispatcherPrivate,
+ * the backend only makes sure they are executed once per iteration.
+ */
+class EpollEventDispatcher
+{
+public:
+  EpollEventDispatcher( EventDispatcherPrivate &d );
+  ~EpollEventDispatcher();
+
+  EpollEventDispatcher( const EpollEventDispatcher & ) = delete;
+  EpollEventDispatcher &operator= ( const EpollEventDispatcher & ) = delete;
+
+  /*!
+   * Returns true if all kernel objects could be created
+   */
+  bool isValid () const;
+
+  void updateEventSource ( AbstractEventSource *notifier, int fd, int mode );
+  void removeEventSource ( AbstractEventSource *notifier, int fd );
+
+  void registerTimer ( Timer *timer );
+  void removeTimer   ( Timer *timer );
+  ulong runningTimers () const;
+
+  /*!
+   * Runs one iteration of the event loop, if \a mayBlock is true and there is no pending
+   * idle work the function waits until a fd becomes ready or a timer expires.
+   * Returns true if any event was dispatched.
+   */
+  bool iterate ( bool mayBlock );
+  void run  ();
+  void quit ();
+
+private:
+  struct Watch {
+    AbstractEventSource *src = nullptr;
+    int mode = 0;
+  };
+
+  struct FdEntry {
+    uint32_t events = 0;
+    std::vector<Watch> watches;
+  };
+
+  void syncFd ( int fd, FdEntry &entry );
+  void dispatchFd ( int fd, uint32_t events );
+  bool dispatchTimers ();
+  void armTimerFd ();
+
+  EventDispatcherPrivate &_d;
+  int _epollFd  = -1;
+  int _timerFd  = -1;
+  int _wakeupFd = -1;
+  std::atomic_bool _quit { false };
+
+  std::unordered_map<int, FdEntry> _fds;
+  std::vector<Timer *> _timers;
+};
+
+}
+
+#endif
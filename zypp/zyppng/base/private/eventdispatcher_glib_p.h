@@ -2,8 +2,10 @@
 #define ZYPP_BASE_EVENTDISPATCHER_GLIB_P_DEFINED
 
 #include "base_p.h"
+#include "eventdispatcher_epoll_p.h"
 #include <zypp/zyppng/base/eventdispatcher.h>
 #include <glib.h>
+#include <memory>
 #include <thread>
 #include <unordered_map>
 #include <queue>
@@ -61,13 +63,18 @@ class EventDispatcherPrivate : public BasePrivate
 {
 public:
   ZYPP_DECLARE_PUBLIC(EventDispatcher)
-  EventDispatcherPrivate( GMainContext *ctx );
+  EventDispatcherPrivate( GMainContext *ctx, EventDispatcher::Backend backend = EventDispatcher::GLibBackend );
   virtual ~EventDispatcherPrivate();
 
   bool runIdleTasks();
   void enableIdleSource ();
 
   std::thread::id _myThreadId;
+  EventDispatcher::Backend _backend = EventDispatcher::GLibBackend;
+
+  //only set if the native backend is used, all GLib members are unused in that case
+  std::unique_ptr<EpollEventDispatcher> _epoll;
+
   GMainLoop *_loop = nullptr;
   GMainContext *_ctx = nullptr;
 